@@ -0,0 +1,704 @@
+#include <benchmark/benchmark.h>
+#include "BatchRunner.hpp"
+#include "Campus.hpp"
+#include "CommandParser.hpp"
+#include "EventQueue.hpp"
+#include "FixedTower.hpp"
+#include "LockFreeQueue.hpp"
+#include "Scheduler.hpp"
+#include "Sweep.hpp"
+#include "Traffic.hpp"
+#include "Simulation.hpp"
+#include <random>
+#include <type_traits>
+#include <sstream>
+
+// ============== Microbenchmarks ==============
+// Hot paths of the tick loop. Run `elevator_bench --benchmark_format=json`
+// (or the bench_json target) to record results for regression tracking.
+
+namespace {
+
+Config benchConfig(int floors, int cars, ControllerType type = ControllerType::Master) {
+    Config config;
+    config.numFloors = floors;
+    config.numElevators = cars;
+    config.controllerType = type;
+    config.headless = true;
+    config.loggingEnabled = false;
+    return config;
+}
+
+// Spread cars over the shaft in mixed states so costs are not all equal
+void scatterFleet(Building& building, std::mt19937& gen) {
+    std::uniform_int_distribution<> floorDist(1, building.getNumFloors());
+    for (int i = 0; i < building.getNumElevators(); ++i) {
+        Elevator& elev = building.getElevator(i);
+        elev.arriveAtFloor(floorDist(gen));
+        switch (i % 3) {
+            case 0: elev.setIdle(); break;
+            case 1: elev.startMoving(Direction::Up, 2); break;
+            case 2: elev.startMoving(Direction::Down, 2); break;
+        }
+    }
+}
+
+}  // namespace
+
+// ============== Event Queue ==============
+
+template<typename Queue>
+void BM_QueuePushPop(benchmark::State& state) {
+    static Queue queue;  // Shared by all benchmark threads
+    Event event;
+    event.type = EventType::HallCall;
+    event.floor = state.thread_index() + 1;
+
+    for (auto _ : state) {
+        queue.push(event);
+        benchmark::DoNotOptimize(queue.tryPop());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_QueuePushPop, LockingEventQueue<Event>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueuePushPop, LockFreeEventQueue<Event>)->ThreadRange(1, 8)->UseRealTime();
+
+template<typename Queue>
+void BM_QueueDrain(benchmark::State& state) {
+    Queue queue;
+    std::vector<Event> out;
+    out.reserve(state.range(0));
+    Event event;
+    event.type = EventType::CarCall;
+
+    for (auto _ : state) {
+        for (int i = 0; i < state.range(0); ++i) {
+            queue.push(event);
+        }
+        out.clear();
+        benchmark::DoNotOptimize(queue.drain(out));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_QueueDrain, LockingEventQueue<Event>)->Arg(16)->Arg(256);
+BENCHMARK_TEMPLATE(BM_QueueDrain, LockFreeEventQueue<Event>)->Arg(16)->Arg(256);
+
+// ============== Scheduling ==============
+
+// cost:0 is the CostIndex bucket lookup, cost:1 the EtaTable scan over
+// every car (rows are cached: the fleet does not move between calls)
+static void BM_SelectElevator(benchmark::State& state) {
+    Config config = benchConfig(80, static_cast<int>(state.range(0)));
+    config.costModel = static_cast<CostModel>(state.range(1));
+    Building building(config);
+    EventQueue<Event> queue;
+    MasterController controller(building, queue);
+
+    std::mt19937 gen(1);
+    scatterFleet(building, gen);
+    std::uniform_int_distribution<> floorDist(2, config.numFloors - 1);
+
+    for (auto _ : state) {
+        int floor = floorDist(gen);
+        Direction dir = (floor & 1) ? Direction::Up : Direction::Down;
+        benchmark::DoNotOptimize(controller.selectElevator(floor, dir));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SelectElevator)
+    ->ArgNames({"cars", "cost"})
+    ->ArgsProduct({{3, 12, 24, 48},
+                   {static_cast<int>(CostModel::Distance), static_cast<int>(CostModel::Eta)}});
+
+// Up-peak burst: 64 hall calls one at a time (arg 0) or as one batch (arg 1)
+static void BM_HallCallBurst(benchmark::State& state) {
+    Config config = benchConfig(80, 24);
+    bool batched = state.range(0) != 0;
+
+    std::mt19937 gen(4);
+    std::uniform_int_distribution<> floorDist(2, config.numFloors - 1);
+    std::vector<std::pair<int, Direction>> calls(64);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        Building building(config);
+        EventQueue<Event> queue;
+        MasterController controller(building, queue);
+        scatterFleet(building, gen);
+        for (auto& call : calls) {
+            call.first = floorDist(gen);
+            call.second = (call.first & 1) ? Direction::Up : Direction::Down;
+        }
+        state.ResumeTiming();
+
+        if (batched) {
+            controller.handleHallCalls(calls);
+        } else {
+            for (const auto& [floor, dir] : calls) {
+                controller.handleHallCall(floor, dir);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(calls.size()));
+}
+BENCHMARK(BM_HallCallBurst)->ArgName("batched")->Arg(0)->Arg(1);
+
+// One global re-optimisation pass: every outstanding call x every car
+static void BM_ReassignCalls(benchmark::State& state) {
+    int cars = static_cast<int>(state.range(0));
+    int calls = static_cast<int>(state.range(1));
+    Config config = benchConfig(calls / 2 + 10, cars);
+    Building building(config);
+    EventQueue<Event> queue;
+    MasterController controller(building, queue);
+
+    std::mt19937 gen(6);
+    scatterFleet(building, gen);
+    for (int i = 0; i < calls; ++i) {
+        controller.handleHallCall(2 + i / 2, (i & 1) ? Direction::Down : Direction::Up);
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(controller.reassignCalls());
+    }
+    state.counters["moved"] = static_cast<double>(controller.getReassignments());
+}
+BENCHMARK(BM_ReassignCalls)
+    ->ArgNames({"cars", "calls"})
+    ->Args({12, 64})->Args({48, 128})->Args({48, 300})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_TryClaimCalls(benchmark::State& state) {
+    Config config = benchConfig(80, static_cast<int>(state.range(0)),
+                                ControllerType::Distributed);
+    Building building(config);
+    EventQueue<Event> queue;
+    DistributedController controller(building, queue);
+
+    std::mt19937 gen(2);
+    scatterFleet(building, gen);
+    std::uniform_int_distribution<> floorDist(2, config.numFloors - 1);
+
+    // Keep the board populated: one open call per car
+    for (int i = 0; i < config.numElevators; ++i) {
+        controller.handleHallCall(floorDist(gen), Direction::Up);
+    }
+
+    int car = 0;
+    for (auto _ : state) {
+        // Post, claim, release: the full per-car claim cycle
+        int floor = floorDist(gen);
+        Direction dir = (floor & 1) ? Direction::Up : Direction::Down;
+        controller.handleHallCall(floor, dir);
+        building.getElevator(car).setIdle();
+        controller.tryClaimCalls(car);
+
+        for (int claimed : controller.getClaimedFloors(car)) {
+            controller.releaseClaim(claimed, Direction::Up);
+            controller.releaseClaim(claimed, Direction::Down);
+            controller.handleHallCall(floorDist(gen), Direction::Down);
+        }
+        car = (car + 1) % config.numElevators;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TryClaimCalls)->Arg(3)->Arg(12)->Arg(24)->Arg(48);
+
+// Claim-board contention: each benchmark thread is one car running its
+// claim cycle (post, claim the nearest open call, serve and release it)
+// on one shared board. Claims are a CAS per call slot with no shared
+// lock, so throughput should grow with threads until cars collide on the
+// same calls.
+static void BM_ClaimBoardThreads(benchmark::State& state) {
+    static Config config = benchConfig(80, 8, ControllerType::Distributed);
+    static Building building(config);
+    static EventQueue<Event> queue;
+    static DistributedController controller(building, queue);
+    static const bool spread = [] {
+        // Idle cars spread over the shaft, each nearest to its own calls
+        for (int i = 0; i < config.numElevators; ++i) {
+            building.getElevator(i).arriveAtFloor(1 + i * config.numFloors / config.numElevators);
+            building.getElevator(i).setIdle();
+        }
+        return true;
+    }();
+    (void)spread;
+
+    int car = state.thread_index();
+    std::mt19937 gen(static_cast<unsigned>(car) + 1);
+    std::uniform_int_distribution<> floorDist(2, config.numFloors - 1);
+
+    for (auto _ : state) {
+        int floor = floorDist(gen);
+        controller.postCall(floor, (floor & 1) ? Direction::Up : Direction::Down);
+        controller.tryClaimCalls(car);
+        for (int claimed : controller.getClaimedFloors(car)) {
+            for (Direction dir : {Direction::Up, Direction::Down}) {
+                if (controller.hasClaim(car, claimed, dir)) {
+                    controller.releaseClaim(claimed, dir);
+                }
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ClaimBoardThreads)->ThreadRange(1, 8)->UseRealTime();
+
+// Status readers against the tick loop: thread 0 publishes a snapshot per
+// iteration, the rest read one into a reused buffer. Reads are a seqlock
+// retry loop with no lock, so the publisher never waits on a reader.
+static void BM_SnapshotReaders(benchmark::State& state) {
+    static Config config = benchConfig(40, 16);
+    static Building building(config);
+
+    FleetSnapshot out;
+    for (auto _ : state) {
+        if (state.thread_index() == 0) {
+            building.publishSnapshot(static_cast<int>(state.iterations()));
+        } else {
+            building.readSnapshot(out);
+            benchmark::DoNotOptimize(out.tick);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SnapshotReaders)->ThreadRange(1, 8)->UseRealTime();
+
+// Per-tick publish cost with and without the shared-memory export (arg 1):
+// the export is a second seqlock copy into mapped memory, no syscall
+static void BM_SharedStateExport(benchmark::State& state) {
+    Config config = benchConfig(40, 16);
+    if (state.range(0)) {
+        config.sharedStateName = "/elevator_bench_export";
+    }
+    Building building(config);
+    int tick = 0;
+    for (auto _ : state) {
+        building.publishSnapshot(++tick);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SharedStateExport)->ArgName("shm")->Arg(0)->Arg(1);
+
+static void BM_CostToServe(benchmark::State& state) {
+    Elevator elev(0, 6, 40);
+    elev.startMoving(Direction::Up, 2);
+    int floor = 1;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(elev.costToServe(floor, Direction::Up, 80));
+        floor = floor == 80 ? 1 : floor + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CostToServe);
+
+// ============== Traffic Generation ==============
+// Raw generator speed: 64 arrivals per tick into a reused request buffer,
+// lunch mix, flat rate (arg 0) or a thinned daily curve (arg 1).
+
+static void BM_TrafficGenerate(benchmark::State& state) {
+    TrafficConfig traffic;
+    traffic.profile = TrafficProfile::Lunch;
+    traffic.callsPerTick = 64.0;
+    if (state.range(0)) {
+        traffic.rateCurve = {{0, 0.2}, {2000, 1.0}, {4000, 0.3}, {6000, 0.8}, {8000, 0.2}};
+    }
+    TrafficGenerator generator(traffic, 60);
+    std::vector<Request> requests;
+    int tick = 0;
+    int64_t produced = 0;
+
+    for (auto _ : state) {
+        requests.clear();
+        produced += static_cast<int64_t>(generator.generate(tick, requests));
+        benchmark::DoNotOptimize(requests.data());
+        if (++tick == 8000) {  // Start the curve over
+            tick = 0;
+            generator = TrafficGenerator(traffic, 60);
+        }
+    }
+    state.SetItemsProcessed(produced);
+}
+BENCHMARK(BM_TrafficGenerate)->ArgName("curve")->Arg(0)->Arg(1);
+
+// ============== Fleet Sizing Sweep ==============
+// One 2-12 car x 3 capacity up-peak sweep per iteration: every point in
+// full (mode 0), with the SLA cut-off (1), and bisecting for the fewest
+// cars (2). `runs` counts the engine runs actually made.
+
+static void BM_Sweep(benchmark::State& state) {
+    int mode = static_cast<int>(state.range(0));
+    SweepConfig sweep;
+    sweep.base.numFloors = 30;
+    sweep.numElevators = parseIntList("2-12");
+    sweep.carCapacity = {6, 8, 10};
+    sweep.runs = 8;
+    sweep.ticksPerRun = 1000;
+    sweep.traffic.profile = TrafficProfile::UpPeak;
+    sweep.traffic.callsPerTick = 0.2;
+    sweep.slaTicks = mode > 0 ? 75 : 0;
+    sweep.search = mode == 2 ? SweepSearch::MinCars : SweepSearch::Grid;
+    sweep.threads = 1;
+
+    SweepResult result;
+    for (auto _ : state) {
+        result = SweepRunner(sweep).run();
+    }
+    state.counters["points"] = static_cast<double>(result.points.size());
+    state.counters["runs"] = static_cast<double>(result.runs);
+}
+BENCHMARK(BM_Sweep)->ArgName("mode")->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMillisecond);
+
+// ============== Warm Start ==============
+
+// Getting a variant to the start of the peak: simulate a 3000-tick warm-up
+// (arg 0) or restore its snapshot (arg 1)
+static void BM_WarmStart(benchmark::State& state) {
+    Config config = benchConfig(40, 8);
+    bool restore = state.range(0) != 0;
+
+    auto warmUp = [&config](SimulationEngine& engine) {
+        std::mt19937 gen(8);
+        std::poisson_distribution<> arrivals(0.4);
+        std::uniform_int_distribution<> floorDist(1, config.numFloors);
+        for (int t = 0; t < 3000; ++t) {
+            for (int n = arrivals(gen); n > 0; --n) {
+                int origin = floorDist(gen);
+                int dest = floorDist(gen);
+                if (origin != dest) {
+                    engine.requestPassenger(origin, dest);
+                }
+            }
+            engine.runTicks(1);
+        }
+    };
+    SimulationEngine warm(config);
+    warmUp(warm);
+    SimulationSnapshot snapshot = warm.saveSnapshot();
+
+    for (auto _ : state) {
+        if (restore) {
+            SimulationEngine engine(snapshot);
+            benchmark::DoNotOptimize(engine.getCurrentTick());
+        } else {
+            SimulationEngine engine(config);
+            warmUp(engine);
+            benchmark::DoNotOptimize(engine.getCurrentTick());
+        }
+    }
+    state.counters["snapshot_bytes"] = static_cast<double>(snapshot.bytes.size());
+}
+BENCHMARK(BM_WarmStart)->ArgName("restore")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+// ============== Request Ingestion ==============
+
+// A 1024-call burst submitted one call at a time (arg 0) or as one batch
+// (arg 1); the queue is drained untimed between iterations
+static void BM_RequestBurst(benchmark::State& state) {
+    SimulationEngine engine(benchConfig(80, 24));
+    bool batched = state.range(0) != 0;
+
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<> floorDist(2, 79);
+    std::uniform_int_distribution<> carDist(0, 23);
+    std::vector<Request> burst;
+    for (int i = 0; i < 1024; ++i) {
+        burst.push_back((i & 1) ? Request::carCall(carDist(gen), floorDist(gen))
+                                : Request::passenger(floorDist(gen), floorDist(gen)));
+    }
+
+    for (auto _ : state) {
+        if (batched) {
+            engine.requestBatch(burst);
+        } else {
+            for (const Request& r : burst) {
+                if (r.type == EventType::CarCall) {
+                    engine.requestCarCall(r.elevatorId, r.floor);
+                } else {
+                    engine.requestPassenger(r.floor, r.destination);
+                }
+            }
+        }
+        state.PauseTiming();
+        engine.runTicks(1);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(burst.size()));
+}
+BENCHMARK(BM_RequestBurst)->ArgName("batched")->Arg(0)->Arg(1);
+
+// CLI line parsing: the allocation-free parser against the istringstream
+// parse it replaced
+static void BM_ParseCommand(benchmark::State& state) {
+    const std::string lines[] = {"hall 12 u", "car 3 40", "pass 1 27", "dest 1 63"};
+    bool streams = state.range(0) != 0;
+    size_t i = 0;
+
+    for (auto _ : state) {
+        const std::string& line = lines[i++ & 3];
+        if (streams) {
+            std::istringstream iss(line);
+            std::string cmd;
+            int a = 0;
+            int b = 0;
+            iss >> cmd >> a >> b;
+            benchmark::DoNotOptimize(a + b);
+        } else {
+            benchmark::DoNotOptimize(parseCommand(line));
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParseCommand)->ArgName("istringstream")->Arg(0)->Arg(1);
+
+// ============== Tick Loop ==============
+
+static void BM_ProcessTick(benchmark::State& state) {
+    int floors = static_cast<int>(state.range(0));
+    int cars = static_cast<int>(state.range(1));
+    auto type = static_cast<ControllerType>(state.range(2));
+    SimulationEngine engine(benchConfig(floors, cars, type));
+
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<> floorDist(2, floors - 1);
+    std::uniform_int_distribution<> carDist(0, cars - 1);
+    std::poisson_distribution<> callsPerTick(cars / 25.0);
+
+    for (auto _ : state) {
+        int calls = callsPerTick(gen);
+        for (int c = 0; c < calls; ++c) {
+            int floor = floorDist(gen);
+            if (c & 1) {
+                engine.requestCarCall(carDist(gen), floor);
+            } else {
+                engine.requestHallCall(floor, (floor & 1) ? Direction::Up : Direction::Down);
+            }
+        }
+        engine.runTicks(1);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["events"] = benchmark::Counter(
+        static_cast<double>(engine.getEventsProcessed()), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_ProcessTick)
+    ->ArgNames({"floors", "cars", "controller"})
+    ->ArgsProduct({{12, 80, 150}, {3, 24, 48},
+                   {static_cast<int>(ControllerType::Master),
+                    static_cast<int>(ControllerType::Distributed)}});
+
+// BM_ProcessTick's master load on the compile-time shaped engine
+// (fixed:1) and on SimulationEngine with the same Config (fixed:0)
+template <int Floors, int Cars, bool Fixed>
+static void BM_FixedTower(benchmark::State& state) {
+    Config config = benchConfig(Floors, Cars, ControllerType::Master);
+    std::conditional_t<Fixed, FixedEngine<Floors, Cars>, SimulationEngine> engine(config);
+
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<> floorDist(2, Floors - 1);
+    std::uniform_int_distribution<> carDist(0, Cars - 1);
+    std::poisson_distribution<> callsPerTick(Cars / 25.0);
+
+    for (auto _ : state) {
+        int calls = callsPerTick(gen);
+        for (int c = 0; c < calls; ++c) {
+            int floor = floorDist(gen);
+            if (c & 1) {
+                engine.requestCarCall(carDist(gen), floor);
+            } else {
+                engine.requestHallCall(floor, (floor & 1) ? Direction::Up : Direction::Down);
+            }
+        }
+        engine.runTicks(1);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["events"] = benchmark::Counter(
+        static_cast<double>(engine.getEventsProcessed()), benchmark::Counter::kIsRate);
+}
+BENCHMARK_TEMPLATE(BM_FixedTower, 12, 3, false);
+BENCHMARK_TEMPLATE(BM_FixedTower, 12, 3, true);
+BENCHMARK_TEMPLATE(BM_FixedTower, 80, 24, false);
+BENCHMARK_TEMPLATE(BM_FixedTower, 80, 24, true);
+BENCHMARK_TEMPLATE(BM_FixedTower, 150, 48, false);
+BENCHMARK_TEMPLATE(BM_FixedTower, 150, 48, true);
+
+// Distributed fleet with its per-car logic on a worker pool (workers:0 is
+// the serial loop). Each tick costs four pool barriers, so this pays off
+// only once cars * per-car work outweighs them - large fleets, many cores.
+static void BM_CarWorkers(benchmark::State& state) {
+    Config config = benchConfig(150, 48, ControllerType::Distributed);
+    config.dispatchPolicy = DispatchPolicy::Collective;
+    config.carWorkers = static_cast<int>(state.range(0));
+    SimulationEngine engine(config);
+
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<> floorDist(1, config.numFloors);
+    std::poisson_distribution<> arrivals(2.0);
+
+    for (auto _ : state) {
+        for (int n = arrivals(gen); n > 0; --n) {
+            int origin = floorDist(gen);
+            int dest = floorDist(gen);
+            if (origin != dest) {
+                engine.requestPassenger(origin, dest);
+            }
+        }
+        engine.runTicks(1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CarWorkers)->ArgName("workers")->Arg(0)->Arg(1)->Arg(2)->Arg(4)->Arg(8)
+    ->UseRealTime();
+
+// Campus shards in lockstep: 8 towers, a quarter of trips changing tower,
+// ticked on 1-8 threads with a barrier per tick. Shards share nothing
+// while they run, so ticks/s should follow the core count.
+static void BM_CampusShards(benchmark::State& state) {
+    CampusConfig campus;
+    for (int i = 0; i < 8; ++i) {
+        ShardConfig shard;
+        shard.config = benchConfig(40, 8);
+        shard.callsPerTick = 0.6;
+        campus.shards.push_back(shard);
+    }
+    campus.transferShare = 0.25;
+    campus.threads = static_cast<int>(state.range(0));
+    CampusSimulator simulator(campus);
+    simulator.runTicks(200);  // Warm up: cars spread, queues non-empty
+
+    for (auto _ : state) {
+        simulator.runTicks(100);
+    }
+    state.SetItemsProcessed(state.iterations() * 100);
+}
+BENCHMARK(BM_CampusShards)->ArgName("threads")->Arg(1)->Arg(2)->Arg(4)->Arg(8)
+    ->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+// Overnight traffic: one passenger every ~500 ticks for 48 cars, run in
+// 10000-tick chunks. FixedTick visits every car every tick; NextEvent
+// jumps over the quiet stretches. ticks/s is simulated ticks per second.
+static void BM_SparseTraffic(benchmark::State& state) {
+    Config config = benchConfig(80, 48, static_cast<ControllerType>(state.range(0)));
+    config.timeAdvance = static_cast<TimeAdvance>(state.range(1));
+    SimulationEngine engine(config);
+
+    std::mt19937 gen(9);
+    std::uniform_int_distribution<> floorDist(1, config.numFloors);
+    const int chunk = 10000;
+
+    for (auto _ : state) {
+        for (int n = 0; n < chunk / 500; ++n) {
+            int origin = floorDist(gen);
+            int dest = floorDist(gen);
+            if (origin != dest) {
+                engine.requestPassenger(origin, dest);
+            }
+            engine.runTicks(500);
+        }
+    }
+    state.counters["ticks/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * chunk, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_SparseTraffic)
+    ->ArgNames({"controller", "advance"})
+    ->ArgsProduct({{static_cast<int>(ControllerType::Master),
+                    static_cast<int>(ControllerType::Distributed)},
+                   {static_cast<int>(TimeAdvance::FixedTick),
+                    static_cast<int>(TimeAdvance::NextEvent)}})
+    ->Unit(benchmark::kMicrosecond);
+
+// ============== Dispatch Policy ==============
+// One seeded passenger run per iteration (same seed every time), so the
+// counters compare service quality, not just speed: mean passenger wait and
+// car-floors traveled per run, by dispatch policy and cost model.
+
+static void BM_DispatchPolicy(benchmark::State& state) {
+    Config config = benchConfig(static_cast<int>(state.range(0)), 4,
+                                static_cast<ControllerType>(state.range(1)));
+    config.dispatchPolicy = static_cast<DispatchPolicy>(state.range(2));
+    config.costModel = static_cast<CostModel>(state.range(3));
+
+    BatchResult result;
+    for (auto _ : state) {
+        result = BatchResult();
+        BatchRunner::runOne(config, 1000, 0.15, 11, result);
+    }
+    state.counters["avg_wait"] = result.passengers.waitTicks.mean();
+    state.counters["floors_traveled"] = static_cast<double>(result.metrics.floorsTraveled);
+}
+BENCHMARK(BM_DispatchPolicy)
+    ->ArgNames({"floors", "controller", "policy", "cost"})
+    ->ArgsProduct({{20, 60},
+                   {static_cast<int>(ControllerType::Master),
+                    static_cast<int>(ControllerType::Distributed)},
+                   {static_cast<int>(DispatchPolicy::NearestFirst),
+                    static_cast<int>(DispatchPolicy::Collective)},
+                   {static_cast<int>(CostModel::Distance), static_cast<int>(CostModel::Eta)}})
+    ->Unit(benchmark::kMillisecond);
+
+// ============== Motion Model ==============
+// Tick throughput under the same uniform load with fixed floor timing
+// (arg 0) and the jerk-limited kinematic model with per-trip energy (1).
+// The profile is precomputed into tick tables, so a moving car still
+// costs one decrement per tick; kwh is the energy drawn per iteration.
+
+static void BM_MotionModel(benchmark::State& state) {
+    Config config = benchConfig(40, 16);
+    config.motionModel = static_cast<MotionModel>(state.range(0));
+    TrafficConfig traffic;
+    traffic.callsPerTick = 0.5;
+    traffic.seed = 5;
+    const int ticks = 5000;
+
+    double drawn = 0.0;
+    for (auto _ : state) {
+        SimulationEngine engine(config);
+        TrafficGenerator generator(traffic, config.numFloors);
+        generator.drive(engine, ticks);
+        drawn = engine.getBuilding().getMetrics().energyDrawn;
+    }
+    state.SetItemsProcessed(state.iterations() * ticks);
+    state.counters["kwh"] = drawn / 3.6e6;
+}
+BENCHMARK(BM_MotionModel)->ArgName("kinematic")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// ============== Up-Peak Handling Capacity ==============
+// Saturated morning up-peak: everyone arrives at the lobby for a random
+// upper floor. pax_per_5min is the standard handling-capacity figure,
+// passengers delivered per five minutes of simulated time. tuned:1 runs
+// the master with collective dispatch and reassignment every 5 ticks.
+
+static void BM_UpPeakThroughput(benchmark::State& state) {
+    Config config = benchConfig(20, 4, static_cast<ControllerType>(state.range(0)));
+    config.carCapacity = 10;
+    if (state.range(1)) {
+        config.dispatchPolicy = DispatchPolicy::Collective;
+        config.reassignPeriod = 5;
+    }
+    const int ticks = 3000;
+
+    long long delivered = 0;
+    for (auto _ : state) {
+        SimulationEngine engine(config);
+        std::mt19937 gen(12);
+        std::poisson_distribution<> arrivals(0.5);
+        std::uniform_int_distribution<> destDist(2, config.numFloors);
+        for (int t = 0; t < ticks; ++t) {
+            for (int n = arrivals(gen); n > 0; --n) {
+                engine.requestPassenger(1, destDist(gen));
+            }
+            engine.runTicks(1);
+        }
+        delivered = engine.getPassengerMetrics().delivered.load();
+    }
+    double ticksPer5Min = 300000.0 / config.tickDurationMs;
+    state.counters["pax_per_5min"] = static_cast<double>(delivered) * ticksPer5Min / ticks;
+}
+BENCHMARK(BM_UpPeakThroughput)
+    ->ArgNames({"controller", "tuned"})
+    ->Args({static_cast<int>(ControllerType::Master), 0})
+    ->Args({static_cast<int>(ControllerType::Master), 1})
+    ->Args({static_cast<int>(ControllerType::Destination), 0})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
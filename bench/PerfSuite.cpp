@@ -0,0 +1,431 @@
+#include "Simulation.hpp"
+#include "Traffic.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// ============== Performance Regression Suite ==============
+// The StressTests scenarios replayed as deterministic virtual-time runs:
+// seeded passenger traffic instead of sleeps and racing threads, so every
+// metric but the two rates is a pure function of the code. Each scenario
+// records ticks/sec, events/sec, heap allocations, peak live heap and
+// passenger wait percentiles; --check compares them with a baseline file
+// and exits non-zero on any regression past the tolerance.
+
+// ============== Allocation Counting ==============
+// Global operator new/delete for this binary only. Counters are relaxed
+// atomics; live bytes come from malloc_usable_size, so sized and unsized
+// deletes agree. Without glibc only the allocation count is kept.
+
+namespace {
+
+std::atomic<long long> gAllocations{0};
+std::atomic<long long> gLiveBytes{0};
+std::atomic<long long> gPeakBytes{0};
+
+std::size_t usableSize(void* ptr) {
+#if defined(__GLIBC__)
+    return malloc_usable_size(ptr);
+#else
+    (void)ptr;
+    return 0;
+#endif
+}
+
+void* countedAlloc(std::size_t size, std::size_t align) {
+    if (size == 0) size = 1;
+    void* ptr = align > alignof(std::max_align_t)
+        ? std::aligned_alloc(align, (size + align - 1) / align * align)
+        : std::malloc(size);
+    if (!ptr) throw std::bad_alloc();
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    long long live = gLiveBytes.fetch_add(static_cast<long long>(usableSize(ptr)),
+                                          std::memory_order_relaxed) +
+                     static_cast<long long>(usableSize(ptr));
+    long long peak = gPeakBytes.load(std::memory_order_relaxed);
+    while (live > peak &&
+           !gPeakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+    return ptr;
+}
+
+void countedFree(void* ptr) {
+    if (!ptr) return;
+    gLiveBytes.fetch_sub(static_cast<long long>(usableSize(ptr)), std::memory_order_relaxed);
+    std::free(ptr);
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) { return countedAlloc(size, 0); }
+void* operator new[](std::size_t size) { return countedAlloc(size, 0); }
+void* operator new(std::size_t size, std::align_val_t align) {
+    return countedAlloc(size, static_cast<std::size_t>(align));
+}
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return countedAlloc(size, static_cast<std::size_t>(align));
+}
+void operator delete(void* ptr) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr) noexcept { countedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { countedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { countedFree(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { countedFree(ptr); }
+
+namespace {
+
+#if defined(__OPTIMIZE__)
+constexpr int kOptimized = 1;
+#else
+constexpr int kOptimized = 0;
+#endif
+
+constexpr int kTimingRuns = 5;       // Rates are the best of this many runs
+constexpr int kDrainChunk = 100;      // Ticks per drain step
+constexpr int kMaxDrainTicks = 5000;  // Then whoever is left counts as unserved
+
+// ============== Scenarios ==============
+
+struct Scenario {
+    std::string name;
+    int floors;
+    int cars;
+    ControllerType controller;
+    TrafficProfile profile;
+    double callsPerTick;  // Summed over all streams
+    int ticks;            // At scale 1
+    int streams;          // Independent seeded sources merged per tick
+};
+
+// The StressTests shapes: HighTraffic* at 12 floors x 3 cars, the rest at
+// 10 x 3. ConcurrentRequests' four submitting threads become four seeded
+// streams merged into one requestBatch per tick, which keeps the burst
+// shape without making the outcome depend on thread timing.
+const std::vector<Scenario>& scenarios() {
+    static const std::vector<Scenario> all = {
+        {"high_traffic_master", 12, 3, ControllerType::Master,
+         TrafficProfile::Uniform, 0.15, 400000, 1},
+        {"high_traffic_distributed", 12, 3, ControllerType::Distributed,
+         TrafficProfile::Uniform, 0.15, 400000, 1},
+        {"concurrent_requests", 10, 3, ControllerType::Master,
+         TrafficProfile::Interfloor, 0.12, 400000, 4},
+        {"endurance", 10, 3, ControllerType::Master,
+         TrafficProfile::Lunch, 0.06, 2000000, 1},
+    };
+    return all;
+}
+
+using Metrics = std::map<std::string, double>;
+
+Metrics runScenario(const Scenario& scenario, double scale) {
+    Config config;
+    config.numFloors = scenario.floors;
+    config.numElevators = scenario.cars;
+    config.controllerType = scenario.controller;
+    config.headless = true;
+    config.loggingEnabled = false;
+
+    std::vector<TrafficGenerator> streams;
+    for (int s = 0; s < scenario.streams; ++s) {
+        TrafficConfig traffic;
+        traffic.profile = scenario.profile;
+        traffic.callsPerTick = scenario.callsPerTick / scenario.streams;
+        traffic.seed = static_cast<std::uint32_t>(1 + s);
+        streams.emplace_back(traffic, scenario.floors);
+    }
+    const int ticks = std::max(1, static_cast<int>(std::lround(scenario.ticks * scale)));
+
+    long long heapBefore = gLiveBytes.load(std::memory_order_relaxed);
+    gPeakBytes.store(heapBefore, std::memory_order_relaxed);
+    SimulationEngine engine(config);
+
+    long long allocsBefore = gAllocations.load(std::memory_order_relaxed);
+    RunStats total;
+    auto add = [&total](const RunStats& step) {
+        total.ticks += step.ticks;
+        total.eventsProcessed += step.eventsProcessed;
+    };
+    auto start = std::chrono::steady_clock::now();
+    if (streams.size() == 1) {
+        add(streams[0].drive(engine, ticks));
+    } else {
+        std::vector<Request> burst;
+        for (int t = 0; t < ticks; ++t) {
+            burst.clear();
+            int now = engine.getCurrentTick();
+            for (auto& stream : streams) {
+                stream.generate(now, burst);
+            }
+            if (!burst.empty()) {
+                engine.requestBatch(burst);
+            }
+            add(engine.runTicks(1));
+        }
+    }
+    // Drain: no new arrivals, run until every rider is delivered
+    const PassengerMetrics& riders = engine.getPassengerMetrics();
+    for (int drained = 0; drained < kMaxDrainTicks &&
+                          riders.waiting.load() + riders.riding.load() > 0;
+         drained += kDrainChunk) {
+        add(engine.runTicks(kDrainChunk));
+    }
+    total.elapsedSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    Metrics m;
+    m["ticks_per_sec"] = std::round(total.ticksPerSecond());
+    m["events_per_sec"] = total.elapsedSeconds > 0.0
+        ? std::round(total.eventsProcessed / total.elapsedSeconds) : 0.0;
+    m["allocations"] =
+        static_cast<double>(gAllocations.load(std::memory_order_relaxed) - allocsBefore);
+    m["peak_heap_kb"] = std::ceil(
+        (gPeakBytes.load(std::memory_order_relaxed) - heapBefore) / 1024.0);
+    m["wait_p50"] = riders.waitTicks.percentile(0.50);
+    m["wait_p95"] = riders.waitTicks.percentile(0.95);
+    m["wait_p99"] = riders.waitTicks.percentile(0.99);
+    m["delivered"] = static_cast<double>(riders.delivered.load());
+    m["unserved"] = static_cast<double>(riders.spawned.load() - riders.delivered.load());
+    return m;
+}
+
+// ============== Metric Rules ==============
+
+struct MetricRule {
+    const char* name;
+    bool higherIsBetter;
+    bool timing;   // Wall-clock: compared only against the same build flavour
+    double slack;  // Absolute allowance on top of the relative tolerance
+};
+
+// `delivered` is recorded for context only: it is fixed by the seed
+const std::vector<MetricRule>& rules() {
+    static const std::vector<MetricRule> all = {
+        {"ticks_per_sec", true, true, 0.0},
+        {"events_per_sec", true, true, 0.0},
+        {"allocations", false, false, 0.0},
+        {"peak_heap_kb", false, false, 4.0},
+        {"wait_p50", false, false, 1.0},
+        {"wait_p95", false, false, 1.0},
+        {"wait_p99", false, false, 1.0},
+        {"unserved", false, false, 0.0},
+    };
+    return all;
+}
+
+std::string formatValue(double value) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(value == std::floor(value) ? 0 : 1) << value;
+    return out.str();
+}
+
+// ============== Baseline File ==============
+// One "key value" per line, '#' comments. Keys are "<scenario>.<metric>"
+// plus build.optimized and suite.scale describing how it was recorded.
+
+std::map<std::string, double> readBaseline(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open baseline " + path);
+    }
+    std::map<std::string, double> values;
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        std::string key;
+        double value = 0.0;
+        if (!(fields >> key >> value)) {
+            throw std::runtime_error(path + ":" + std::to_string(lineNo) +
+                                     ": expected '<key> <value>'");
+        }
+        values[key] = value;
+    }
+    return values;
+}
+
+void writeBaseline(const std::string& path, double scale,
+                   const std::vector<std::pair<std::string, Metrics>>& results) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot write baseline " + path);
+    }
+    out << "# perf_suite baseline: <scenario>.<metric> <value>\n"
+        << "# Regenerate from an optimised build with: cmake --build . --target perf_baseline\n"
+        << "build.optimized " << kOptimized << "\n"
+        << "suite.scale " << formatValue(scale) << "\n";
+    for (const auto& [scenario, metrics] : results) {
+        for (const auto& [metric, value] : metrics) {
+            out << scenario << "." << metric << " " << formatValue(value) << "\n";
+        }
+    }
+}
+
+// Prints one line per compared metric; returns the number of regressions
+int checkBaseline(const std::map<std::string, double>& baseline, double scale,
+                  const std::vector<std::pair<std::string, Metrics>>& results,
+                  double tolerance, double timingTolerance) {
+    auto lookup = [&baseline](const std::string& key, double fallback) {
+        auto it = baseline.find(key);
+        return it == baseline.end() ? fallback : it->second;
+    };
+    if (lookup("suite.scale", 1.0) != scale) {
+        throw std::runtime_error("Baseline was recorded at --scale " +
+                                 formatValue(lookup("suite.scale", 1.0)));
+    }
+    bool compareTiming = lookup("build.optimized", kOptimized) == kOptimized;
+    if (!compareTiming) {
+        std::cout << "Note: baseline is from " << (kOptimized ? "a debug" : "an optimised")
+                  << " build; skipping ticks/sec and events/sec\n";
+    }
+
+    int regressions = 0;
+    for (const auto& [scenario, metrics] : results) {
+        for (const MetricRule& rule : rules()) {
+            std::string key = scenario + "." + rule.name;
+            double current = metrics.at(rule.name);
+            auto it = baseline.find(key);
+            if (it == baseline.end()) {
+                std::cout << "  new      " << key << " = " << formatValue(current) << "\n";
+                continue;
+            }
+            if (rule.timing && !compareTiming) continue;
+            double base = it->second;
+            double tol = rule.timing ? timingTolerance : tolerance;
+            bool regressed = rule.higherIsBetter
+                ? current < base * (1.0 - tol) - rule.slack
+                : current > base * (1.0 + tol) + rule.slack;
+            bool improved = rule.higherIsBetter
+                ? current > base * (1.0 + tol) + rule.slack
+                : current < base * (1.0 - tol) - rule.slack;
+            double change = base != 0.0 ? (current - base) / base * 100.0 : 0.0;
+            std::cout << (regressed ? "  REGRESS  " : improved ? "  improved " : "  ok       ")
+                      << std::left << std::setw(44) << key << std::right
+                      << std::setw(14) << formatValue(base) << " -> "
+                      << std::setw(14) << formatValue(current)
+                      << std::showpos << std::fixed << std::setprecision(1)
+                      << std::setw(9) << change << "%" << std::noshowpos << "\n";
+            regressions += regressed ? 1 : 0;
+        }
+    }
+    return regressions;
+}
+
+void printUsage(const char* progName) {
+    std::cout << "Usage: " << progName << " [options]\n"
+              << "\nOptions:\n"
+              << "  --check <file>            Compare with a baseline; exit 1 on regression\n"
+              << "  --write <file>            Record the results as a new baseline\n"
+              << "  --tolerance <f>           Relative slack for counts and waits (default: 0.10)\n"
+              << "  --timing-tolerance <f>    Relative slack for ticks/events per sec (default: 0.25)\n"
+              << "  --scale <f>               Multiply scenario lengths (default: 1)\n"
+              << "  --scenario <name>         Run one scenario only\n"
+              << "  -h, --help                Show this help\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string checkPath;
+    std::string writePath;
+    std::string only;
+    double tolerance = 0.10;
+    double timingTolerance = 0.25;
+    double scale = 1.0;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--check" && i + 1 < argc) {
+                checkPath = argv[++i];
+            } else if (arg == "--write" && i + 1 < argc) {
+                writePath = argv[++i];
+            } else if (arg == "--tolerance" && i + 1 < argc) {
+                tolerance = std::stod(argv[++i]);
+            } else if (arg == "--timing-tolerance" && i + 1 < argc) {
+                timingTolerance = std::stod(argv[++i]);
+            } else if (arg == "--scale" && i + 1 < argc) {
+                scale = std::stod(argv[++i]);
+            } else if (arg == "--scenario" && i + 1 < argc) {
+                only = argv[++i];
+            } else {
+                printUsage(argv[0]);
+                return arg == "-h" || arg == "--help" ? 0 : 1;
+            }
+        }
+        if (!(scale > 0.0) || tolerance < 0.0 || timingTolerance < 0.0) {
+            std::cerr << "Error: scale must be positive and tolerances non-negative\n";
+            return 1;
+        }
+
+        // Read first, so a missing or malformed baseline fails before the runs
+        std::map<std::string, double> baseline;
+        if (!checkPath.empty()) {
+            baseline = readBaseline(checkPath);
+        }
+
+        std::vector<std::pair<std::string, Metrics>> results;
+        std::cout << std::left << std::setw(26) << "scenario" << std::right
+                  << std::setw(12) << "ticks/s" << std::setw(12) << "events/s"
+                  << std::setw(10) << "allocs" << std::setw(10) << "heap KB"
+                  << std::setw(7) << "p50" << std::setw(7) << "p95" << std::setw(7) << "p99"
+                  << std::setw(10) << "unserved" << "\n";
+        for (const Scenario& scenario : scenarios()) {
+            if (!only.empty() && scenario.name != only) continue;
+            // Everything but the rates repeats exactly; the best run is the
+            // one least disturbed by the rest of the machine
+            Metrics m = runScenario(scenario, scale);
+            for (int run = 1; run < kTimingRuns; ++run) {
+                Metrics again = runScenario(scenario, scale);
+                m["ticks_per_sec"] = std::max(m["ticks_per_sec"], again["ticks_per_sec"]);
+                m["events_per_sec"] = std::max(m["events_per_sec"], again["events_per_sec"]);
+            }
+            std::cout << std::left << std::setw(26) << scenario.name << std::right
+                      << std::fixed << std::setprecision(0)
+                      << std::setw(12) << m["ticks_per_sec"] << std::setw(12) << m["events_per_sec"]
+                      << std::setw(10) << m["allocations"] << std::setw(10) << m["peak_heap_kb"]
+                      << std::setw(7) << m["wait_p50"] << std::setw(7) << m["wait_p95"]
+                      << std::setw(7) << m["wait_p99"] << std::setw(10) << m["unserved"] << "\n";
+            results.emplace_back(scenario.name, std::move(m));
+        }
+        if (results.empty()) {
+            std::cerr << "Error: unknown scenario " << only << "\n";
+            return 1;
+        }
+
+        if (!writePath.empty()) {
+            writeBaseline(writePath, scale, results);
+            std::cout << "Baseline written to " << writePath << "\n";
+        }
+        if (!checkPath.empty()) {
+            std::cout << "\nChecking against " << checkPath << "\n";
+            int regressions = checkBaseline(baseline, scale, results,
+                                            tolerance, timingTolerance);
+            if (regressions > 0) {
+                std::cout << regressions << " metric(s) regressed\n";
+                return 1;
+            }
+            std::cout << "No regressions\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
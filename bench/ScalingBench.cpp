@@ -0,0 +1,126 @@
+#include "Simulation.hpp"
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// ============== Scaling Benchmark ==============
+// Headless ticks/sec across floors x cars for both controllers. Load is a
+// seeded random stream of hall and car calls proportional to fleet size,
+// so per-tick work grows with the building rather than staying idle.
+
+namespace {
+
+struct ScalingResult {
+    int floors;
+    int cars;
+    ControllerType type;
+    RunStats stats;
+};
+
+ScalingResult runScenario(int floors, int cars, ControllerType type, int ticks) {
+    Config config;
+    config.numFloors = floors;
+    config.numElevators = cars;
+    config.controllerType = type;
+    config.headless = true;
+    config.loggingEnabled = false;
+
+    SimulationEngine engine(config);
+
+    std::mt19937 gen(12345);
+    std::uniform_int_distribution<> floorDist(1, floors);
+    std::uniform_int_distribution<> carDist(0, cars - 1);
+    std::bernoulli_distribution dirDist(0.5);
+    // Roughly one new call per car every 25 ticks
+    std::poisson_distribution<> callsPerTick(cars / 25.0);
+
+    RunStats total;
+    for (int t = 0; t < ticks; ++t) {
+        int calls = callsPerTick(gen);
+        for (int c = 0; c < calls; ++c) {
+            int floor = floorDist(gen);
+            if (dirDist(gen)) {
+                Direction dir = dirDist(gen) ? Direction::Up : Direction::Down;
+                if (floor == 1) dir = Direction::Up;
+                if (floor == floors) dir = Direction::Down;
+                engine.requestHallCall(floor, dir);
+            } else {
+                engine.requestCarCall(carDist(gen), floor);
+            }
+        }
+
+        RunStats step = engine.runTicks(1);
+        total.ticks += step.ticks;
+        total.eventsProcessed += step.eventsProcessed;
+        total.elapsedSeconds += step.elapsedSeconds;
+    }
+
+    return {floors, cars, type, total};
+}
+
+void printUsage(const char* progName) {
+    std::cout << "Usage: " << progName << " [options]\n"
+              << "\nOptions:\n"
+              << "  --ticks <n>        Ticks per scenario (default: 20000)\n"
+              << "  --mode <type>      master|distributed|both (default: both)\n"
+              << "  -h, --help         Show this help\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    int ticks = 20000;
+    std::vector<ControllerType> modes = {ControllerType::Master, ControllerType::Distributed};
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--ticks" && i + 1 < argc) {
+            ticks = std::stoi(argv[++i]);
+        } else if (arg == "--mode" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "master") {
+                modes = {ControllerType::Master};
+            } else if (mode == "distributed") {
+                modes = {ControllerType::Distributed};
+            } else if (mode != "both") {
+                std::cerr << "Error: mode must be master, distributed or both\n";
+                return 1;
+            }
+        } else {
+            printUsage(argv[0]);
+            return arg == "-h" || arg == "--help" ? 0 : 1;
+        }
+    }
+
+    const std::vector<int> floorCounts = {12, 40, 80, 150};
+    const std::vector<int> carCounts = {3, 12, 24, 48};
+
+    std::cout << std::left << std::setw(8) << "floors" << std::setw(6) << "cars"
+              << std::setw(13) << "controller" << std::right
+              << std::setw(14) << "ticks/s" << std::setw(12) << "ns/tick"
+              << std::setw(16) << "ns/(tick*car)" << "\n";
+
+    for (ControllerType type : modes) {
+        for (int floors : floorCounts) {
+            for (int cars : carCounts) {
+                ScalingResult r = runScenario(floors, cars, type, ticks);
+                double nsPerTick = r.stats.ticks > 0
+                    ? r.stats.elapsedSeconds * 1e9 / r.stats.ticks : 0.0;
+
+                std::cout << std::left << std::setw(8) << r.floors << std::setw(6) << r.cars
+                          << std::setw(13)
+                          << (type == ControllerType::Master ? "master" : "distributed")
+                          << std::right << std::fixed << std::setprecision(0)
+                          << std::setw(14) << r.stats.ticksPerSecond()
+                          << std::setw(12) << nsPerTick
+                          << std::setprecision(1) << std::setw(16) << nsPerTick / r.cars
+                          << "\n";
+            }
+        }
+    }
+
+    return 0;
+}
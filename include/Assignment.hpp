@@ -0,0 +1,36 @@
+#ifndef ASSIGNMENT_HPP
+#define ASSIGNMENT_HPP
+
+#include <cstddef>
+#include <vector>
+
+// ============== Min-Cost Assignment ==============
+// Hungarian algorithm (shortest augmenting paths with potentials) for a
+// rows x cols cost matrix, rows <= cols: every row gets a distinct column
+// and the total cost is minimal. O(rows^2 * cols). All working storage is
+// kept across calls, so a solver reused at a stable size never allocates.
+
+class AssignmentSolver {
+private:
+    std::vector<int> cost_;       // Row-major rows x cols
+    std::vector<long long> u_;    // Row potentials (1-based)
+    std::vector<long long> v_;    // Column potentials (1-based)
+    std::vector<int> rowOfCol_;   // Column -> row (1-based, 0 = free)
+    std::vector<int> way_;
+    std::vector<long long> minv_;
+    std::vector<char> used_;
+    std::vector<int> result_;     // Row -> column (0-based)
+    int rows_ = 0;
+    int cols_ = 0;
+
+public:
+    // Size the problem; contents of the cost matrix are unspecified until set
+    void reset(int rows, int cols);
+
+    int& cost(int row, int col) { return cost_[static_cast<std::size_t>(row) * cols_ + col]; }
+
+    // Solve the current matrix; returns the column chosen for each row
+    const std::vector<int>& solve();
+};
+
+#endif // ASSIGNMENT_HPP
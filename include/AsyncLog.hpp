@@ -0,0 +1,135 @@
+#ifndef ASYNC_LOG_HPP
+#define ASYNC_LOG_HPP
+
+#include "Types.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ============== Log Categories ==============
+// Categories left out of ELEVATOR_LOG_CATEGORIES (a bitmask of the values
+// below, set from CMake) compile to nothing at every call site.
+
+enum class LogCategory : unsigned {
+    Event = 1u << 0,        // Every processed queue event
+    State = 1u << 1,        // Car state on arrival
+    Call = 1u << 2,         // Accepted hall/car calls and passengers
+    Assignment = 1u << 3    // Scheduler assignments
+};
+
+#ifndef ELEVATOR_LOG_CATEGORIES
+#define ELEVATOR_LOG_CATEGORIES 0xFu
+#endif
+
+constexpr bool logCategoryCompiled(LogCategory category) {
+    return (ELEVATOR_LOG_CATEGORIES & static_cast<unsigned>(category)) != 0;
+}
+
+// ============== Log Record ==============
+// Fixed-size binary log entry. Producers fill one in place (no strings, no
+// allocation); the background thread formats it or writes it out raw.
+
+enum class LogKind : std::uint8_t {
+    Event,
+    ElevatorState,
+    HallCall,
+    CarCall,
+    Assignment,
+    Passenger,
+    DestinationCall
+};
+
+struct LogRecord {
+    std::int64_t wallSeconds;     // Only used when no tick reference is set
+    std::int32_t tick;            // -1 = no tick reference
+    LogKind kind;
+    std::uint8_t code;            // EventType or ElevatorState
+    std::uint8_t direction;       // Direction
+    std::uint8_t reserved8;
+    std::int16_t elevatorId;
+    std::int16_t floor;
+    std::int16_t passengers;
+    std::int16_t destination;     // PassengerArrival / Passenger / DestinationCall
+    std::uint64_t carCalls[4];    // FloorMask words (ElevatorState only)
+    std::uint64_t reserved64;
+};
+static_assert(sizeof(LogRecord) == 64, "LogRecord layout changed");
+
+constexpr char kLogMagic[8] = {'E', 'L', 'V', 'L', 'O', 'G', '0', '1'};
+
+// ============== Async Log Sink ==============
+// Each producing thread gets its own single-producer ring, registered on
+// first use; write() never blocks or allocates after that and drops the
+// record (counted) if the ring is full. One background thread drains the
+// rings, ordering each batch by tick, and either formats text lines onto
+// the text stream or appends raw records to a binary file.
+
+class AsyncLogSink {
+public:
+    static constexpr std::size_t kRingCapacity = 4096;  // Records per thread
+
+    // Text mode: format records onto `out`
+    explicit AsyncLogSink(std::ostream& out);
+    // Raw mode: records go to `rawPath` (kLogMagic + records); synchronous
+    // lines still go to `out`. Throws std::runtime_error if unopenable.
+    AsyncLogSink(std::ostream& out, const std::string& rawPath);
+    ~AsyncLogSink();  // Drains everything written so far, then joins
+
+    AsyncLogSink(const AsyncLogSink&) = delete;
+    AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+    // Producer side (any thread)
+    void write(const LogRecord& record);
+
+    // Synchronous text line, serialized with the background writer
+    void writeLine(const std::string& line);
+
+    // Block until every record written before the call is output
+    void flush();
+
+    std::uint64_t getDropped() const;
+    bool isRaw() const { return raw_.is_open(); }
+
+    // Text rendering shared by the background thread and decode()
+    static void format(const LogRecord& record, std::string& out);
+    // Convert a raw log file to text; returns records decoded. Throws
+    // std::runtime_error on a missing or malformed file.
+    static std::size_t decode(const std::string& rawPath, std::ostream& out);
+
+private:
+    struct Ring;
+
+    std::ostream& out_;
+    std::ofstream raw_;
+    std::mutex outMutex_;  // Serializes writeLine against the worker
+
+    std::mutex ringsMutex_;
+    std::vector<std::unique_ptr<Ring>> rings_;
+    const std::uint64_t id_;  // Distinguishes sinks in the thread-local cache
+
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    std::condition_variable passDone_;
+    std::uint64_t passes_ = 0;
+    bool flushRequested_ = false;
+    bool stopping_ = false;
+
+    std::atomic<std::uint64_t> dropped_{0};
+    std::vector<LogRecord> batch_;  // Worker-only scratch
+    std::string text_;              // Worker-only scratch
+    std::thread worker_;
+
+    Ring* localRing();
+    bool drainOnce();
+    void run();
+};
+
+#endif // ASYNC_LOG_HPP
@@ -0,0 +1,71 @@
+#ifndef BATCH_RUNNER_HPP
+#define BATCH_RUNNER_HPP
+
+#include "Types.hpp"
+#include "Metrics.hpp"
+#include "Simulation.hpp"
+#include "Traffic.hpp"
+#include <cstdint>
+
+// ============== Batch Configuration ==============
+
+struct BatchConfig {
+    Config base;                   // Building/timing; forced headless, quiet
+    int runs = 1000;
+    int ticksPerRun = 2000;
+    double callsPerTick = 0.2;     // Mean passenger arrivals per tick (Poisson)
+    TrafficProfile traffic = TrafficProfile::Uniform;
+    std::uint32_t seed = 1;        // Run i uses seed + i
+    int threads = 0;               // 0 = one per hardware thread
+    // Fork every run from this warmed-up state instead of an empty
+    // building (not owned). Its shape and controller override `base`.
+    const SimulationSnapshot* warmStart = nullptr;
+};
+
+// ============== Batch Results ==============
+
+struct BatchResult {
+    ControllerType controller = ControllerType::Master;
+    int runs = 0;
+    long long ticks = 0;
+    long long eventsProcessed = 0;
+    CallMetrics metrics;           // Call-level, merged over every run
+    PassengerMetrics passengers;   // Passenger-level, merged over every run
+    double elapsedSeconds = 0.0;
+
+    double runsPerSecond() const {
+        return elapsedSeconds > 0.0 ? runs / elapsedSeconds : 0.0;
+    }
+};
+
+// ============== Batch Runner ==============
+// Monte-Carlo comparison: many independent headless engines, each with its
+// own seeded passenger load, spread over a pool of worker threads. Workers
+// pull run indices from a shared counter and merge into private metrics,
+// so nothing mutable is shared and the result does not depend on the
+// thread count or scheduling order.
+
+class BatchRunner {
+private:
+    BatchConfig config_;
+
+public:
+    explicit BatchRunner(const BatchConfig& config);
+
+    // With a warm start, `controller` must be the snapshot's
+    // (std::invalid_argument otherwise)
+    BatchResult run(ControllerType controller) const;
+
+    // One run on the calling thread driven by `traffic`; merges its
+    // metrics into `into`
+    static RunStats runOne(const Config& config, int ticks, const TrafficConfig& traffic,
+                           BatchResult& into, const SimulationSnapshot* warmStart = nullptr);
+    // Same with uniform traffic at `callsPerTick`, seeded with `seed`
+    static RunStats runOne(const Config& config, int ticks, double callsPerTick,
+                           std::uint32_t seed, BatchResult& into,
+                           const SimulationSnapshot* warmStart = nullptr);
+
+    int getThreadCount() const;
+};
+
+#endif // BATCH_RUNNER_HPP
@@ -0,0 +1,126 @@
+#ifndef CAMPUS_HPP
+#define CAMPUS_HPP
+
+#include "Types.hpp"
+#include "Metrics.hpp"
+#include "Simulation.hpp"
+#include "WorkerPool.hpp"
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ============== Campus Configuration ==============
+// One shard is one Building + scheduler: a tower, or one elevator group
+// (low-rise, mid-rise, high-rise) of a tower. Floors are numbered within
+// the shard; `transferFloor` is where it meets the others (sky lobby).
+
+struct ShardConfig {
+    std::string name;
+    Config config;              // Forced headless and quiet, carWorkers = 0
+    int transferFloor = 1;      // Sky lobby / ground lobby of this shard
+    double callsPerTick = 0.2;  // Mean passenger arrivals per tick (Poisson)
+};
+
+struct CampusConfig {
+    std::vector<ShardConfig> shards;
+    double transferShare = 0.1; // Share of trips that end in another shard
+    int transferTicks = 0;      // Walk between lobbies, on top of the one-tick hop
+    std::uint32_t seed = 1;     // Shard i uses seed + i
+    int threads = 0;            // 0 = one per hardware thread (at most one per shard)
+};
+
+// ============== Campus Results ==============
+// Shard metrics count every leg on its own: a transfer passenger is
+// delivered once at the sky lobby of its first shard and once at its
+// destination. `transferJourneyTicks` times the whole trip.
+
+struct ShardResult {
+    std::string name;
+    long long eventsProcessed = 0;
+    long long transfersOut = 0;    // Riders sent on to another shard
+    PassengerMetrics passengers;
+};
+
+struct CampusResult {
+    int ticks = 0;
+    long long eventsProcessed = 0;
+    long long transfersSent = 0;
+    long long transfersCompleted = 0;  // Reached their final floor
+    LatencyHistogram transferJourneyTicks;
+    PassengerMetrics passengers;       // All shards merged
+    std::vector<ShardResult> shards;
+    double elapsedSeconds = 0.0;
+
+    double ticksPerSecond() const {
+        return elapsedSeconds > 0.0 ? ticks / elapsedSeconds : 0.0;
+    }
+};
+
+// ============== Campus Simulator ==============
+// Many headless engines advanced in lockstep on a WorkerPool: each tick
+// every shard spawns its load, takes in the transfers addressed to it and
+// runs one tick on whichever worker picks it up; the pool's barrier ends
+// the tick. Shards share nothing while they run. Riders bound for another
+// shard leave through the shard's outbox and are routed to inboxes on the
+// calling thread after the barrier, in shard order, so results do not
+// depend on the thread count.
+
+class CampusSimulator {
+private:
+    // A cross-shard hop, delivered at the target's transfer floor
+    struct Transfer {
+        int shard = -1;
+        int destination = 0;
+        int deliverTick = 0;
+        int startTick = 0;     // When the trip began in its first shard
+    };
+
+    // What happens when a tracked rider alights
+    struct Leg {
+        int nextShard = -1;    // -1: this was the last leg
+        int destination = 0;   // Final floor in nextShard
+        int startTick = 0;
+    };
+
+    struct Shard {
+        ShardConfig spec;
+        std::unique_ptr<SimulationEngine> engine;
+        std::mt19937 gen;
+        std::vector<Passenger> arrivals;      // Filled by the engine each tick
+        std::unordered_map<int, Leg> legs;    // Passenger id -> onward trip
+        std::vector<Transfer> inbox;
+        std::vector<Transfer> outbox;
+        long long transfersOut = 0;
+        long long transfersCompleted = 0;
+        LatencyHistogram transferJourneyTicks;
+    };
+
+    CampusConfig config_;
+    std::vector<Shard> shards_;
+    WorkerPool pool_;
+
+    void tickShard(int index);
+    void route();
+    void admit(Shard& shard, const Transfer& transfer, int tick);
+
+public:
+    // Throws std::invalid_argument for an empty campus, a bad transfer
+    // floor or a negative rate
+    explicit CampusSimulator(const CampusConfig& config);
+
+    CampusSimulator(const CampusSimulator&) = delete;
+    CampusSimulator& operator=(const CampusSimulator&) = delete;
+
+    // Advance every shard `count` ticks; results cover this call only
+    // for timing and everything since construction for metrics
+    CampusResult runTicks(int count);
+
+    int getShardCount() const { return static_cast<int>(shards_.size()); }
+    int getThreadCount() const { return pool_.getThreadCount(); }
+    const SimulationEngine& getShard(int index) const;
+};
+
+#endif // CAMPUS_HPP
@@ -0,0 +1,34 @@
+#ifndef COMMAND_PARSER_HPP
+#define COMMAND_PARSER_HPP
+
+#include "Types.hpp"
+#include <string_view>
+
+// ============== Command Parser ==============
+// Parses one CLI line in place: no streams, no allocation. Call commands
+// (hall, car, pass, dest) come back as a Request, so a piped or scripted
+// command stream can be handed to SimulationEngine::requestBatch in bursts.
+
+enum class CommandKind {
+    Empty,      // Blank line or '#' comment
+    Request,    // hall / car / pass / dest; see Command::request
+    Status,
+    Stats,      // Tick-loop profile table
+    Metrics,    // Same counters in Prometheus text format
+    Help,
+    Quit,       // quit / exit / q
+    BadArgs,    // Known command with malformed arguments; see Command::usage
+    Unknown
+};
+
+struct Command {
+    CommandKind kind = CommandKind::Empty;
+    Request request;
+    std::string_view word;          // Command word as typed
+    const char* usage = nullptr;    // BadArgs only
+};
+
+// Trailing text after the expected arguments is ignored
+Command parseCommand(std::string_view line);
+
+#endif // COMMAND_PARSER_HPP
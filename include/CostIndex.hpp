@@ -0,0 +1,54 @@
+#ifndef COST_INDEX_HPP
+#define COST_INDEX_HPP
+
+#include "Types.hpp"
+#include "FloorMask.hpp"
+#include "FleetState.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// ============== Cost Index ==============
+// Incrementally maintained view of the fleet for hall-call assignment.
+// Cars are bucketed by what Elevator::costToServe() depends on - idle,
+// travelling up, travelling down or stopped without a direction, and full
+// or not - with a per-floor car bitmask in each bucket. Elevator state
+// transitions re-bucket only the car that changed, so picking the cheapest
+// car for a call looks at no more than three floors per bucket instead of
+// costing every car.
+
+class CostIndex {
+public:
+    static constexpr int kBuckets = 8;  // {Idle, Up, Down, Stopped} x {room, full}
+
+private:
+    static_assert(kMaxElevators <= 64, "Per-floor car masks are 64-bit");
+
+    struct Bucket {
+        FloorMask occupied;                  // Floors with at least one car
+        std::vector<std::uint64_t> carsAt;   // By floor: bit per car id
+    };
+
+    std::array<Bucket, kBuckets> buckets_;
+    unsigned liveBuckets_ = 0;   // Bit per non-empty bucket
+    std::vector<int> bucketOf_;  // By car, -1 if not indexed yet
+    std::vector<int> floorOf_;   // By car
+    int numFloors_ = 0;
+
+    static int classify(const FleetState& fleet, int car);
+    int costAt(int bucket, int carFloor, int floor, Direction dir) const;
+
+public:
+    CostIndex() = default;
+    CostIndex(int numFloors, int numCars);
+
+    // Re-bucket one car after its floor, state, direction or load changed
+    void update(const FleetState& fleet, int car);
+    void rebuild(const FleetState& fleet);
+
+    // Car with the lowest costToServe(floor, dir), lowest id on ties;
+    // -1 if the index is empty
+    int bestCar(int floor, Direction dir) const;
+};
+
+#endif // COST_INDEX_HPP
@@ -2,8 +2,14 @@
 #define DOMAIN_HPP
 
 #include "Types.hpp"
+#include "FleetState.hpp"
+#include "CostIndex.hpp"
+#include "Metrics.hpp"
+#include "Snapshot.hpp"
+#include "Profiler.hpp"
+#include "Motion.hpp"
+#include "SharedState.hpp"
 #include <vector>
-#include <set>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -32,31 +38,35 @@ public:
 };
 
 // ============== Elevator ==============
+// Handle onto one car's slot in a FleetState. Elevators owned by a Building
+// share its fleet and keep its CostIndex current on every state change; a
+// standalone Elevator owns a single-car fleet.
 
 class Elevator {
 private:
+    std::unique_ptr<FleetState> ownedFleet_;
+    FleetState* fleet_;
+    CostIndex* costIndex_ = nullptr;
+    int index_;  // Slot in fleet_
     int id_;
-    int currentFloor_;
-    Direction direction_ = Direction::Idle;
-    ElevatorState state_ = ElevatorState::Idle;
-    std::set<int> carCalls_;  // Destination floors (sorted, no duplicates)
-    int passengerCount_ = 0;
-    int capacity_;
-    int ticksRemaining_ = 0;  // For timed operations (moving, doors)
 
-    mutable std::mutex mutex_;
+    void reindex();
 
 public:
     Elevator(int id, int capacity, int startFloor = 1);
+    Elevator(FleetState& fleet, int id, CostIndex* costIndex = nullptr);
 
-    // Getters (thread-safe)
+    // Index kept current on state changes (nullptr = none)
+    void setCostIndex(CostIndex* costIndex);
+
+    // Getters (simulation thread; other threads read Building snapshots)
     int getId() const;
     int getCurrentFloor() const;
     Direction getDirection() const;
     ElevatorState getState() const;
     int getPassengerCount() const;
     int getCapacity() const;
-    std::set<int> getCarCalls() const;
+    FloorMask getCarCalls() const;
     int getTicksRemaining() const;
 
     // Car call management
@@ -68,7 +78,8 @@ public:
     // State transitions
     void startMoving(Direction dir, int ticksToArrive);
     void decrementTick();
-    void arriveAtFloor(int floor);
+    void arriveAtFloor(int floor, int ticksToOpen = 0);  // Ends the run
+    void passFloor(int floor, int ticksToNext);  // Keep moving without stopping
     void openDoors(int ticksToOpen);
     void setDoorsOpen(int ticksOpen);
     void closeDoors(int ticksToClose);
@@ -93,9 +104,29 @@ public:
 class Building {
 private:
     std::vector<Floor> floors_;
-    std::vector<std::unique_ptr<Elevator>> elevators_;
+    FleetState fleet_;
+    CostIndex costIndex_;              // Kept current by the elevator handles
+    std::vector<Elevator> elevators_;  // Handles into fleet_
     Config config_;
-    mutable std::mutex mutex_;
+    MotionProfile motion_;             // Ticks per floor of a run, energy per trip
+
+    // Hall-call registry (simulation thread); Floor buttons mirror it
+    FloorMask upCalls_;
+    FloorMask downCalls_;
+
+    // Call timing (simulation thread): tick each call was registered, -1 idle
+    int currentTick_ = 0;
+    std::vector<int> upCallSince_;     // By floor
+    std::vector<int> downCallSince_;   // By floor
+    std::vector<int> carCallSince_;    // By car * (numFloors + 1) + floor
+    CallMetrics metrics_;
+
+    // Serialises call clearing (registries + metrics) when per-car workers
+    // serve floors concurrently
+    ProfiledMutex callMutex_;
+
+    FleetSnapshotBuffer snapshot_;  // Last published state (seqlock)
+    std::unique_ptr<SharedStateWriter> sharedState_;  // Cross-process copy, if exported
 
 public:
     explicit Building(const Config& config);
@@ -104,23 +135,69 @@ public:
     int getNumFloors() const;
     int getNumElevators() const;
     const Config& getConfig() const;
+    const MotionProfile& getMotion() const { return motion_; }
 
     // Elevator access
     Elevator& getElevator(int id);
     const Elevator& getElevator(int id) const;
 
+    // Raw fleet state for the simulation thread's hot loops. Only timers
+    // are written directly; state changes go through the Elevator handles
+    // so the cost index stays current.
+    FleetState& getFleet();
+    const FleetState& getFleet() const;
+    const CostIndex& getCostIndex() const;
+
+    // Per-car workers change cars concurrently: stop indexing while they
+    // run, then re-bucket every car once they are done
+    void suspendCostIndex();
+    void resumeCostIndex();
+
+    // Snapshot publication: the simulation thread publishes once per tick,
+    // any number of threads may read the latest consistent copy without
+    // locking. readSnapshot reuses `out`'s storage, for pollers. With
+    // Config::sharedStateName the same state also goes to shared memory.
+    void publishSnapshot(int tick);
+    FleetSnapshot getSnapshot() const;
+    void readSnapshot(FleetSnapshot& out) const;
+
     // Floor access
     Floor& getFloor(int number);
     const Floor& getFloor(int number) const;
 
-    // Hall call management
+    // Simulation clock used to time calls (set by the engine every tick)
+    void setCurrentTick(int tick);
+    int getCurrentTick() const;
+
+    // Hall call management. Clearing a pending call records its wait time.
+    // Clearing (hall and car calls) is safe from several threads at once.
     void registerHallCall(int floor, Direction dir);
     void clearHallCall(int floor, Direction dir);
     bool hasHallCall(int floor, Direction dir) const;
-
-    // Get all pending hall calls
+    bool hasAnyHallCalls() const;
+    const FloorMask& getHallCallMask(Direction dir) const;
+
+    // Car call management. Clearing a pending call records its travel time.
+    void registerCarCall(int elevatorId, int floor);
+    void clearCarCall(int elevatorId, int floor);
+
+    // Wait/travel distributions of every call served so far
+    const CallMetrics& getMetrics() const;
+    void resetMetrics();
+    // Times a call-clearing lock had to wait (0 unless profiling compiled in)
+    std::uint64_t getCallLockContention() const { return callMutex_.contended(); }
+    void recordFloorTraveled(int floors = 1);
+    void recordTrips(int trips, const TripEnergy& energy);
+
+    // Get all pending hall calls (allocates; prefer the masks in hot paths)
     std::vector<std::pair<int, Direction>> getAllHallCalls() const;
 
+    // Snapshot of the fleet, calls and call timing (metrics are not kept).
+    // loadState needs the same floor/car counts; it rebuilds the floor
+    // buttons and cost index and republishes the fleet snapshot.
+    void saveState(SnapshotWriter& out) const;
+    void loadState(SnapshotReader& in);
+
     // Validation
     bool isValidFloor(int floor) const;
     bool isValidElevator(int id) const;
@@ -0,0 +1,70 @@
+#ifndef ETA_TABLE_HPP
+#define ETA_TABLE_HPP
+
+#include "Types.hpp"
+#include "FloorMask.hpp"
+#include "FleetState.hpp"
+#include <vector>
+
+// ============== ETA Table ==============
+// Per-car estimated ticks until the car can pick up a call at every
+// (floor, direction), for CostModel::Eta. A row follows the car's sweep
+// (LOOK) over its queued stops: floorTravelTicks per floor, a door cycle
+// (doorOpenTicks + 2) per stop, the rest of the current door cycle, and a
+// turn at the last stop each way. A row depends only on the car's floor,
+// state, direction, heading, load and stops, so update() recomputes it
+// only when one of those changed; the live timer (ticksRemaining) is added
+// at lookup and needs no refresh as it counts down. Rows (and their
+// scratch) are per car: update() may run concurrently for distinct cars,
+// as the per-car workers do; getRefreshCount() only between ticks.
+
+class EtaTable {
+private:
+    // What a row was computed from
+    struct Key {
+        int floor = -1;  // -1: never computed
+        ElevatorState state = ElevatorState::Idle;
+        Direction direction = Direction::Idle;
+        Direction heading = Direction::Idle;
+        bool full = false;
+        FloorMask stops;
+
+        bool operator==(const Key& other) const {
+            return floor == other.floor && state == other.state &&
+                   direction == other.direction && heading == other.heading &&
+                   full == other.full && stops == other.stops;
+        }
+    };
+
+    int numFloors_ = 0;
+    int slots_ = 0;       // Row length: hallCallSlot(numFloors + 1, Up)
+    int travelTicks_ = 1;
+    int stopTicks_ = 1;   // Door cycle at a stop
+    int doorOpenTicks_ = 0;
+    std::vector<Key> keys_;
+    std::vector<int> eta_;        // car * slots_ + hallCallSlot(floor, dir)
+    std::vector<int> sweepBack_;  // Scratch: car * (numFloors + 2) + floor, return-leg times
+    std::vector<long long> refreshes_;  // Per car
+
+    void compute(int car, const Key& key);
+
+public:
+    EtaTable() = default;
+    EtaTable(const Config& config, int numCars);
+
+    // Bring `car`'s row up to date. `stops` are every floor it will stop
+    // at (car calls plus the scheduler's calls for it); `heading` is where
+    // an idle car goes first (Idle: nowhere). Returns true if recomputed.
+    bool update(const FleetState& fleet, int car, const FloorMask& stops, Direction heading);
+
+    // Ticks until `car` could open its doors at `floor` for a `dir` call
+    // (as of its last update, plus a penalty while it is full)
+    int eta(const FleetState& fleet, int car, int floor, Direction dir) const {
+        return eta_[static_cast<size_t>(car) * slots_ + hallCallSlot(floor, dir)] +
+               fleet.ticksRemaining[car];
+    }
+
+    long long getRefreshCount() const;
+};
+
+#endif // ETA_TABLE_HPP
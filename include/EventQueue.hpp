@@ -1,61 +1,135 @@
 #ifndef EVENT_QUEUE_HPP
 #define EVENT_QUEUE_HPP
 
-#include <queue>
+#include <cstddef>
 #include <mutex>
 #include <condition_variable>
 #include <optional>
 #include <atomic>
+#include <vector>
+#include "Profiler.hpp"
+
+// ============== Locking Backend ==============
+// Vector plus read index guarded by one mutex, with a condition_variable
+// for pop(). drain() hands the whole buffer over by swap and takes the
+// caller's (empty) one back, so once both have grown to the busiest tick,
+// pushing and draining allocate nothing.
 
 template<typename T>
-class EventQueue {
+class LockingEventQueue {
 private:
-    std::queue<T> queue_;
+    std::vector<T> items_;
+    size_t head_ = 0;   // First unread item
     mutable std::mutex mutex_;
     std::condition_variable cv_;
     std::atomic<bool> shutdown_{false};
+    mutable std::atomic<std::uint64_t> contended_{0};
+    std::atomic<size_t> highWater_{0};
+
+    // Lock mutex_, counting waits when profiling is compiled in
+    std::unique_lock<std::mutex> acquire() const {
+        if constexpr (kProfilingCompiled) {
+            std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+            if (!lock.owns_lock()) {
+                contended_.fetch_add(1, std::memory_order_relaxed);
+                lock.lock();
+            }
+            return lock;
+        } else {
+            return std::unique_lock<std::mutex>(mutex_);
+        }
+    }
+
+    // Take items_[head_]; drop the read prefix once it is most of the buffer
+    T takeFront() {
+        T event = std::move(items_[head_++]);
+        if (head_ == items_.size()) {
+            items_.clear();
+            head_ = 0;
+        } else if (head_ >= 64 && head_ * 2 >= items_.size()) {
+            items_.erase(items_.begin(), items_.begin() + static_cast<std::ptrdiff_t>(head_));
+            head_ = 0;
+        }
+        return event;
+    }
 
 public:
-    EventQueue() = default;
+    LockingEventQueue() = default;
     
     // Non-copyable, non-movable
-    EventQueue(const EventQueue&) = delete;
-    EventQueue& operator=(const EventQueue&) = delete;
+    LockingEventQueue(const LockingEventQueue&) = delete;
+    LockingEventQueue& operator=(const LockingEventQueue&) = delete;
+
+    // Preallocate room for `count` queued events
+    void reserve(size_t count) {
+        auto lock = acquire();
+        items_.reserve(count);
+    }
 
     // Add event to queue (thread-safe)
     void push(T event) {
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            queue_.push(std::move(event));
+            auto lock = acquire();
+            items_.push_back(std::move(event));
         }
         cv_.notify_one();
     }
 
+    // Add a run of events under a single lock, keeping their order
+    template<typename It>
+    void pushBatch(It first, It last) {
+        if (first == last) return;
+        {
+            auto lock = acquire();
+            items_.insert(items_.end(), first, last);
+        }
+        cv_.notify_all();
+    }
+
     // Wait and retrieve event (blocks until available or shutdown)
     std::optional<T> pop() {
         std::unique_lock<std::mutex> lock(mutex_);
         cv_.wait(lock, [this] { 
-            return !queue_.empty() || shutdown_.load(); 
+            return head_ < items_.size() || shutdown_.load(); 
         });
 
-        if (shutdown_.load() && queue_.empty()) {
+        if (shutdown_.load() && head_ == items_.size()) {
             return std::nullopt;
         }
-
-        T event = std::move(queue_.front());
-        queue_.pop();
-        return event;
+        return takeFront();
     }
 
     // Non-blocking try to retrieve
     std::optional<T> tryPop() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (queue_.empty()) {
+        auto lock = acquire();
+        if (head_ == items_.size()) {
             return std::nullopt;
         }
-        T event = std::move(queue_.front());
-        queue_.pop();
-        return event;
+        return takeFront();
+    }
+
+    // Move every pending event into `out` under a single lock.
+    // Returns the number of events appended.
+    size_t drain(std::vector<T>& out) {
+        size_t count = 0;
+        {
+            auto lock = acquire();
+            count = items_.size() - head_;
+            if (out.empty() && head_ == 0) {
+                out.swap(items_);  // items_ keeps out's buffer for the next tick
+            } else {
+                out.insert(out.end(), items_.begin() + static_cast<std::ptrdiff_t>(head_),
+                           items_.end());
+            }
+            items_.clear();
+            head_ = 0;
+        }
+        if constexpr (kProfilingCompiled) {
+            if (count > highWater_.load(std::memory_order_relaxed)) {
+                highWater_.store(count, std::memory_order_relaxed);
+            }
+        }
+        return count;
     }
 
     // Signal shutdown - unblocks waiting threads
@@ -68,27 +142,45 @@ public:
     void reset() {
         std::lock_guard<std::mutex> lock(mutex_);
         shutdown_.store(false);
-        // Clear remaining items
-        std::queue<T> empty;
-        std::swap(queue_, empty);
+        // Clear remaining items, keeping the storage
+        items_.clear();
+        head_ = 0;
     }
 
     // Check if empty
     bool empty() const {
         std::lock_guard<std::mutex> lock(mutex_);
-        return queue_.empty();
+        return head_ == items_.size();
     }
 
     // Get current size
     size_t size() const {
         std::lock_guard<std::mutex> lock(mutex_);
-        return queue_.size();
+        return items_.size() - head_;
     }
 
     // Check if shutdown was requested
     bool isShutdown() const {
         return shutdown_.load();
     }
+
+    // Lock waits and deepest drain (zero when profiling is compiled out)
+    QueueCounters counters() const {
+        return {contended_.load(std::memory_order_relaxed),
+                highWater_.load(std::memory_order_relaxed)};
+    }
 };
 
+// ============== Backend Selection ==============
+// Build with -DELEVATOR_LOCKFREE_QUEUE=ON to use the lock-free ring buffer
+
+#ifdef ELEVATOR_LOCKFREE_QUEUE
+#include "LockFreeQueue.hpp"
+template<typename T>
+using EventQueue = LockFreeEventQueue<T>;
+#else
+template<typename T>
+using EventQueue = LockingEventQueue<T>;
+#endif
+
 #endif // EVENT_QUEUE_HPP
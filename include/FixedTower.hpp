@@ -0,0 +1,503 @@
+#ifndef FIXED_TOWER_HPP
+#define FIXED_TOWER_HPP
+
+#include "Types.hpp"
+#include "FloorMask.hpp"
+#include "Metrics.hpp"
+#include "Simulation.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// ============== Fixed Towers ==============
+// Compile-time shaped counterpart of Building + MasterController +
+// SimulationEngine, for towers whose floor and car counts are known at
+// build time: FixedEngine<Floors, Cars>. Fleet state is std::arrays, floor
+// masks are FloorMaskFor<Floors> (one word up to 63 floors), per-car loops
+// have constant trip counts the compiler can unroll, and floors and cars
+// given as template arguments are checked by static_assert.
+//
+// It runs the master controller with nearest-first dispatch and the
+// distance cost, headless, for hall and car calls, and follows the same
+// trajectory with the same call metrics as a SimulationEngine on that
+// Config. Other controllers, passengers, threads and the CLI stay on the
+// runtime-configured classes.
+
+// ============== Fixed Building ==============
+
+template <int Floors, int Cars>
+class FixedBuilding {
+public:
+    static_assert(Floors >= 1 && Floors <= kMaxFloors, "Floor count must be 1-255");
+    static_assert(Cars >= 1 && Cars <= kMaxElevators, "Elevator count must be 1-64");
+
+    using Mask = FloorMaskFor<Floors>;
+    static constexpr int kFloors = Floors;
+    static constexpr int kCars = Cars;
+
+    // Structure-of-arrays fleet, as FleetState (no riders: calls only)
+    struct Fleet {
+        std::array<int, Cars> floor{};
+        std::array<Direction, Cars> direction{};
+        std::array<ElevatorState, Cars> state{};
+        std::array<int, Cars> ticksRemaining{};
+        std::array<Mask, Cars> carCalls{};
+    };
+
+    static constexpr bool isValidFloor(int floor) { return floor >= 1 && floor <= Floors; }
+    static constexpr bool isValidElevator(int id) { return id >= 0 && id < Cars; }
+
+private:
+    Fleet fleet_;
+    Mask upCalls_;
+    Mask downCalls_;
+    int currentTick_ = 0;
+    std::array<int, Floors + 1> upCallSince_{};
+    std::array<int, Floors + 1> downCallSince_{};
+    std::array<std::array<int, Floors + 1>, Cars> carCallSince_{};
+    CallMetrics metrics_;
+
+public:
+    FixedBuilding() {
+        for (int car = 0; car < Cars; ++car) {
+            fleet_.floor[car] = 1;
+            fleet_.direction[car] = Direction::Idle;
+            fleet_.state[car] = ElevatorState::Idle;
+        }
+    }
+
+    const Fleet& getFleet() const { return fleet_; }
+    Fleet& getFleet() { return fleet_; }
+    const CallMetrics& getMetrics() const { return metrics_; }
+    void recordFloorTraveled(int floors) { metrics_.floorsTraveled += floors; }
+
+    void setCurrentTick(int tick) { currentTick_ = tick; }
+    int getCurrentTick() const { return currentTick_; }
+
+    // Car transitions (Elevator's, on one fleet slot; no bounds checks:
+    // callers pass a car id below Cars)
+    void startMoving(int car, Direction dir, int ticks) {
+        fleet_.direction[car] = dir;
+        fleet_.state[car] = ElevatorState::Moving;
+        fleet_.ticksRemaining[car] = ticks;
+    }
+    void arriveAtFloor(int car, int floor) {
+        fleet_.floor[car] = floor;
+        fleet_.state[car] = ElevatorState::DoorsOpening;
+    }
+    void passFloor(int car, int floor, int ticksToNext) {
+        fleet_.floor[car] = floor;
+        fleet_.ticksRemaining[car] = ticksToNext;
+    }
+    void setDoorState(int car, ElevatorState state, int ticks) {
+        fleet_.state[car] = state;
+        fleet_.ticksRemaining[car] = ticks;
+    }
+    void setIdle(int car) {
+        fleet_.state[car] = ElevatorState::Idle;
+        fleet_.direction[car] = Direction::Idle;
+        fleet_.ticksRemaining[car] = 0;
+    }
+
+    // Building::costToServe for an empty car
+    int costToServe(int car, int floor, Direction dir) const {
+        int current = fleet_.floor[car];
+        int distance = std::abs(current - floor);
+        if (fleet_.state[car] == ElevatorState::Idle) {
+            return distance;
+        }
+        Direction direction = fleet_.direction[car];
+        bool onTheWay = (direction == Direction::Up && floor > current) ||
+                        (direction == Direction::Down && floor < current);
+        return (direction == dir && onTheWay) ? distance : distance + 2 * Floors;
+    }
+
+    // Hall and car calls, timed as in Building
+    void registerHallCall(int floor, Direction dir) {
+        Mask& calls = dir == Direction::Up ? upCalls_ : downCalls_;
+        if (!calls.test(floor)) {
+            (dir == Direction::Up ? upCallSince_ : downCallSince_)[floor] = currentTick_;
+        }
+        calls.set(floor);
+    }
+    void clearHallCall(int floor, Direction dir) {
+        Mask& calls = dir == Direction::Up ? upCalls_ : downCalls_;
+        if (calls.test(floor)) {
+            metrics_.waitTicks.record(
+                currentTick_ - (dir == Direction::Up ? upCallSince_ : downCallSince_)[floor]);
+            calls.reset(floor);
+        }
+    }
+    bool hasAnyHallCalls() const { return upCalls_.any() || downCalls_.any(); }
+    const Mask& getHallCallMask(Direction dir) const {
+        return dir == Direction::Down ? downCalls_ : upCalls_;
+    }
+
+    void registerCarCall(int car, int floor) {
+        if (!fleet_.carCalls[car].test(floor)) {
+            carCallSince_[car][floor] = currentTick_;
+        }
+        fleet_.carCalls[car].set(floor);
+    }
+    void clearCarCall(int car, int floor) {
+        if (fleet_.carCalls[car].test(floor)) {
+            metrics_.travelTicks.record(currentTick_ - carCallSince_[car][floor]);
+            fleet_.carCalls[car].reset(floor);
+        }
+    }
+};
+
+// ============== Fixed Master Controller ==============
+// MasterController's nearest-first path over a FixedBuilding: the same
+// assignments, stops and dispatch, with the car scan unrolled
+
+template <int Floors, int Cars>
+class FixedMasterController {
+public:
+    using Building = FixedBuilding<Floors, Cars>;
+    using Mask = typename Building::Mask;
+
+private:
+    static constexpr int kSlots = hallCallSlot(Floors + 1, Direction::Up);
+
+    Building& building_;
+    int doorOpenTicks_;
+    int floorTravelTicks_;
+    std::array<int, kSlots> assignments_;  // hallCallSlot -> car, -1 if none
+    std::array<Mask, Cars> assignedUp_{};
+    std::array<Mask, Cars> assignedDown_{};
+
+    static constexpr int slot(int floor, Direction dir) {
+        return hallCallSlot(floor, dir);
+    }
+
+    void assign(int floor, Direction dir, int car) {
+        assignments_[slot(floor, dir)] = car;
+        (dir == Direction::Up ? assignedUp_ : assignedDown_)[car].set(floor);
+    }
+
+    // Clear (floor, dir) if `car` holds it, with the building's hall call
+    void serveAssignment(int car, int floor, Direction dir) {
+        int& owner = assignments_[slot(floor, dir)];
+        if (owner == car) {
+            (dir == Direction::Up ? assignedUp_ : assignedDown_)[car].reset(floor);
+            owner = -1;
+            building_.clearHallCall(floor, dir);
+        }
+    }
+
+    int assignHallCall(int floor, Direction dir) {
+        if (assignments_[slot(floor, dir)] >= 0) {
+            return -1;
+        }
+        building_.registerHallCall(floor, dir);
+        int car = selectElevator(floor, dir);
+        assign(floor, dir, car);
+        return car;
+    }
+
+public:
+    FixedMasterController(Building& building, const Config& config)
+        : building_(building), doorOpenTicks_(config.doorOpenTicks),
+          floorTravelTicks_(config.floorTravelTicks) {
+        assignments_.fill(-1);
+    }
+
+    // Lowest costToServe, lowest id on ties
+    int selectElevator(int floor, Direction dir) const {
+        int best = 0;
+        int bestCost = building_.costToServe(0, floor, dir);
+        for (int car = 1; car < Cars; ++car) {
+            int cost = building_.costToServe(car, floor, dir);
+            if (cost < bestCost) {
+                bestCost = cost;
+                best = car;
+            }
+        }
+        return best;
+    }
+
+    Mask destinationsOf(int car) const {
+        return building_.getFleet().carCalls[car] | assignedUp_[car] | assignedDown_[car];
+    }
+
+    void handleHallCall(int floor, Direction dir) {
+        int car = assignHallCall(floor, dir);
+        if (car >= 0) {
+            dispatchElevator(car);
+        }
+    }
+
+    // Assign every call, then dispatch each chosen car once (as the runtime
+    // controller does for a run of queued hall calls)
+    void handleHallCalls(const std::pair<int, Direction>* calls, size_t count) {
+        std::uint64_t toDispatch = 0;
+        for (size_t i = 0; i < count; ++i) {
+            int car = assignHallCall(calls[i].first, calls[i].second);
+            if (car >= 0) {
+                toDispatch |= std::uint64_t{1} << car;
+            }
+        }
+        for (; toDispatch; toDispatch &= toDispatch - 1) {
+            dispatchElevator(__builtin_ctzll(toDispatch));
+        }
+    }
+
+    void handleCarCall(int car, int floor) {
+        building_.registerCarCall(car, floor);
+        dispatchElevator(car);
+    }
+
+    void onElevatorArrived(int car, int floor) {
+        serveAssignment(car, floor, building_.getFleet().direction[car]);
+        building_.clearCarCall(car, floor);
+    }
+
+    void onDoorsClosed(int car) { dispatchElevator(car); }
+
+    void tick() {
+        for (int car = 0; car < Cars; ++car) {
+            if (building_.getFleet().state[car] == ElevatorState::Idle) {
+                dispatchElevator(car);
+            }
+        }
+    }
+
+    bool shouldStopAt(int car, int floor) const {
+        const auto& fleet = building_.getFleet();
+        Direction dir = fleet.direction[car];
+        if (fleet.carCalls[car].test(floor)) {
+            return true;
+        }
+        Mask destinations = destinationsOf(car);
+        bool ahead = dir == Direction::Up ? destinations.anyAbove(floor)
+                   : dir == Direction::Down && destinations.anyBelow(floor);
+        if (!ahead) {
+            return true;  // Nothing further on: this is the last stop
+        }
+        return assignedUp_[car].test(floor) || assignedDown_[car].test(floor);
+    }
+
+    void dispatchElevator(int car) {
+        const auto& fleet = building_.getFleet();
+        if (fleet.state[car] != ElevatorState::Idle) {
+            return;
+        }
+        int current = fleet.floor[car];
+        int target = destinationsOf(car).nearest(current);
+        if (target < 0) {
+            return;  // Nothing to do
+        }
+        if (target == current) {
+            building_.clearCarCall(car, current);
+            serveAssignment(car, current, Direction::Up);
+            serveAssignment(car, current, Direction::Down);
+            building_.setDoorState(car, ElevatorState::DoorsOpening, doorOpenTicks_);
+        } else {
+            building_.startMoving(car, target > current ? Direction::Up : Direction::Down,
+                                  floorTravelTicks_);
+        }
+    }
+};
+
+// ============== Fixed Engine ==============
+
+template <int Floors, int Cars>
+class FixedEngine {
+public:
+    using Building = FixedBuilding<Floors, Cars>;
+    using Controller = FixedMasterController<Floors, Cars>;
+
+private:
+    struct CallEvent {
+        EventType type;
+        int floor;
+        int car;
+        Direction direction;
+    };
+
+    Config config_;
+    Building building_;
+    Controller controller_;
+    std::vector<CallEvent> queue_;     // Requests, then this tick's car events
+    std::vector<CallEvent> pending_;   // The batch being processed
+    std::vector<std::pair<int, Direction>> hallRun_;
+    int currentTick_ = 0;
+    long long eventsProcessed_ = 0;
+
+    static Config shaped(Config config) {
+        if (config.controllerType != ControllerType::Master ||
+            config.dispatchPolicy != DispatchPolicy::NearestFirst ||
+            config.costModel != CostModel::Distance || config.reassignPeriod != 0 ||
+            config.motionModel != MotionModel::Fixed) {
+            throw std::invalid_argument(
+                "FixedEngine runs the master controller with nearest-first dispatch "
+                "and fixed motion");
+        }
+        config.numFloors = Floors;
+        config.numElevators = Cars;
+        config.headless = true;
+        return config;
+    }
+
+    void advanceCar(int car) {
+        auto& fleet = building_.getFleet();
+        ElevatorState state = fleet.state[car];
+        if (state == ElevatorState::Idle) {
+            return;
+        }
+        int& ticks = fleet.ticksRemaining[car];
+        if (ticks > 0) {
+            --ticks;
+        }
+        if (ticks != 0) {
+            return;
+        }
+
+        switch (state) {
+            case ElevatorState::Moving: {
+                int next = fleet.floor[car] + (fleet.direction[car] == Direction::Up ? 1 : -1);
+                building_.recordFloorTraveled(1);
+                bool atEnd = next <= 1 || next >= Floors;
+                if (!atEnd && !controller_.shouldStopAt(car, next)) {
+                    building_.passFloor(car, next, config_.floorTravelTicks);
+                    return;
+                }
+                building_.arriveAtFloor(car, next);
+                queue_.push_back({EventType::ElevatorArrived, next, car, Direction::Idle});
+                break;
+            }
+            case ElevatorState::DoorsOpening:
+                building_.setDoorState(car, ElevatorState::DoorsOpen, config_.doorOpenTicks);
+                queue_.push_back({EventType::DoorsOpened, fleet.floor[car], car, Direction::Idle});
+                break;
+            case ElevatorState::DoorsOpen:
+                building_.setDoorState(car, ElevatorState::DoorsClosing, 1);
+                break;
+            default:
+                building_.setIdle(car);
+                if (fleet.carCalls[car].any() || building_.hasAnyHallCalls()) {
+                    queue_.push_back({EventType::DoorsClosed, -1, car, Direction::Idle});
+                }
+                break;
+        }
+    }
+
+    void processEvents() {
+        while (!queue_.empty()) {
+            pending_.swap(queue_);
+            for (size_t i = 0; i < pending_.size();) {
+                const CallEvent& event = pending_[i];
+                if (event.type == EventType::HallCall) {
+                    // A run of hall calls is assigned together
+                    hallRun_.clear();
+                    for (; i < pending_.size() && pending_[i].type == EventType::HallCall; ++i) {
+                        hallRun_.emplace_back(pending_[i].floor, pending_[i].direction);
+                    }
+                    eventsProcessed_ += static_cast<long long>(hallRun_.size());
+                    if (hallRun_.size() == 1) {
+                        controller_.handleHallCall(hallRun_[0].first, hallRun_[0].second);
+                    } else {
+                        controller_.handleHallCalls(hallRun_.data(), hallRun_.size());
+                    }
+                    continue;
+                }
+                ++eventsProcessed_;
+                switch (event.type) {
+                    case EventType::CarCall:
+                        controller_.handleCarCall(event.car, event.floor);
+                        break;
+                    case EventType::ElevatorArrived:
+                        controller_.onElevatorArrived(event.car, event.floor);
+                        break;
+                    case EventType::DoorsClosed:
+                        controller_.onDoorsClosed(event.car);
+                        break;
+                    default:
+                        break;
+                }
+                ++i;
+            }
+            pending_.clear();
+        }
+    }
+
+public:
+    // Takes the timing and capacity from `config`; the shape is the
+    // template's. Throws std::invalid_argument for anything but the
+    // master controller with nearest-first dispatch and distance cost.
+    explicit FixedEngine(const Config& config = Config())
+        : config_(shaped(config)), controller_(building_, config_) {}
+
+    // Runtime-checked requests, with SimulationEngine's rules; false if rejected
+    bool requestHallCall(int floor, Direction dir) {
+        if (!Building::isValidFloor(floor) || dir == Direction::Idle ||
+            (floor == 1 && dir == Direction::Down) || (floor == Floors && dir == Direction::Up)) {
+            return false;
+        }
+        queue_.push_back({EventType::HallCall, floor, -1, dir});
+        return true;
+    }
+    bool requestCarCall(int car, int floor) {
+        if (!Building::isValidElevator(car) || !Building::isValidFloor(floor)) {
+            return false;
+        }
+        queue_.push_back({EventType::CarCall, floor, car, Direction::Idle});
+        return true;
+    }
+
+    // The same requests checked at compile time
+    template <int Floor, Direction Dir>
+    void requestHallCall() {
+        static_assert(Building::isValidFloor(Floor), "Floor outside the tower");
+        static_assert(Dir != Direction::Idle, "Hall call must have Up or Down direction");
+        static_assert(!(Floor == 1 && Dir == Direction::Down), "Cannot go down from floor 1");
+        static_assert(!(Floor == Floors && Dir == Direction::Up), "Cannot go up from top floor");
+        queue_.push_back({EventType::HallCall, Floor, -1, Dir});
+    }
+    template <int Car, int Floor>
+    void requestCarCall() {
+        static_assert(Building::isValidElevator(Car), "Elevator outside the fleet");
+        static_assert(Building::isValidFloor(Floor), "Floor outside the tower");
+        queue_.push_back({EventType::CarCall, Floor, Car, Direction::Idle});
+    }
+
+    // One tick, in SimulationEngine::step's order: cars, controller,
+    // clock, then every queued event
+    void step() {
+        for (int car = 0; car < Cars; ++car) {
+            advanceCar(car);
+        }
+        controller_.tick();
+        ++currentTick_;
+        building_.setCurrentTick(currentTick_);
+        processEvents();
+    }
+
+    RunStats runTicks(int count) {
+        RunStats stats;
+        long long eventsBefore = eventsProcessed_;
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; ++i) {
+            step();
+        }
+        stats.ticks = count > 0 ? count : 0;
+        stats.eventsProcessed = eventsProcessed_ - eventsBefore;
+        stats.elapsedSeconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - begin).count();
+        return stats;
+    }
+
+    const Config& getConfig() const { return config_; }
+    const Building& getBuilding() const { return building_; }
+    const Controller& getController() const { return controller_; }
+    int getCurrentTick() const { return currentTick_; }
+    long long getEventsProcessed() const { return eventsProcessed_; }
+};
+
+#endif // FIXED_TOWER_HPP
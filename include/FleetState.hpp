@@ -0,0 +1,185 @@
+#ifndef FLEET_STATE_HPP
+#define FLEET_STATE_HPP
+
+#include "Types.hpp"
+#include "FloorMask.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// ============== Fleet State ==============
+// Structure-of-arrays store for every car's mutable state, indexed by car
+// id. Owned and advanced by the simulation thread without locks; other
+// threads read a published FleetSnapshot instead.
+
+struct FleetState {
+    std::vector<int> floor;
+    std::vector<Direction> direction;
+    std::vector<ElevatorState> state;
+    std::vector<int> ticksRemaining;  // For timed operations (moving, doors)
+    std::vector<int> passengers;
+    std::vector<int> capacity;
+    std::vector<FloorMask> carCalls;  // Destination floors per car
+    std::vector<int> runFloors;       // Floors into the current run (0 = at rest)
+
+    FleetState() = default;
+
+    FleetState(int numCars, int carCapacity, int startFloor) {
+        for (int i = 0; i < numCars; ++i) {
+            addCar(carCapacity, startFloor);
+        }
+    }
+
+    int addCar(int carCapacity, int startFloor) {
+        floor.push_back(startFloor);
+        direction.push_back(Direction::Idle);
+        state.push_back(ElevatorState::Idle);
+        ticksRemaining.push_back(0);
+        passengers.push_back(0);
+        capacity.push_back(carCapacity);
+        carCalls.emplace_back();
+        runFloors.push_back(0);
+        return size() - 1;
+    }
+
+    int size() const { return static_cast<int>(floor.size()); }
+};
+
+// ============== Fleet Snapshot ==============
+// Consistent copy of the fleet and hall calls taken at the end of a tick
+
+struct FleetSnapshot {
+    int tick = 0;
+    FleetState fleet;
+    FloorMask upCalls;
+    FloorMask downCalls;
+};
+
+// ============== Car Words ==============
+// A car's scalar state as two 64-bit words, shared by the snapshot buffer
+// and the shared-memory export. In little-endian byte order the motion word
+// reads as { int16 floor; uint8 direction; uint8 state; int32 ticksRemaining }
+// and the load word as { int32 passengers; int32 capacity }.
+
+inline std::uint64_t packCarMotion(const FleetState& fleet, int car) {
+    return static_cast<std::uint64_t>(fleet.floor[car] & 0xFFFF) |
+           static_cast<std::uint64_t>(fleet.direction[car]) << 16 |
+           static_cast<std::uint64_t>(fleet.state[car]) << 24 |
+           static_cast<std::uint64_t>(static_cast<std::uint32_t>(fleet.ticksRemaining[car])) << 32;
+}
+
+inline std::uint64_t packCarLoad(const FleetState& fleet, int car) {
+    return static_cast<std::uint32_t>(fleet.passengers[car]) |
+           static_cast<std::uint64_t>(static_cast<std::uint32_t>(fleet.capacity[car])) << 32;
+}
+
+inline void unpackCarMotion(std::uint64_t word, FleetState& fleet, int car) {
+    fleet.floor[car] = static_cast<int>(word & 0xFFFF);
+    fleet.direction[car] = static_cast<Direction>((word >> 16) & 0xFF);
+    fleet.state[car] = static_cast<ElevatorState>((word >> 24) & 0xFF);
+    fleet.ticksRemaining[car] = static_cast<int>(static_cast<std::uint32_t>(word >> 32));
+}
+
+inline void unpackCarLoad(std::uint64_t word, FleetState& fleet, int car) {
+    fleet.passengers[car] = static_cast<int>(static_cast<std::uint32_t>(word));
+    fleet.capacity[car] = static_cast<int>(static_cast<std::uint32_t>(word >> 32));
+}
+
+// ============== Snapshot Buffer ==============
+// Seqlock holding the latest FleetSnapshot, packed into atomic words. The
+// single publisher (the simulation thread) makes the sequence odd, stores
+// every word, then makes it even; a reader copies the words and retries
+// if the sequence was odd or moved meanwhile. Publishing never waits for
+// readers, and readers never block the publisher or each other.
+
+class FleetSnapshotBuffer {
+private:
+    // Per car: floor | direction | state | ticksRemaining, passengers |
+    // capacity, then the car-call mask
+    static constexpr int kCarWords = 2 + FloorMask::kWords;
+    static constexpr int kHeaderWords = 1 + 2 * FloorMask::kWords;  // Tick, hall masks
+
+    std::atomic<std::uint64_t> sequence_{0};
+    std::vector<std::atomic<std::uint64_t>> words_;
+    int numCars_;
+
+    void store(std::size_t i, std::uint64_t value) {
+        words_[i].store(value, std::memory_order_relaxed);
+    }
+    std::uint64_t load(std::size_t i) const {
+        return words_[i].load(std::memory_order_relaxed);
+    }
+    void storeMask(std::size_t at, const FloorMask& mask) {
+        for (int w = 0; w < FloorMask::kWords; ++w) store(at + w, mask.words()[w]);
+    }
+    void loadMask(std::size_t at, FloorMask& mask) const {
+        for (int w = 0; w < FloorMask::kWords; ++w) mask.words()[w] = load(at + w);
+    }
+
+public:
+    explicit FleetSnapshotBuffer(int numCars)
+        : words_(kHeaderWords + static_cast<std::size_t>(numCars) * kCarWords),
+          numCars_(numCars) {}
+
+    FleetSnapshotBuffer(const FleetSnapshotBuffer&) = delete;
+    FleetSnapshotBuffer& operator=(const FleetSnapshotBuffer&) = delete;
+
+    void publish(int tick, const FleetState& fleet, const FloorMask& upCalls,
+                 const FloorMask& downCalls) {
+        std::uint64_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        store(0, static_cast<std::uint32_t>(tick));
+        storeMask(1, upCalls);
+        storeMask(1 + FloorMask::kWords, downCalls);
+        for (int car = 0; car < numCars_; ++car) {
+            std::size_t at = kHeaderWords + static_cast<std::size_t>(car) * kCarWords;
+            store(at, packCarMotion(fleet, car));
+            store(at + 1, packCarLoad(fleet, car));
+            storeMask(at + 2, fleet.carCalls[car]);
+        }
+
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    // Copy the latest snapshot into `out`, reusing its storage
+    void read(FleetSnapshot& out) const {
+        if (out.fleet.size() != numCars_) {
+            out.fleet = FleetState(numCars_, 0, 1);
+        }
+        FleetState& fleet = out.fleet;
+        for (;;) {
+            std::uint64_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1) {
+                std::this_thread::yield();  // Publish in progress
+                continue;
+            }
+
+            out.tick = static_cast<int>(static_cast<std::uint32_t>(load(0)));
+            loadMask(1, out.upCalls);
+            loadMask(1 + FloorMask::kWords, out.downCalls);
+            for (int car = 0; car < numCars_; ++car) {
+                std::size_t at = kHeaderWords + static_cast<std::size_t>(car) * kCarWords;
+                unpackCarMotion(load(at), fleet, car);
+                unpackCarLoad(load(at + 1), fleet, car);
+                loadMask(at + 2, fleet.carCalls[car]);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before) {
+                return;
+            }
+        }
+    }
+
+    FleetSnapshot read() const {
+        FleetSnapshot out;
+        read(out);
+        return out;
+    }
+};
+
+#endif // FLEET_STATE_HPP
@@ -0,0 +1,188 @@
+#ifndef FLOOR_MASK_HPP
+#define FLOOR_MASK_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+// ============== Floor Mask ==============
+// Fixed-width bitset of floor numbers (bit n = floor n). Replaces
+// std::set<int> for car calls and the per-floor scan for hall calls:
+// every query is a few popcount/ctz/clz word operations, no allocation.
+// FloorMask covers every floor a Building can have; compile-time sized
+// towers (FixedTower.hpp) use FloorMaskFor<Floors>, one word up to 63.
+
+template <int Words>
+class BasicFloorMask {
+public:
+    static_assert(Words >= 1, "A floor mask needs at least one word");
+    static constexpr int kBits = Words * 64;          // Floors 1..kBits-1
+    static constexpr int kWords = Words;
+
+private:
+    std::array<std::uint64_t, kWords> words_{};
+
+    static constexpr int wordOf(int floor) { return floor >> 6; }
+    static constexpr std::uint64_t bitOf(int floor) {
+        return std::uint64_t{1} << (floor & 63);
+    }
+    static bool inRange(int floor) { return floor >= 0 && floor < kBits; }
+
+public:
+    // Modifiers
+    void set(int floor) {
+        if (inRange(floor)) words_[wordOf(floor)] |= bitOf(floor);
+    }
+    void reset(int floor) {
+        if (inRange(floor)) words_[wordOf(floor)] &= ~bitOf(floor);
+    }
+    void clear() { words_.fill(0); }
+
+    // Set-like queries (drop-in for the old std::set<int> usage)
+    bool test(int floor) const {
+        return inRange(floor) && (words_[wordOf(floor)] & bitOf(floor)) != 0;
+    }
+    std::size_t count(int floor) const { return test(floor) ? 1 : 0; }
+    bool empty() const { return !any(); }
+    std::size_t size() const {
+        std::size_t n = 0;
+        for (std::uint64_t w : words_) n += __builtin_popcountll(w);
+        return n;
+    }
+
+    bool any() const {
+        for (std::uint64_t w : words_) {
+            if (w) return true;
+        }
+        return false;
+    }
+
+    // Lowest set floor strictly above `floor`, or -1
+    int nextAbove(int floor) const {
+        int start = floor + 1;
+        if (start < 0) start = 0;
+        if (start >= kBits) return -1;
+        int w = wordOf(start);
+        std::uint64_t bits = words_[w] & (~std::uint64_t{0} << (start & 63));
+        for (;;) {
+            if (bits) return (w << 6) + __builtin_ctzll(bits);
+            if (++w == kWords) return -1;
+            bits = words_[w];
+        }
+    }
+
+    // Highest set floor strictly below `floor`, or -1
+    int nextBelow(int floor) const {
+        int start = floor - 1;
+        if (start < 0) return -1;
+        if (start >= kBits) start = kBits - 1;
+        int w = wordOf(start);
+        int shift = 63 - (start & 63);
+        std::uint64_t bits = words_[w] & (~std::uint64_t{0} >> shift);
+        for (;;) {
+            if (bits) return (w << 6) + 63 - __builtin_clzll(bits);
+            if (--w < 0) return -1;
+            bits = words_[w];
+        }
+    }
+
+    bool anyAbove(int floor) const { return nextAbove(floor) >= 0; }
+    bool anyBelow(int floor) const { return nextBelow(floor) >= 0; }
+
+    int lowest() const { return nextAbove(-1); }
+    int highest() const { return nextBelow(kBits); }
+
+    // Closest set floor to `floor` (ties go to the lower floor), or -1
+    int nearest(int floor) const {
+        if (test(floor)) return floor;
+        int above = nextAbove(floor);
+        int below = nextBelow(floor);
+        if (above < 0) return below;
+        if (below < 0) return above;
+        return (above - floor < floor - below) ? above : below;
+    }
+
+    // Bitwise combination
+    BasicFloorMask& operator|=(const BasicFloorMask& other) {
+        for (int i = 0; i < kWords; ++i) words_[i] |= other.words_[i];
+        return *this;
+    }
+    BasicFloorMask& operator&=(const BasicFloorMask& other) {
+        for (int i = 0; i < kWords; ++i) words_[i] &= other.words_[i];
+        return *this;
+    }
+    friend BasicFloorMask operator|(BasicFloorMask a, const BasicFloorMask& b) { return a |= b; }
+    friend BasicFloorMask operator&(BasicFloorMask a, const BasicFloorMask& b) { return a &= b; }
+    bool operator==(const BasicFloorMask& other) const { return words_ == other.words_; }
+    bool operator!=(const BasicFloorMask& other) const { return words_ != other.words_; }
+
+    // Ascending iteration over set floors: for (int f : mask)
+    class const_iterator {
+    private:
+        const BasicFloorMask* mask_;
+        int floor_;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = int;
+
+        const_iterator(const BasicFloorMask* mask, int floor) : mask_(mask), floor_(floor) {}
+        int operator*() const { return floor_; }
+        const_iterator& operator++() {
+            floor_ = mask_->nextAbove(floor_);
+            return *this;
+        }
+        bool operator==(const const_iterator& other) const { return floor_ == other.floor_; }
+        bool operator!=(const const_iterator& other) const { return floor_ != other.floor_; }
+    };
+
+    const_iterator begin() const { return const_iterator(this, lowest()); }
+    const_iterator end() const { return const_iterator(this, -1); }
+
+    // Raw word access (serialization, snapshots)
+    const std::array<std::uint64_t, kWords>& words() const { return words_; }
+    std::array<std::uint64_t, kWords>& words() { return words_; }
+};
+
+using FloorMask = BasicFloorMask<4>;  // Floors 1..255 (kMaxFloors)
+
+// Smallest mask holding floors 1..Floors
+template <int Floors>
+using FloorMaskFor = BasicFloorMask<Floors / 64 + 1>;
+
+// ============== Atomic Floor Mask ==============
+// FloorMask shared between threads without a lock: bits are set and
+// cleared with atomic word RMWs. load() reads word by word, so it is a
+// consistent snapshot only of each 64-floor word, not of the whole mask.
+
+class AtomicFloorMask {
+private:
+    std::array<std::atomic<std::uint64_t>, FloorMask::kWords> words_{};
+
+    static bool inRange(int floor) { return floor >= 0 && floor < FloorMask::kBits; }
+
+public:
+    void set(int floor) {
+        if (inRange(floor)) words_[floor >> 6].fetch_or(std::uint64_t{1} << (floor & 63));
+    }
+    void reset(int floor) {
+        if (inRange(floor)) words_[floor >> 6].fetch_and(~(std::uint64_t{1} << (floor & 63)));
+    }
+
+    void clear() {
+        for (auto& word : words_) word.store(0);
+    }
+
+    FloorMask load() const {
+        FloorMask mask;
+        for (int i = 0; i < FloorMask::kWords; ++i) mask.words()[i] = words_[i].load();
+        return mask;
+    }
+};
+
+#endif // FLOOR_MASK_HPP
@@ -0,0 +1,273 @@
+#ifndef LOCK_FREE_QUEUE_HPP
+#define LOCK_FREE_QUEUE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "Profiler.hpp"
+
+// ============== Lock-Free Backend ==============
+// Bounded ring buffer with per-slot sequence numbers (Vyukov style).
+// Producers (CLI, request threads, the tick loop) claim slots with a CAS
+// on tail_; the simulation thread is the intended single consumer. The
+// consumer side also claims with CAS so an extra consumer stays safe.
+// Same push/pushBatch/tryPop/pop/shutdown interface as LockingEventQueue,
+// and unbounded like it: a push that finds the ring full spills to a
+// mutex-guarded overflow instead of waiting, since in headless runs the
+// producer is the consumer. While anything is spilled every push spills,
+// and the overflow is only read once the ring is empty, so each
+// producer's events stay in order.
+
+template<typename T, size_t Capacity = 4096>
+class LockFreeEventQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+private:
+    static constexpr size_t kMask = Capacity - 1;
+    static constexpr size_t kCacheLine = 64;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    alignas(kCacheLine) std::atomic<size_t> tail_{0};  // Next slot to write
+    alignas(kCacheLine) std::atomic<size_t> head_{0};  // Next slot to read
+    alignas(kCacheLine) std::atomic<bool> shutdown_{false};
+    std::atomic<std::uint64_t> contended_{0};  // Lost tail CAS races
+    std::atomic<size_t> highWater_{0};         // Consumer side only
+    std::atomic<size_t> spilled_{0};           // overflow_.size()
+    std::mutex overflowMutex_;
+    std::deque<T> overflow_;
+
+    template<typename It>
+    void spill(It first, It last) {
+        std::lock_guard<std::mutex> lock(overflowMutex_);
+        overflow_.insert(overflow_.end(), first, last);
+        spilled_.store(overflow_.size(), std::memory_order_release);
+    }
+
+    // True once every claimed ring slot has been read. Checked under
+    // overflowMutex_: a producer's ring push before its spill then shows in
+    // tail_, so the overflow never overtakes it.
+    bool ringDrained() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    void countRace() {
+        if constexpr (kProfilingCompiled) {
+            contended_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Front of the overflow, once the ring has emptied
+    std::optional<T> popOverflow() {
+        if (spilled_.load(std::memory_order_acquire) == 0) {
+            return std::nullopt;
+        }
+        std::lock_guard<std::mutex> lock(overflowMutex_);
+        if (overflow_.empty() || !ringDrained()) {
+            return std::nullopt;
+        }
+        T event = std::move(overflow_.front());
+        overflow_.pop_front();
+        spilled_.store(overflow_.size(), std::memory_order_release);
+        return event;
+    }
+
+public:
+    LockFreeEventQueue() : cells_(new Cell[Capacity]) {
+        for (size_t i = 0; i < Capacity; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Non-copyable, non-movable
+    LockFreeEventQueue(const LockFreeEventQueue&) = delete;
+    LockFreeEventQueue& operator=(const LockFreeEventQueue&) = delete;
+
+    // Storage is the fixed ring, allocated up front
+    void reserve(size_t) {}
+
+    // Add event to queue; never blocks (a full ring spills to the overflow)
+    void push(T event) {
+        if (spilled_.load(std::memory_order_acquire) > 0) {
+            spill(std::make_move_iterator(&event), std::make_move_iterator(&event + 1));
+            return;
+        }
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & kMask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(event);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return;
+                }
+                countRace();
+            } else if (diff < 0) {
+                // Full
+                spill(std::make_move_iterator(&event), std::make_move_iterator(&event + 1));
+                return;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Add a run of events in order. Each chunk of free slots is claimed
+    // with one CAS on tail_ rather than one per event; a claimed slot may
+    // still be finishing a consumer's read, so each write waits for its
+    // sequence to come round. Whatever does not fit spills, as in push().
+    template<typename It>
+    void pushBatch(It first, It last) {
+        size_t remaining = static_cast<size_t>(std::distance(first, last));
+        while (remaining > 0) {
+            size_t pos = tail_.load(std::memory_order_relaxed);
+            size_t head = head_.load(std::memory_order_acquire);
+            size_t free = head + Capacity > pos ? head + Capacity - pos : 0;
+            if (free == 0 || spilled_.load(std::memory_order_acquire) > 0) {
+                spill(first, last);
+                return;
+            }
+
+            size_t chunk = std::min({remaining, free, Capacity});
+            if (!tail_.compare_exchange_weak(pos, pos + chunk, std::memory_order_relaxed)) {
+                countRace();
+                continue;
+            }
+            for (size_t i = 0; i < chunk; ++i, ++first) {
+                Cell& cell = cells_[(pos + i) & kMask];
+                while (cell.sequence.load(std::memory_order_acquire) != pos + i) {
+                    std::this_thread::yield();
+                }
+                cell.value = *first;
+                cell.sequence.store(pos + i + 1, std::memory_order_release);
+            }
+            remaining -= chunk;
+        }
+    }
+
+    // Wait and retrieve event (blocks until available or shutdown)
+    std::optional<T> pop() {
+        for (;;) {
+            if (auto event = tryPop()) {
+                return event;
+            }
+            if (shutdown_.load(std::memory_order_acquire)) {
+                return tryPop();  // Catch a push that raced with shutdown
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // Non-blocking try to retrieve
+    std::optional<T> tryPop() {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & kMask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    T event = std::move(cell.value);
+                    cell.sequence.store(pos + Capacity, std::memory_order_release);
+                    return event;
+                }
+            } else if (diff < 0) {
+                return popOverflow();  // Ring empty
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Move every event published so far into `out`, then the overflow if
+    // the ring emptied. Events pushed while draining are left for the next
+    // call. Returns the number appended.
+    size_t drain(std::vector<T>& out) {
+        size_t limit = tail_.load(std::memory_order_acquire);
+        if constexpr (kProfilingCompiled) {
+            size_t head = head_.load(std::memory_order_relaxed);
+            size_t depth = limit > head ? limit - head : 0;
+            if (depth > highWater_.load(std::memory_order_relaxed)) {
+                highWater_.store(depth, std::memory_order_relaxed);
+            }
+        }
+        size_t count = 0;
+        while (head_.load(std::memory_order_relaxed) < limit) {
+            auto event = tryPop();
+            if (!event) break;  // Slot claimed but not yet written
+            out.push_back(std::move(*event));
+            ++count;
+        }
+        if (spilled_.load(std::memory_order_acquire) > 0) {
+            std::lock_guard<std::mutex> lock(overflowMutex_);
+            if (ringDrained()) {
+                count += overflow_.size();
+                std::move(overflow_.begin(), overflow_.end(), std::back_inserter(out));
+                overflow_.clear();
+                spilled_.store(0, std::memory_order_release);
+            }
+        }
+        return count;
+    }
+
+    // Signal shutdown - unblocks waiting threads
+    void shutdown() {
+        shutdown_.store(true, std::memory_order_release);
+    }
+
+    // Reset shutdown flag (for reuse)
+    void reset() {
+        while (tryPop()) {
+        }
+        {
+            std::lock_guard<std::mutex> lock(overflowMutex_);
+            overflow_.clear();
+            spilled_.store(0, std::memory_order_release);
+        }
+        shutdown_.store(false, std::memory_order_release);
+    }
+
+    // Check if empty (approximate while producers are active)
+    bool empty() const {
+        return size() == 0;
+    }
+
+    // Get current size (approximate while producers are active)
+    size_t size() const {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        return (tail > head ? tail - head : 0) + spilled_.load(std::memory_order_acquire);
+    }
+
+    // Check if shutdown was requested
+    bool isShutdown() const {
+        return shutdown_.load(std::memory_order_acquire);
+    }
+
+    // Lost CAS races and deepest drain (zero when profiling is compiled out)
+    QueueCounters counters() const {
+        return {contended_.load(std::memory_order_relaxed),
+                highWater_.load(std::memory_order_relaxed)};
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+};
+
+#endif // LOCK_FREE_QUEUE_HPP
@@ -0,0 +1,265 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+// ============== Latency Histogram ==============
+// Fixed-bucket histogram of durations in ticks. One bucket per tick up to
+// kBuckets-1; longer samples land in the last bucket (max stays exact).
+// Fixed size and plain counters, so per-run histograms merge by addition.
+
+class LatencyHistogram {
+public:
+    static constexpr int kBuckets = 2048;
+
+private:
+    std::array<std::uint64_t, kBuckets> buckets_{};
+    std::uint64_t count_ = 0;
+    std::uint64_t sum_ = 0;
+    int max_ = 0;
+
+public:
+    void record(int ticks) {
+        if (ticks < 0) ticks = 0;
+        ++buckets_[std::min(ticks, kBuckets - 1)];
+        ++count_;
+        sum_ += static_cast<std::uint64_t>(ticks);
+        max_ = std::max(max_, ticks);
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (int i = 0; i < kBuckets; ++i) buckets_[i] += other.buckets_[i];
+        count_ += other.count_;
+        sum_ += other.sum_;
+        max_ = std::max(max_, other.max_);
+    }
+
+    void clear() { *this = LatencyHistogram(); }
+
+    std::uint64_t count() const { return count_; }
+    int max() const { return max_; }
+    double mean() const {
+        return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0;
+    }
+
+    // Smallest tick value with at least p (0..1) of the samples at or below it
+    int percentile(double p) const {
+        if (count_ == 0) return 0;
+        p = std::clamp(p, 0.0, 1.0);
+        auto rank = static_cast<std::uint64_t>(std::ceil(p * static_cast<double>(count_)));
+        if (rank == 0) rank = 1;
+        std::uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; ++i) {
+            seen += buckets_[i];
+            if (seen >= rank) return i == kBuckets - 1 ? max_ : i;
+        }
+        return max_;
+    }
+
+    bool operator==(const LatencyHistogram& other) const {
+        return count_ == other.count_ && sum_ == other.sum_ && max_ == other.max_ &&
+               buckets_ == other.buckets_;
+    }
+};
+
+// ============== Call Metrics ==============
+// Wait = hall call registered until a car serves that floor/direction.
+// Travel = car call registered until the car serves that floor.
+
+struct CallMetrics {
+    LatencyHistogram waitTicks;
+    LatencyHistogram travelTicks;
+    long long floorsTraveled = 0;   // Car-floors moved, summed over all cars
+    long long trips = 0;            // Runs from rest to rest
+    double energyDrawn = 0.0;       // J, MotionModel::Kinematic only
+    double energyRegenerated = 0.0; // J fed back
+
+    void merge(const CallMetrics& other) {
+        waitTicks.merge(other.waitTicks);
+        travelTicks.merge(other.travelTicks);
+        floorsTraveled += other.floorsTraveled;
+        trips += other.trips;
+        energyDrawn += other.energyDrawn;
+        energyRegenerated += other.energyRegenerated;
+    }
+
+    void clear() {
+        waitTicks.clear();
+        travelTicks.clear();
+        floorsTraveled = 0;
+        trips = 0;
+        energyDrawn = 0.0;
+        energyRegenerated = 0.0;
+    }
+};
+
+// ============== HDR Histogram ==============
+// Log-linear buckets (HdrHistogram layout, 5 sub-bucket bits): exact below
+// 64, then 32 buckets per power of two, so any recorded value is within
+// ~3% of its bucket's lower bound. Counters are relaxed atomics written by
+// a single thread (the owning engine's simulation thread) with plain
+// load/store - no lock prefix, no contention - while other threads read
+// them for status. Combine across threads with merge().
+
+class HdrHistogram {
+public:
+    static constexpr int kSubBits = 5;
+    static constexpr int kSubCount = 1 << kSubBits;                // 32
+    static constexpr int kBuckets = (31 - kSubBits + 1) * kSubCount + kSubCount;
+
+private:
+    std::array<std::atomic<std::uint64_t>, kBuckets> buckets_{};
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<int> max_{0};
+
+    static void bump(std::atomic<std::uint64_t>& counter, std::uint64_t by) {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+public:
+    static int bucketOf(int value) {
+        if (value < 2 * kSubCount) return value < 0 ? 0 : value;
+        int shift = (31 - __builtin_clz(static_cast<unsigned>(value))) - kSubBits;
+        return kSubCount * shift + (value >> shift);
+    }
+
+    static int lowestValueOf(int bucket) {
+        if (bucket < 2 * kSubCount) return bucket;
+        int shift = bucket / kSubCount - 1;
+        return (bucket - kSubCount * shift) << shift;
+    }
+
+    HdrHistogram() = default;
+
+    HdrHistogram(const HdrHistogram& other) { merge(other); }
+
+    HdrHistogram& operator=(const HdrHistogram& other) {
+        if (this != &other) {
+            clear();
+            merge(other);
+        }
+        return *this;
+    }
+
+    // Single writer only
+    void record(int value) {
+        if (value < 0) value = 0;
+        bump(buckets_[bucketOf(value)], 1);
+        bump(count_, 1);
+        bump(sum_, static_cast<std::uint64_t>(value));
+        if (value > max_.load(std::memory_order_relaxed)) {
+            max_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    // Writer-side (or quiescent) combination of another histogram
+    void merge(const HdrHistogram& other) {
+        for (int i = 0; i < kBuckets; ++i) {
+            bump(buckets_[i], other.buckets_[i].load(std::memory_order_relaxed));
+        }
+        bump(count_, other.count_.load(std::memory_order_relaxed));
+        bump(sum_, other.sum_.load(std::memory_order_relaxed));
+        int otherMax = other.max_.load(std::memory_order_relaxed);
+        if (otherMax > max_.load(std::memory_order_relaxed)) {
+            max_.store(otherMax, std::memory_order_relaxed);
+        }
+    }
+
+    void clear() {
+        for (auto& bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    std::uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    std::uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+    int max() const { return max_.load(std::memory_order_relaxed); }
+    double mean() const {
+        std::uint64_t n = count();
+        return n ? static_cast<double>(sum_.load(std::memory_order_relaxed)) /
+                   static_cast<double>(n) : 0.0;
+    }
+
+    // Lower bound of the bucket holding the p-th (0..1) sample, capped at max
+    int percentile(double p) const {
+        std::uint64_t n = count();
+        if (n == 0) return 0;
+        p = std::clamp(p, 0.0, 1.0);
+        auto rank = static_cast<std::uint64_t>(std::ceil(p * static_cast<double>(n)));
+        if (rank == 0) rank = 1;
+        std::uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; ++i) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen >= rank) return std::min(lowestValueOf(i), max());
+        }
+        return max();
+    }
+
+    bool operator==(const HdrHistogram& other) const {
+        if (count() != other.count() || max() != other.max()) return false;
+        for (int i = 0; i < kBuckets; ++i) {
+            if (buckets_[i].load(std::memory_order_relaxed) !=
+                other.buckets_[i].load(std::memory_order_relaxed)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// ============== Passenger Metrics ==============
+// Wait = arrival at the floor until boarding. Journey = arrival until
+// alighting at the destination (door to door). Ride = boarding until
+// alighting. Same single-writer rule as HdrHistogram.
+
+struct PassengerMetrics {
+    HdrHistogram waitTicks;
+    HdrHistogram journeyTicks;
+    HdrHistogram rideTicks;
+    std::atomic<long long> spawned{0};
+    std::atomic<long long> delivered{0};
+    std::atomic<int> waiting{0};    // Currently at a floor
+    std::atomic<int> riding{0};     // Currently in a car
+
+    PassengerMetrics() = default;
+    PassengerMetrics(const PassengerMetrics& other) { merge(other); }
+    PassengerMetrics& operator=(const PassengerMetrics& other) {
+        if (this != &other) {
+            clear();
+            merge(other);
+        }
+        return *this;
+    }
+
+    void merge(const PassengerMetrics& other) {
+        waitTicks.merge(other.waitTicks);
+        journeyTicks.merge(other.journeyTicks);
+        rideTicks.merge(other.rideTicks);
+        auto add = [](auto& into, const auto& from) {
+            into.store(into.load(std::memory_order_relaxed) +
+                       from.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        };
+        add(spawned, other.spawned);
+        add(delivered, other.delivered);
+        add(waiting, other.waiting);
+        add(riding, other.riding);
+    }
+
+    void clear() {
+        waitTicks.clear();
+        journeyTicks.clear();
+        rideTicks.clear();
+        spawned.store(0, std::memory_order_relaxed);
+        delivered.store(0, std::memory_order_relaxed);
+        waiting.store(0, std::memory_order_relaxed);
+        riding.store(0, std::memory_order_relaxed);
+    }
+};
+
+#endif // METRICS_HPP
@@ -0,0 +1,76 @@
+#ifndef MOTION_HPP
+#define MOTION_HPP
+
+#include "Types.hpp"
+#include <algorithm>
+#include <vector>
+
+// ============== Trip Energy ==============
+
+struct TripEnergy {
+    double drawn = 0.0;        // J from the supply
+    double regenerated = 0.0;  // J fed back by the drive
+};
+
+// ============== Motion Profile ==============
+// Jerk-limited (S-curve) car runs: acceleration ramps at maxJerk up to
+// maxAccel and speed is capped at maxSpeed. A rest-to-rest run of n floors
+// takes runTime(n x floorHeight).
+//
+// The tick loop keeps its integer countdown: the profile is turned into
+// tables once, so a moving car still costs one decrement per tick. A car
+// does not know where its run ends, so floor k of a run takes the ticks
+// the free (never braking) profile needs from floor k-1 to floor k, and
+// stopping after n floors adds brakeTicks(n) before the doors open; the
+// whole run then takes runTime rounded to ticks. Express runs cruise at
+// maxSpeed, so they cost far fewer ticks per floor than one-floor hops.
+//
+// Energy is booked per trip when the car stops, in closed form: drawn =
+// (kinetic energy at peak speed + friction + any lift of the unbalanced
+// mass) / driveEfficiency; regenerated = (kinetic energy + any descent of
+// the unbalanced mass) x regenEfficiency. The unbalanced mass is car + load
+// - counterweight, so a full car going down and an empty one going up
+// both give energy back.
+//
+// With MotionModel::Fixed every floor takes floorTravelTicks, there is no
+// braking time and trips cost no energy.
+
+class MotionProfile {
+private:
+    bool kinematic_ = false;
+    int travelTicks_ = 1;
+    MotionParams params_;
+    std::vector<int> passTicks_;   // By floor of the run, 1..numFloors
+    std::vector<int> brakeTicks_;  // By run length, 0..numFloors
+    std::vector<double> runSpeed_; // Peak speed by run length, 0..numFloors
+
+    double accelTime(double speed) const;       // 0 -> speed, jerk-limited
+    double freeRunDistance(double time) const;  // From rest, never braking
+
+public:
+    MotionProfile() = default;
+    // Throws std::invalid_argument for non-positive dynamics or tick, or
+    // efficiencies outside (0, 1]
+    explicit MotionProfile(const Config& config);
+
+    bool isKinematic() const { return kinematic_; }
+
+    // Ticks to the next floor when it is floor `k` of the run (1 = first)
+    int passTicks(int k) const {
+        if (!kinematic_) return travelTicks_;
+        return passTicks_[std::clamp(k, 1, static_cast<int>(passTicks_.size()) - 1)];
+    }
+    // Ticks to brake and level after a run of `floors`
+    int brakeTicks(int floors) const {
+        if (!kinematic_) return 0;
+        return brakeTicks_[std::clamp(floors, 0, static_cast<int>(brakeTicks_.size()) - 1)];
+    }
+    TripEnergy tripEnergy(int floors, Direction dir, int passengers, int capacity) const;
+
+    // Kinematics in seconds and metres
+    double peakSpeed(double distance) const;    // Top speed of a rest-to-rest run
+    double runTime(double distance) const;      // Rest to rest
+    double freeRunTime(double distance) const;  // From rest, never braking
+};
+
+#endif // MOTION_HPP
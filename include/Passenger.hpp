@@ -0,0 +1,68 @@
+#ifndef PASSENGER_HPP
+#define PASSENGER_HPP
+
+#include "Types.hpp"
+#include "Domain.hpp"
+#include "Metrics.hpp"
+#include "Scheduler.hpp"
+#include <deque>
+#include <vector>
+
+// ============== Passenger ==============
+
+struct Passenger {
+    int id = -1;
+    int origin = 0;
+    int destination = 0;
+    int arrivalTick = 0;
+    int boardTick = -1;
+
+    Direction direction() const {
+        return destination > origin ? Direction::Up : Direction::Down;
+    }
+};
+
+// ============== Passenger Model ==============
+// Waiting queues per floor and direction, riders per car. Driven by the
+// simulation thread: spawn() when a passenger arrives, exchange() when a
+// car's doors open. Boarding is FIFO among the riders the scheduler
+// accepts and capped by carCapacity; anyone left behind calls again.
+
+class PassengerModel {
+private:
+    Building& building_;
+    std::vector<std::deque<Passenger>> waitingUp_;    // By floor
+    std::vector<std::deque<Passenger>> waitingDown_;  // By floor
+    std::vector<std::vector<Passenger>> riding_;      // By car
+    PassengerMetrics metrics_;
+    int nextId_ = 0;
+    std::vector<Passenger>* arrivals_ = nullptr;  // Not owned
+
+    std::deque<Passenger>& waiting(int floor, Direction dir);
+
+public:
+    explicit PassengerModel(Building& building);
+
+    // New passenger waiting at `origin`; returns its id (-1 if invalid)
+    int spawn(int origin, int destination, int tick);
+
+    // Doors of `car` opened at `floor`: riders for this floor alight, then
+    // waiting passengers board; boarders' destinations become car calls
+    void exchange(int car, int floor, int tick, IScheduler& scheduler);
+
+    // Append every passenger who alights to `log` (nullptr to stop)
+    void setArrivalLog(std::vector<Passenger>* log);
+
+    int getWaitingCount(int floor, Direction dir) const;
+    int getRidingCount(int car) const;
+
+    // Waiting queues, riders and the id counter. Restored metrics start
+    // empty apart from the waiting/riding gauges.
+    void saveState(SnapshotWriter& out) const;
+    void loadState(SnapshotReader& in);
+
+    // Safe to read from any thread (relaxed atomics)
+    const PassengerMetrics& getMetrics() const;
+};
+
+#endif // PASSENGER_HPP
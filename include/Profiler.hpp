@@ -0,0 +1,156 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include "Metrics.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+
+// ============== Build Switch ==============
+// ELEVATOR_PROFILING=0 (CMake -DELEVATOR_PROFILING=OFF) compiles every
+// timer, high-water mark and contention counter below to nothing. When
+// compiled in, tick timing still only runs with Config::profiling.
+
+#ifndef ELEVATOR_PROFILING
+#define ELEVATOR_PROFILING 1
+#endif
+
+constexpr bool kProfilingCompiled = ELEVATOR_PROFILING != 0;
+
+// ============== Contention Counters ==============
+// Drop-in std::mutex that counts lock() calls which found it held. The
+// uncontended path is one try_lock; compiled out it is a plain std::mutex.
+
+#if ELEVATOR_PROFILING
+class ProfiledMutex {
+private:
+    std::mutex mutex_;
+    std::atomic<std::uint64_t> contended_{0};
+
+public:
+    void lock() {
+        if (!mutex_.try_lock()) {
+            contended_.fetch_add(1, std::memory_order_relaxed);
+            mutex_.lock();
+        }
+    }
+    bool try_lock() { return mutex_.try_lock(); }
+    void unlock() { mutex_.unlock(); }
+
+    std::uint64_t contended() const { return contended_.load(std::memory_order_relaxed); }
+};
+#else
+class ProfiledMutex : public std::mutex {
+public:
+    std::uint64_t contended() const { return 0; }
+};
+#endif
+
+// Queue-side counters, kept by both EventQueue backends
+struct QueueCounters {
+    std::uint64_t contended = 0;  // Lock waits (locking) / lost CAS races (lock-free)
+    std::size_t highWater = 0;    // Deepest backlog seen by drain()
+};
+
+// Everything a report needs besides the profiler's own histograms
+struct ProfileCounters {
+    QueueCounters queue;
+    std::uint64_t buildingContended = 0;   // Building hall-call / metrics lock
+    std::uint64_t schedulerContended = 0;  // Controller call-table lock
+    long long eventsProcessed = 0;
+    int tick = 0;
+};
+
+// ============== Tick Profiler ==============
+// Wall time of each phase of a tick in nanoseconds, one sample per phase
+// per tick, plus events processed per tick. Written by the simulation
+// thread only (HdrHistogram single-writer rule), readable from any thread
+// for the `stats` command.
+
+enum class TickPhase : int {
+    Cars,       // updateElevators (all of a parallel tick)
+    Scheduler,  // scheduler_->tick()
+    Drain,      // Moving queued events out of the EventQueue
+    Dispatch,   // processEvent / hall-call runs
+    Publish,    // Fleet snapshot for status readers
+    Count
+};
+
+constexpr int kTickPhases = static_cast<int>(TickPhase::Count);
+const char* tickPhaseName(TickPhase phase);
+
+class TickProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Time of the last phase boundary (empty when compiled out)
+    struct Stamp {
+#if ELEVATOR_PROFILING
+        Clock::time_point at{};
+#endif
+    };
+
+private:
+    bool enabled_ = false;
+    std::array<HdrHistogram, kTickPhases> phaseNs_;
+    HdrHistogram tickNs_;
+    HdrHistogram eventsPerTick_;
+    std::atomic<long long> skippedTicks_{0};    // Jumped by next-event advance
+    std::array<std::int64_t, kTickPhases> pending_{};  // This tick so far
+
+public:
+    void setEnabled(bool enabled) { enabled_ = enabled; }
+    bool isEnabled() const { return kProfilingCompiled && enabled_; }
+
+    Stamp start() const {
+        Stamp stamp;
+#if ELEVATOR_PROFILING
+        if (enabled_) stamp.at = Clock::now();
+#endif
+        return stamp;
+    }
+
+    // Charge the time since `stamp` to `phase` and move the stamp to now
+    void lap(TickPhase phase, Stamp& stamp) {
+#if ELEVATOR_PROFILING
+        if (!enabled_) return;
+        Clock::time_point now = Clock::now();
+        pending_[static_cast<int>(phase)] += (now - stamp.at).count();
+        stamp.at = now;
+#else
+        (void)phase;
+        (void)stamp;
+#endif
+    }
+
+    // Close the tick begun at `begin`: one sample per phase and for the total
+    void endTick(const Stamp& begin, long long events);
+
+    void addSkippedTicks(int ticks) {
+        if constexpr (kProfilingCompiled) {
+            if (!enabled_) return;
+            skippedTicks_.store(skippedTicks_.load(std::memory_order_relaxed) + ticks,
+                                std::memory_order_relaxed);
+        } else {
+            (void)ticks;
+        }
+    }
+
+    const HdrHistogram& getPhase(TickPhase phase) const {
+        return phaseNs_[static_cast<int>(phase)];
+    }
+    const HdrHistogram& getTickTimes() const { return tickNs_; }
+    const HdrHistogram& getEventsPerTick() const { return eventsPerTick_; }
+    long long getSkippedTicks() const { return skippedTicks_.load(std::memory_order_relaxed); }
+
+    // Human-readable table (the `stats` command)
+    void printReport(std::ostream& out, const ProfileCounters& counters) const;
+    // Prometheus text exposition format
+    void writePrometheus(std::ostream& out, const ProfileCounters& counters) const;
+};
+
+#endif // PROFILER_HPP
@@ -4,12 +4,21 @@
 #include "Types.hpp"
 #include "Domain.hpp"
 #include "EventQueue.hpp"
-#include <map>
+#include "Assignment.hpp"
+#include "EtaTable.hpp"
+#include <algorithm>
+#include <atomic>
+#include <vector>
 #include <mutex>
 #include <memory>
+#include <utility>
 
 // ============== Scheduler Interface ==============
 
+// A moving car's answer for the floor it is reaching. Bid: stop only if
+// the car wins the open call there (see IScheduler::bidStopAt)
+enum class StopDecision { Pass, Stop, Bid };
+
 class IScheduler {
 public:
     virtual ~IScheduler() = default;
@@ -18,6 +27,27 @@ public:
     virtual void handleHallCall(int floor, Direction dir) = 0;
     virtual void handleCarCall(int elevatorId, int floor) = 0;
 
+    // Destination keypad: someone at `origin` wants `destination`. Plain
+    // hall-button schedulers only see the direction.
+    virtual void handleDestinationCall(int origin, int destination) {
+        if (origin != destination) {
+            handleHallCall(origin, destination > origin ? Direction::Up : Direction::Down);
+        }
+    }
+
+    // The same call from a simulated rider, who presses its own car call
+    // on boarding (default: as a keypad entry)
+    virtual void handlePassengerCall(int origin, int destination) {
+        handleDestinationCall(origin, destination);
+    }
+
+    // A burst of hall calls at once (default: one at a time)
+    virtual void handleHallCalls(const std::vector<std::pair<int, Direction>>& calls) {
+        for (const auto& [floor, dir] : calls) {
+            handleHallCall(floor, dir);
+        }
+    }
+
     // Elevator state change notifications
     virtual void onElevatorArrived(int elevatorId, int floor) = 0;
     virtual void onDoorsOpened(int elevatorId, int floor) = 0;
@@ -26,10 +56,95 @@ public:
     // Called each simulation tick
     virtual void tick() = 0;
 
+    // A moving car is reaching `floor`: stop there, or pass through?
+    virtual bool shouldStopAt(int elevatorId, int floor) {
+        (void)elevatorId;
+        (void)floor;
+        return true;
+    }
+
+    // May a passenger for `destination` board `elevatorId` at `origin`?
+    // (Destination dispatch sends riders to their allocated car only.)
+    virtual bool acceptsPassenger(int elevatorId, int origin, int destination) {
+        (void)elevatorId;
+        (void)origin;
+        (void)destination;
+        return true;
+    }
+
+    // ---- Next-event time advance (Config::timeAdvance) ----
+    // Number of upcoming ticks in which tick() is certain to change
+    // nothing, provided no call arrives and no car finishes a timed
+    // operation meanwhile (0: unknown, run every tick). The engine jumps
+    // over such ticks and reports them to skipTicks() so that per-tick
+    // counters stay in step.
+    virtual int quietTicks() { return 0; }
+    virtual void skipTicks(int ticks) { (void)ticks; }
+
+    // ---- Per-car workers (Config::carWorkers) ----
+    // A scheduler whose per-car logic may run for every car at once. The
+    // engine then runs each tick as phases over all cars on a worker pool,
+    // with a barrier after each phase; within a phase a car writes only its
+    // own state. Cars never race for a call: they bid, and after the
+    // barrier the lowest bidding car id wins, so the run does not depend on
+    // thread timing or the worker count. It is not the serial schedule,
+    // though: an outbid car waits for the next tick instead of claiming its
+    // next choice at once, so phased and serial runs can differ.
+    virtual bool supportsCarWorkers() const { return false; }
+
+    // Phase 1: shouldStopAt, but a stop that needs a new claim is a bid
+    virtual StopDecision bidStopAt(int elevatorId, int floor) {
+        return shouldStopAt(elevatorId, floor) ? StopDecision::Stop : StopDecision::Pass;
+    }
+    // Phase 2, after bidStopAt returned Bid: true if the car won the call
+    virtual bool resolveStopAt(int elevatorId, int floor) {
+        (void)elevatorId;
+        (void)floor;
+        return false;
+    }
+    // Phases 3 and 4: one car's share of tick(), split at its claim bid
+    virtual void bidCarTick(int elevatorId) { (void)elevatorId; }
+    virtual void resolveCarTick(int elevatorId) { (void)elevatorId; }
+
+    // ---- Snapshots (SimulationEngine::saveSnapshot) ----
+    // The scheduler's own tables at a tick boundary. The building is
+    // restored first, so loadState may check against it.
+    virtual void saveState(SnapshotWriter& out) const { (void)out; }
+    virtual void loadState(SnapshotReader& in) { (void)in; }
+
+    // Times the scheduler's own lock had to wait (profiling builds)
+    virtual std::uint64_t getLockContention() const { return 0; }
+
     // Get scheduler name for logging
     virtual std::string getName() const = 0;
 };
 
+// ============== Dispatch Policy Helpers ==============
+
+// Any destination strictly beyond `floor` in direction `dir`
+inline bool anyAhead(const FloorMask& destinations, int floor, Direction dir) {
+    return dir == Direction::Up ? destinations.anyAbove(floor)
+         : dir == Direction::Down ? destinations.anyBelow(floor)
+         : false;
+}
+
+// One extra stop (a door cycle) expressed in floors of travel, the unit
+// costToServe() works in
+inline int stopCostFloors(const Config& config) {
+    return std::max(1, (config.doorOpenTicks + 2) / std::max(1, config.floorTravelTicks));
+}
+
+// Next floor for an idle car. NearestFirst: closest destination.
+// Collective: keep `sweep` direction while destinations remain ahead
+// (current floor first), else reverse.
+int pickTarget(DispatchPolicy policy, int current, Direction sweep,
+               const FloorMask& destinations);
+
+// Direction a car leaves its floor in for `stops` (EtaTable heading):
+// its travel direction while moving, else towards pickTarget's choice
+Direction headingOf(const Config& config, const FleetState& fleet, int car,
+                    Direction sweep, const FloorMask& stops);
+
 // ============== Master Controller ==============
 // Centralized scheduler - makes all assignment decisions
 
@@ -38,39 +153,77 @@ private:
     Building& building_;
     EventQueue<Event>& eventQueue_;
 
-    // Assignment tracking: (floor, direction) -> assigned elevator ID
-    std::map<std::pair<int, Direction>, int> assignments_;
-    mutable std::mutex mutex_;
+    // Assignment tracking: hallCallSlot(floor, direction) -> elevator ID (-1 if none)
+    std::vector<int> assignments_;
+    // Per-elevator masks of assigned hall calls, so dispatch never scans
+    std::vector<FloorMask> assignedUp_;
+    std::vector<FloorMask> assignedDown_;
+    std::vector<Direction> sweep_;  // Last travel direction per car (kept across idle)
+    mutable ProfiledMutex mutex_;
+    EtaTable eta_;                  // CostModel::Eta rows (under mutex_)
+
+    // Periodic re-optimisation (buffers reused across passes)
+    AssignmentSolver solver_;
+    std::vector<int> outstanding_;  // Hall-call slots in the current pass
+    int ticksSinceReassign_ = 0;
+    long long reassignments_ = 0;
 
 public:
     MasterController(Building& building, EventQueue<Event>& queue);
 
     void handleHallCall(int floor, Direction dir) override;
+    // Assigns every call under one lock, then dispatches each chosen car once
+    void handleHallCalls(const std::vector<std::pair<int, Direction>>& calls) override;
     void handleCarCall(int elevatorId, int floor) override;
     void onElevatorArrived(int elevatorId, int floor) override;
     void onDoorsOpened(int elevatorId, int floor) override;
     void onDoorsClosed(int elevatorId) override;
     void tick() override;
+    int quietTicks() override;
+    void skipTicks(int ticks) override;
+    bool shouldStopAt(int elevatorId, int floor) override;
+    void saveState(SnapshotWriter& out) const override;
+    void loadState(SnapshotReader& in) override;
+    std::uint64_t getLockContention() const override { return mutex_.contended(); }
     std::string getName() const override { return "MasterController"; }
 
-private:
-    // Find best elevator for a hall call
+    // Find best elevator for a hall call. CostModel::Distance: a CostIndex
+    // lookup, same choice as costing every car. CostModel::Eta: lowest
+    // EtaTable arrival over every car, refreshing only rows whose car or
+    // stops changed. (Caller holds mutex_; benchmarks call it directly.)
     int selectElevator(int floor, Direction dir);
 
-    // Calculate cost for elevator to serve a request
-    int calculateCost(const Elevator& elev, int floor, Direction dir);
+    // Min-cost matching of every outstanding hall call to the fleet (each
+    // car may take several calls, each extra one costing a stop). Calls
+    // move when the new car is cheaper by at least reassignMinGain.
+    // Always costs with costToServe: the matching adds its own stop costs.
+    // Runs from tick() every reassignPeriod ticks; returns calls moved.
+    int reassignCalls();
+    long long getReassignments() const;
+
+private:
+    // Register and assign one call (caller holds mutex_); returns the car
+    // to dispatch, or -1 if the call was already assigned
+    int assignHallCall(int floor, Direction dir);
 
     // Determine and dispatch next action for an elevator
     void dispatchElevator(int elevatorId);
 
-    // Check if elevator should stop at current floor
-    bool shouldStopAtFloor(int elevatorId, int floor);
+    // Car calls plus (unless full with riders aboard) assigned hall calls
+    FloorMask destinationsOf(int elevatorId);
+    FloorMask stopsOf(int elevatorId) const;  // Same, caller holds mutex_
+
+    // Clear car call and this elevator's hall calls at its current floor
+    void serveFloor(int elevatorId, int floor);
 
     // Get assignment for a floor/direction
     std::optional<int> getAssignment(int floor, Direction dir);
 
     // Clear assignment when served
     void clearAssignment(int floor, Direction dir);
+
+    // Record an assignment (caller holds mutex_)
+    void assign(int floor, Direction dir, int elevatorId);
 };
 
 // ============== Distributed Controller ==============
@@ -81,9 +234,39 @@ private:
     Building& building_;
     EventQueue<Event>& eventQueue_;
 
-    // Claim board: (floor, direction) -> claiming elevator ID (-1 if unclaimed)
-    std::map<std::pair<int, Direction>, int> claimBoard_;
-    mutable std::mutex mutex_;
+    static constexpr int kNotPosted = -2;
+    static constexpr int kUnclaimed = -1;
+
+    // Claim board: hallCallSlot(floor, direction) -> claiming elevator ID,
+    // kUnclaimed if posted but free, kNotPosted if there is no call. Claims
+    // are taken by CAS kUnclaimed -> id, so cars can claim on their own
+    // threads with no shared lock. All board and mask operations are
+    // seq_cst: the masks below are kept consistent with the board by
+    // updating them before the CAS that publishes the change.
+    std::vector<std::atomic<int>> claimBoard_;
+    // Posted-but-unclaimed calls, so claiming is a nearest-bit lookup. A hint:
+    // a set bit can already be claimed, the board decides
+    AtomicFloorMask openUp_;
+    AtomicFloorMask openDown_;
+    // Per-elevator masks of claimed floors (written by the claiming car and
+    // by releaseClaim)
+    std::vector<AtomicFloorMask> claimedUp_;
+    std::vector<AtomicFloorMask> claimedDown_;
+    std::vector<Direction> sweep_;  // Last travel direction per car (kept across idle)
+
+    // Per-car workers: lowest bidding car id by slot (kNoBid if none), and
+    // each car's outstanding bid (floor -1 if none)
+    static constexpr int kNoBid = kMaxElevators;
+    std::vector<std::atomic<int>> bids_;
+    std::vector<int> bidFloor_;
+    std::vector<Direction> bidDir_;
+
+    EtaTable eta_;  // CostModel::Eta rows; a per-car worker updates only its car's
+
+    AtomicFloorMask& openMask(Direction dir) { return dir == Direction::Up ? openUp_ : openDown_; }
+    AtomicFloorMask& claimedMask(int elevatorId, Direction dir) {
+        return (dir == Direction::Up ? claimedUp_ : claimedDown_)[elevatorId];
+    }
 
 public:
     DistributedController(Building& building, EventQueue<Event>& queue);
@@ -94,10 +277,27 @@ public:
     void onDoorsOpened(int elevatorId, int floor) override;
     void onDoorsClosed(int elevatorId) override;
     void tick() override;
+    int quietTicks() override;
+    bool shouldStopAt(int elevatorId, int floor) override;
+    void saveState(SnapshotWriter& out) const override;
+    void loadState(SnapshotReader& in) override;
     std::string getName() const override { return "DistributedController"; }
 
-private:
-    // Each elevator tries to claim unclaimed calls
+    bool supportsCarWorkers() const override { return true; }
+    StopDecision bidStopAt(int elevatorId, int floor) override;
+    bool resolveStopAt(int elevatorId, int floor) override;
+    void bidCarTick(int elevatorId) override;
+    void resolveCarTick(int elevatorId) override;
+
+    // ---- Claim board protocol (per-car logic and benchmarks call these) ----
+
+    // Post a call on the board only (handleHallCall also registers it in
+    // the building); false if it was already posted
+    bool postCall(int floor, Direction dir);
+
+    // Each elevator tries to claim unclaimed calls: the nearest one, or
+    // with CostModel::Eta the one it reaches soonest. Per-car workers
+    // (bidCarTick) bid by the same cost.
     void tryClaimCalls(int elevatorId);
 
     // Claim a specific hall call for an elevator
@@ -109,13 +309,119 @@ private:
     // Check if this elevator has the claim
     bool hasClaim(int elevatorId, int floor, Direction dir);
 
-    // Get all claims for an elevator
-    std::vector<std::pair<int, Direction>> getClaimsFor(int elevatorId);
+    // Get all floors this elevator holds claims on
+    FloorMask getClaimedFloors(int elevatorId);
+
+private:
+    // Claim-free part of shouldStopAt: Bid means stop only with a new claim
+    // on (floor, direction of travel)
+    StopDecision stopDecision(int elevatorId, int floor);
+
+    // Idle, or busy without car calls, and not full
+    bool maySeekCalls(int elevatorId) const;
+
+    // Nearest set call to `current` over both masks; false if none
+    static bool nearestCall(int current, const FloorMask& up, const FloorMask& down,
+                            int& floor, Direction& dir);
+    // Set call this car reaches soonest per its (fresh) EtaTable row
+    bool soonestCall(const FleetState& fleet, int elevatorId, const FloorMask& up,
+                     const FloorMask& down, int& floor, Direction& dir) const;
+
+    // Bid for an open call / claim it if this car's bid won
+    void placeBid(int elevatorId, int floor, Direction dir);
+    bool resolveBid(int elevatorId);
+
+    // Clear car call and this elevator's claims at its current floor
+    void serveFloor(int elevatorId, int floor);
+
+    // Car calls plus (unless full with riders aboard) claimed floors
+    FloorMask destinationsOf(int elevatorId);
 
     // Determine next action for an elevator (distributed decision)
     void decideNextAction(int elevatorId);
 };
 
+// ============== Destination Controller ==============
+// Destination dispatch: every call arrives with its target floor, and the
+// controller allocates it to a car up front. Allocation groups riders by
+// destination zone: a car that already stops at the caller's floor, or
+// already serves the zone they are heading for, is charged less, so cars
+// fill up with riders for a few adjacent floors instead of stopping
+// everywhere. Cars run collective sweeps; at a pickup only the riders
+// allocated to that car board it. Keypad destinations become car calls
+// there; simulated riders press their own as they board, so a car that
+// was full leaves no empty stops behind.
+
+class DestinationController : public IScheduler {
+private:
+    struct Allocation {
+        int car;
+        FloorMask destinations;   // Empty for a plain hall-button call
+        FloorMask keyed;          // Of those, keypad entries with no rider to press them
+        int requests;             // Calls merged into this pickup
+    };
+
+    Building& building_;
+    EventQueue<Event>& eventQueue_;
+    int zoneSize_;
+
+    // By hallCallSlot(origin, direction): allocations not yet picked up
+    std::vector<std::vector<Allocation>> pending_;
+    // Per car: origins still to visit, planned destinations, riders promised
+    std::vector<FloorMask> pickupUp_;
+    std::vector<FloorMask> pickupDown_;
+    std::vector<FloorMask> planned_;
+    std::vector<int> promised_;
+    std::vector<Direction> sweep_;
+    // Per car: the floor of its latest stop (-1 if it picked up nobody)
+    // and the destinations allocated to it there; only those riders board
+    std::vector<int> boardingFloor_;
+    std::vector<FloorMask> boardingTo_;
+    mutable ProfiledMutex mutex_;
+
+public:
+    DestinationController(Building& building, EventQueue<Event>& queue);
+
+    void handleHallCall(int floor, Direction dir) override;
+    void handleDestinationCall(int origin, int destination) override;
+    void handlePassengerCall(int origin, int destination) override;
+    void handleCarCall(int elevatorId, int floor) override;
+    void onElevatorArrived(int elevatorId, int floor) override;
+    void onDoorsOpened(int elevatorId, int floor) override;
+    void onDoorsClosed(int elevatorId) override;
+    void tick() override;
+    int quietTicks() override;
+    bool shouldStopAt(int elevatorId, int floor) override;
+    bool acceptsPassenger(int elevatorId, int origin, int destination) override;
+    void saveState(SnapshotWriter& out) const override;
+    void loadState(SnapshotReader& in) override;
+    std::uint64_t getLockContention() const override { return mutex_.contended(); }
+    std::string getName() const override { return "DestinationController"; }
+
+    // Car the call (origin -> destination) is allocated to, -1 if none
+    int getAllocation(int origin, int destination) const;
+    int getZone(int floor) const;
+
+private:
+    // Cheapest car for a rider at `origin` bound for `destination` (-1 for
+    // a plain hall call); caller holds mutex_
+    int selectCar(int origin, Direction dir, int destination) const;
+
+    // Record an allocation (caller holds mutex_); returns the car
+    int allocate(int origin, Direction dir, int destination, bool keyed);
+    void allocateTrip(int origin, int destination, bool keyed);
+
+    // Take the car's pickups at (floor, dir): keypad destinations become
+    // car calls, riders allocated there may board
+    void servePickup(int elevatorId, int floor, Direction dir);
+    // Forget the last stop's riders before a new stop
+    void endStop(int elevatorId);
+
+    FloorMask destinationsOf(int elevatorId);
+    FloorMask& pickups(int elevatorId, Direction dir);
+    void dispatch(int elevatorId);
+};
+
 // ============== Factory ==============
 
 std::unique_ptr<IScheduler> createScheduler(
@@ -0,0 +1,125 @@
+#ifndef SHARED_STATE_HPP
+#define SHARED_STATE_HPP
+
+#include "FleetState.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ============== Shared-Memory Layout ==============
+// Fleet and hall-call state exported into a POSIX shared-memory object, for
+// dashboards and digital twins in other processes. Layout version 1, native
+// (little-endian) byte order, 64-bit words throughout:
+//
+//   Header, 64 bytes
+//     0  u32 magic "ELSS"         20  u32 carBytes (per-car record stride)
+//     4  u16 version              24  u64 totalBytes
+//     6  u16 headerBytes          32  u64 sequence (seqlock)
+//     8  u32 numFloors            40  u64 tick
+//    12  u32 numCars              48  16 bytes reserved (zero)
+//    16  u32 maskWords
+//   headerBytes: up-call mask, then down-call mask, maskWords u64 each
+//     (bit f of the mask is floor f)
+//   Then numCars records of carBytes: int16 floor, u8 direction, u8 state,
+//     int32 ticksRemaining, int32 passengers, int32 capacity, then the
+//     car-call mask (maskWords u64). Direction and state are the Types.hpp
+//     enum values.
+//
+// Publishing makes `sequence` odd, writes tick, masks and cars, then makes
+// it even. A reader loads `sequence` (acquire), skips if odd, copies, then
+// reloads it after an acquire fence: equal means the copy is one tick.
+// `magic` is stored last, so a reader that finds it zero is early.
+
+constexpr std::uint32_t kSharedStateMagic = 0x53534C45;  // "ELSS" in memory
+constexpr std::uint16_t kSharedStateVersion = 1;
+
+struct SharedStateHeader {
+    std::atomic<std::uint32_t> magic;
+    std::uint16_t version;
+    std::uint16_t headerBytes;
+    std::uint32_t numFloors;
+    std::uint32_t numCars;
+    std::uint32_t maskWords;
+    std::uint32_t carBytes;
+    std::uint64_t totalBytes;
+    std::atomic<std::uint64_t> sequence;
+    std::atomic<std::uint64_t> tick;
+    std::uint64_t reserved[2];
+};
+static_assert(sizeof(SharedStateHeader) == 64, "Shared-memory header layout changed");
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free &&
+              std::atomic<std::uint64_t>::is_always_lock_free,
+              "Shared-memory seqlock needs address-free atomics");
+
+// ============== Shared State Writer ==============
+// Owns the object: created on construction, unlinked on destruction (readers
+// still mapping it keep the last state). Publishing is a handful of relaxed
+// stores per car with no syscall, from the simulation thread only.
+
+class SharedStateWriter {
+private:
+    std::string name_;
+    void* data_ = nullptr;
+    std::size_t bytes_ = 0;
+    int numCars_;
+    SharedStateHeader* header_ = nullptr;
+    std::atomic<std::uint64_t>* words_ = nullptr;  // Masks, then car records
+
+public:
+    // `name` is a shm object name; a leading '/' is added if missing. Any
+    // stale object of that name is replaced. Throws std::invalid_argument
+    // for a bad name or shape, std::runtime_error if the object cannot be
+    // created or mapped.
+    SharedStateWriter(const std::string& name, int numFloors, int numCars);
+    ~SharedStateWriter();
+
+    SharedStateWriter(const SharedStateWriter&) = delete;
+    SharedStateWriter& operator=(const SharedStateWriter&) = delete;
+
+    void publish(int tick, const FleetState& fleet, const FloorMask& upCalls,
+                 const FloorMask& downCalls);
+
+    const std::string& getName() const { return name_; }
+    std::size_t getBytes() const { return bytes_; }
+};
+
+// ============== Shared State Reader ==============
+// Maps an exported object read-only. Reads never write to the region, so
+// any number of readers in any number of processes leave the writer alone.
+
+class SharedStateReader {
+private:
+    void* data_ = nullptr;
+    std::size_t bytes_ = 0;
+    int numFloors_ = 0;
+    int numCars_ = 0;
+    const SharedStateHeader* header_ = nullptr;
+    const std::atomic<std::uint64_t>* words_ = nullptr;
+
+public:
+    // Throws std::runtime_error if the object is missing, not yet filled in,
+    // or of another layout version or size
+    explicit SharedStateReader(const std::string& name);
+    ~SharedStateReader();
+
+    SharedStateReader(const SharedStateReader&) = delete;
+    SharedStateReader& operator=(const SharedStateReader&) = delete;
+
+    int getNumFloors() const { return numFloors_; }
+    int getNumCars() const { return numCars_; }
+
+    // Publishes so far, one load: pollers compare it to skip unchanged ticks
+    std::uint64_t getPublishCount() const {
+        return header_->sequence.load(std::memory_order_acquire) / 2;
+    }
+
+    // One attempt, reusing `out`'s storage; false if a publish was in
+    // progress or overlapped the copy
+    bool tryRead(FleetSnapshot& out) const;
+    // Retries until a consistent copy
+    void read(FleetSnapshot& out) const;
+    FleetSnapshot read() const;
+};
+
+#endif // SHARED_STATE_HPP
@@ -5,17 +5,31 @@
 #include "Domain.hpp"
 #include "EventQueue.hpp"
 #include "Scheduler.hpp"
+#include "Passenger.hpp"
+#include "Trace.hpp"
+#include "Snapshot.hpp"
+#include "AsyncLog.hpp"
+#include "WorkerPool.hpp"
+#include "CommandParser.hpp"
+#include "Profiler.hpp"
 #include <thread>
 #include <atomic>
 #include <iostream>
+#include <memory>
 #include <sstream>
+#include <string_view>
 
 // ============== Logger ==============
+// Hot-path methods (event, state, call, assignment) fill a fixed-size
+// LogRecord and hand it to the AsyncLogSink: no formatting, allocation or
+// I/O on the calling thread. Categories compiled out via
+// ELEVATOR_LOG_CATEGORIES vanish entirely. log() stays synchronous for
+// the rare free-form messages.
 
 class Logger {
 private:
-    mutable std::mutex mutex_;
     std::ostream& out_;
+    std::unique_ptr<AsyncLogSink> sink_;
     bool enabled_;
     std::atomic<int>* tickRef_ = nullptr;  // Reference to current tick
 
@@ -24,37 +38,198 @@ public:
 
     void setTickReference(std::atomic<int>* tick);
 
+    // Send hot-path records to a raw binary file instead of formatting
+    // them (decode with AsyncLogSink::decode). Throws std::runtime_error.
+    void setRawOutput(const std::string& path);
+
     void log(const std::string& message);
-    void logEvent(const Event& event);
-    void logElevatorState(const Elevator& elev);
-    void logHallCall(int floor, Direction dir);
-    void logCarCall(int elevatorId, int floor);
-    void logAssignment(int elevatorId, int floor, Direction dir);
+
+    void logEvent(const Event& event) {
+        if constexpr (logCategoryCompiled(LogCategory::Event)) {
+            if (!enabled_) return;
+            LogRecord record = makeRecord(LogKind::Event);
+            record.code = static_cast<std::uint8_t>(event.type);
+            record.direction = static_cast<std::uint8_t>(event.direction);
+            record.elevatorId = static_cast<std::int16_t>(event.elevatorId);
+            record.floor = static_cast<std::int16_t>(event.floor);
+            record.destination = static_cast<std::int16_t>(event.destination);
+            sink_->write(record);
+        } else {
+            (void)event;
+        }
+    }
+
+    void logElevatorState(const Elevator& elev) {
+        if constexpr (logCategoryCompiled(LogCategory::State)) {
+            if (!enabled_) return;
+            LogRecord record = makeRecord(LogKind::ElevatorState);
+            record.code = static_cast<std::uint8_t>(elev.getState());
+            record.direction = static_cast<std::uint8_t>(elev.getDirection());
+            record.elevatorId = static_cast<std::int16_t>(elev.getId());
+            record.floor = static_cast<std::int16_t>(elev.getCurrentFloor());
+            record.passengers = static_cast<std::int16_t>(elev.getPassengerCount());
+            FloorMask carCalls = elev.getCarCalls();
+            const auto& words = carCalls.words();
+            for (int w = 0; w < FloorMask::kWords; ++w) {
+                record.carCalls[w] = words[w];
+            }
+            sink_->write(record);
+        } else {
+            (void)elev;
+        }
+    }
+
+    void logHallCall(int floor, Direction dir) {
+        if constexpr (logCategoryCompiled(LogCategory::Call)) {
+            if (!enabled_) return;
+            LogRecord record = makeRecord(LogKind::HallCall);
+            record.direction = static_cast<std::uint8_t>(dir);
+            record.floor = static_cast<std::int16_t>(floor);
+            sink_->write(record);
+        } else {
+            (void)floor;
+            (void)dir;
+        }
+    }
+
+    void logCarCall(int elevatorId, int floor) {
+        if constexpr (logCategoryCompiled(LogCategory::Call)) {
+            if (!enabled_) return;
+            LogRecord record = makeRecord(LogKind::CarCall);
+            record.elevatorId = static_cast<std::int16_t>(elevatorId);
+            record.floor = static_cast<std::int16_t>(floor);
+            sink_->write(record);
+        } else {
+            (void)elevatorId;
+            (void)floor;
+        }
+    }
+
+    void logPassenger(int origin, int destination) {
+        if constexpr (logCategoryCompiled(LogCategory::Call)) {
+            if (!enabled_) return;
+            LogRecord record = makeRecord(LogKind::Passenger);
+            record.floor = static_cast<std::int16_t>(origin);
+            record.destination = static_cast<std::int16_t>(destination);
+            sink_->write(record);
+        } else {
+            (void)origin;
+            (void)destination;
+        }
+    }
+
+    void logDestinationCall(int origin, int destination) {
+        if constexpr (logCategoryCompiled(LogCategory::Call)) {
+            if (!enabled_) return;
+            LogRecord record = makeRecord(LogKind::DestinationCall);
+            record.floor = static_cast<std::int16_t>(origin);
+            record.destination = static_cast<std::int16_t>(destination);
+            sink_->write(record);
+        } else {
+            (void)origin;
+            (void)destination;
+        }
+    }
+
+    void logAssignment(int elevatorId, int floor, Direction dir) {
+        if constexpr (logCategoryCompiled(LogCategory::Assignment)) {
+            if (!enabled_) return;
+            LogRecord record = makeRecord(LogKind::Assignment);
+            record.direction = static_cast<std::uint8_t>(dir);
+            record.elevatorId = static_cast<std::int16_t>(elevatorId);
+            record.floor = static_cast<std::int16_t>(floor);
+            sink_->write(record);
+        } else {
+            (void)elevatorId;
+            (void)floor;
+            (void)dir;
+        }
+    }
+
+    // Block until queued records are written out
+    void flush();
+    std::uint64_t getDropped() const;
 
     void enable();
     void disable();
     bool isEnabled() const;
 
 private:
+    LogRecord makeRecord(LogKind kind) const {
+        LogRecord record{};
+        record.kind = kind;
+        if (tickRef_) {
+            record.tick = tickRef_->load(std::memory_order_relaxed);
+        } else {
+            record.tick = -1;
+            record.wallSeconds = std::chrono::system_clock::to_time_t(
+                std::chrono::system_clock::now());
+        }
+        return record;
+    }
+
     std::string getTimestamp() const;
 };
 
+// ============== Run Statistics ==============
+
+struct RunStats {
+    int ticks = 0;
+    long long eventsProcessed = 0;
+    double elapsedSeconds = 0.0;
+
+    double ticksPerSecond() const {
+        return elapsedSeconds > 0.0 ? ticks / elapsedSeconds : 0.0;
+    }
+};
+
 // ============== Simulation Engine ==============
 
 class SimulationEngine {
 private:
+    static constexpr size_t kEventReserve = 1024;  // Queue + drain buffer, preallocated
+
     Building building_;
     std::unique_ptr<IScheduler> scheduler_;
+    PassengerModel passengers_;
     EventQueue<Event> eventQueue_;
+    std::vector<Event> pendingEvents_;  // Drain buffer, reused every tick
+    std::vector<std::pair<int, Direction>> pendingHallCalls_;  // Burst buffer
     Logger logger_;
     Config config_;
+    TickProfiler profiler_;
 
     std::vector<std::thread> threads_;
     std::atomic<bool> running_{false};
     std::atomic<int> currentTick_{0};
+    std::atomic<long long> eventsProcessed_{0};
+    std::chrono::steady_clock::time_point startTime_;
+
+    TraceWriter* traceRecorder_ = nullptr;  // Not owned
+
+    // What one car's share of a tick hands back to the engine. Per-car
+    // workers fill their own outbox; the engine merges them in car order
+    // after the barrier, so events are queued in car order as in the serial
+    // loop.
+    struct CarOutbox {
+        std::vector<Event> events;
+        int floorsTraveled = 0;
+        int trips = 0;          // Runs ended, with their energy
+        TripEnergy energy;
+        int pendingStop = -1;   // Floor of a stop waiting on a claim bid
+    };
+    std::vector<CarOutbox> outboxes_;     // By car (the serial loop uses [0])
+    std::unique_ptr<WorkerPool> carPool_; // Per-car workers, if enabled
 
 public:
     explicit SimulationEngine(const Config& config);
+    // Warm start: a new engine continuing from `snapshot`. With `config`,
+    // the building shape (floors, cars, capacity) and controller come from
+    // the snapshot and everything else (dispatch, timing, workers,
+    // logging) from `config`, so variants can fork from one warmed-up
+    // state. Throws std::runtime_error if the snapshot is corrupt.
+    explicit SimulationEngine(const SimulationSnapshot& snapshot);
+    SimulationEngine(const SimulationSnapshot& snapshot, const Config& config);
     ~SimulationEngine();
 
     // Non-copyable
@@ -66,14 +241,68 @@ public:
     void stop();
     bool isRunning() const;
 
+    // Headless run: advance `count` ticks back to back on the caller's
+    // thread (no sleeping) and return once the last tick is processed.
+    // With TimeAdvance::NextEvent, ticks in which nothing can happen are
+    // jumped over at once; the result is the same as ticking through them.
+    // Must not be used while the simulation thread is running.
+    RunStats runTicks(int count);
+
+    // Deterministic re-simulation: feed each trace record in at its
+    // recorded tick (headless), then run `drainTicks` more ticks
+    RunStats replay(const TraceReader& trace, int drainTicks = 0);
+
+    // Capture the whole simulation at the current tick boundary: building,
+    // passengers, scheduler tables and queued events (not metrics). Only
+    // between headless runs; throws std::logic_error while the simulation
+    // thread is running.
+    SimulationSnapshot saveSnapshot();
+
+    // Record every accepted hall/car call (nullptr to stop recording).
+    // Set before start(); the writer must outlive the engine's use of it.
+    void setTraceRecorder(TraceWriter* recorder);
+
+    // Append every passenger who alights to `log` (nullptr to stop), for
+    // drivers that route riders onward (CampusSimulator transfers). Set
+    // before start(); the vector must outlive the engine's use of it.
+    void setArrivalLog(std::vector<Passenger>* log);
+
     // Commands (from CLI or external)
     void requestHallCall(int floor, Direction dir);
     void requestCarCall(int elevatorId, int floor);
+    // Passenger arriving at `origin` for `destination`: raises its call
+    // (with the destination, for destination dispatch), boards when a car
+    // opens there, then presses its car call
+    void requestPassenger(int origin, int destination);
+    // Destination keypad entry without a simulated passenger
+    void requestDestinationCall(int origin, int destination);
+    // Any one of the above, as a Request (parsed CLI commands)
+    void request(const Request& request);
+    // Burst submission: validate every request in one pass (rejects are
+    // logged and skipped exactly as by the calls above), then record and
+    // queue the accepted ones in one operation. Returns the number accepted.
+    size_t requestBatch(const Request* requests, size_t count);
+    size_t requestBatch(const std::vector<Request>& requests);
+    // Headless only: spawn a passenger now, as a PassengerArrival event
+    // would, and return its id (-1 if rejected). Throws std::logic_error
+    // while the simulation thread is running.
+    int spawnPassenger(int origin, int destination);
 
     // Status
     void printStatus() const;
     int getCurrentTick() const;
+    long long getEventsProcessed() const;
+    double getTicksPerSecond() const;  // Simulated ticks per wall-clock second
+    void flushLog();                   // Wait for queued log records to be written
     const Building& getBuilding() const;
+    const PassengerMetrics& getPassengerMetrics() const;
+
+    // Profiling (Config::profiling): per-phase tick times, queue depth,
+    // lock contention. Safe to call from any thread while running.
+    const TickProfiler& getProfiler() const;
+    ProfileCounters getProfileCounters() const;
+    void printStats(std::ostream& out = std::cout) const;
+    void writeMetrics(std::ostream& out) const;   // Prometheus text format
 
     // Access for testing
     Building& getBuildingMutable();
@@ -81,11 +310,33 @@ public:
 
 private:
     void runSimulationLoop();
+    void submitRequest(const Request& request);
+    // Check one request and log it; fills `event` if it is accepted
+    bool acceptRequest(const Request& request, Event& event);
+    void step();  // One tick followed by draining pending events
+    // Next-event advance: how many of the next `limit` ticks can be
+    // skipped (no queued events, no car timer due, scheduler quiet)
+    int quietSpan(int limit);
+    // Jump `ticks` quiet ticks: count car timers down, move the clock
+    void skipQuietTicks(int ticks);
     void processEvent(const Event& event);
-    void processTick();
+    // Hand a run of consecutive hall-call events to the scheduler as one
+    // batch; returns the index just past the run
+    size_t processHallCallRun(size_t begin);
+    void processTick(TickProfiler::Stamp& lap);
     void updateElevators();
+    // Config::carWorkers: the tick as four barrier-separated phases over
+    // all cars - advance (bidding for stops), resolve stop bids, bid for
+    // calls, resolve call bids and decide
+    void processTickParallel();
+    // One car's share of updateElevators. With `bidding`, a stop that needs
+    // a new claim is left in out.pendingStop instead of being decided.
+    void advanceCar(int id, CarOutbox& out, bool bidding);
+    void arriveCar(int id, int floor, CarOutbox& out);
+    void flushOutbox(CarOutbox& out);
 
     void createScheduler();
+    void restoreState(const SimulationSnapshot& snapshot);
 };
 
 // ============== CLI Helper ==============
@@ -94,18 +345,29 @@ class CLI {
 private:
     SimulationEngine& engine_;
     std::atomic<bool> running_{true};
+    std::vector<Request> batch_;  // Stream mode: calls not yet submitted
 
 public:
     explicit CLI(SimulationEngine& engine);
 
+    // Interactive prompt on stdin; piped stdin is read with runStream
     void run();
+    // Read commands from a file ("-" for stdin) with runStream.
+    // Throws std::runtime_error if the file cannot be opened.
+    size_t runScript(const std::string& path);
+    // Read commands from `fd` in large blocks until EOF or quit. Calls are
+    // gathered and submitted with requestBatch once per read (or every
+    // few thousand); other commands run after the calls before them are
+    // queued. Returns the number of lines read.
+    size_t runStream(int fd);
     void stop();
 
 private:
     void printHelp();
-    void processCommand(const std::string& line);
-    bool parseHallCall(const std::string& args);
-    bool parseCarCall(const std::string& args);
+    void processCommand(std::string_view line);
+    void feedLine(std::string_view line);
+    void flushBatch();
+    void execute(const Command& command);
 };
 
 #endif // SIMULATION_HPP
@@ -0,0 +1,76 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include "Types.hpp"
+#include "FloorMask.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============== Simulation Snapshot ==============
+// Compact binary image of a headless engine at a tick boundary: config,
+// clock, fleet, hall/car calls, passengers, queued events and the
+// scheduler's own tables. A magic/version header, then little-endian
+// fixed-width fields written by each component in turn. SimulationEngine
+// takes and restores snapshots; restoring starts with empty metrics.
+
+constexpr char kSnapshotMagic[8] = {'E', 'L', 'V', 'S', 'N', 'A', 'P', '\0'};
+constexpr std::uint32_t kSnapshotVersion = 5;
+
+class SnapshotWriter {
+private:
+    std::vector<std::uint8_t> bytes_;
+
+public:
+    SnapshotWriter();  // Starts with the header
+
+    void putInt(int value);  // 32-bit
+    void putU64(std::uint64_t value);
+    void putMask(const FloorMask& mask);
+    template<typename Enum>
+    void putEnum(Enum value) { putInt(static_cast<int>(value)); }
+
+    std::vector<std::uint8_t> release() { return std::move(bytes_); }
+};
+
+// Reads fields back in the order they were written. Every getter throws
+// std::runtime_error on truncated or out-of-range data.
+class SnapshotReader {
+private:
+    const std::vector<std::uint8_t>& bytes_;
+    std::size_t pos_ = 0;
+
+public:
+    // Checks the header
+    explicit SnapshotReader(const std::vector<std::uint8_t>& bytes);
+
+    int getInt();
+    int getInt(int lo, int hi);
+    std::uint64_t getU64();
+    // Mask whose floors all lie in 1..maxFloor
+    FloorMask getMask(int maxFloor);
+    // Enum with values 0..last
+    template<typename Enum>
+    Enum getEnum(Enum last) { return static_cast<Enum>(getInt(0, static_cast<int>(last))); }
+
+    bool atEnd() const { return pos_ == bytes_.size(); }
+};
+
+struct SimulationSnapshot {
+    std::vector<std::uint8_t> bytes;
+
+    // The config the snapshot was taken with. Throws std::runtime_error.
+    Config getConfig() const;
+    int getTick() const;
+
+    // Throw std::runtime_error on I/O errors
+    void writeFile(const std::string& path) const;
+    static SimulationSnapshot readFile(const std::string& path);
+};
+
+// Config fields, first in every snapshot
+void writeConfig(SnapshotWriter& out, const Config& config);
+Config readConfig(SnapshotReader& in);
+
+#endif // SNAPSHOT_HPP
@@ -0,0 +1,110 @@
+#ifndef SWEEP_HPP
+#define SWEEP_HPP
+
+#include "Types.hpp"
+#include "Metrics.hpp"
+#include "Traffic.hpp"
+#include <string>
+#include <vector>
+
+// ============== Sweep Configuration ==============
+// Capacity planning: which fleets meet a passenger-wait SLA under one
+// traffic load. Each axis lists the values to try; an empty axis takes its
+// value from `base`.
+
+enum class SweepSearch {
+    Grid,     // Every point of the grid
+    MinCars   // For each other setting, bisect for the fewest cars meeting the SLA
+};
+
+struct SweepConfig {
+    Config base;                        // Floors, dispatch, cost model; forced headless
+    std::vector<int> numElevators;
+    std::vector<int> carCapacity;
+    std::vector<int> doorOpenTicks;
+    std::vector<int> floorTravelTicks;
+    std::vector<ControllerType> controllers;
+    SweepSearch search = SweepSearch::Grid;
+
+    int runs = 20;                      // Seeded runs per point, seeds traffic.seed + i
+    int ticksPerRun = 2000;
+    TrafficConfig traffic;
+    int threads = 0;                    // 0 = one per hardware thread
+
+    double slaPercentile = 0.95;
+    int slaTicks = 0;                   // Wait SLA at slaPercentile (0 = none)
+    // Early cut-off: after screenRuns runs, drop a point whose wait is
+    // already over cutoffFactor x slaTicks (needs an SLA)
+    int screenRuns = 4;
+    double cutoffFactor = 1.5;
+
+    double seatCost = 0.1;              // Fleet cost = cars x (1 + seatCost x capacity)
+};
+
+// "4", "2-8", "2-12:2" or a comma list of those; throws
+// std::invalid_argument on anything else
+std::vector<int> parseIntList(const std::string& text);
+// Comma list of master|distributed|destination
+std::vector<ControllerType> parseControllerList(const std::string& text);
+
+// ============== Sweep Results ==============
+
+struct SweepPoint {
+    int numElevators = 0;
+    int carCapacity = 0;
+    int doorOpenTicks = 0;
+    int floorTravelTicks = 0;
+    ControllerType controller = ControllerType::Master;
+    double cost = 0.0;
+
+    int runs = 0;                       // Fewer than SweepConfig::runs if cut off
+    bool cutOff = false;
+    bool pareto = false;                // On the cost / SLA-percentile wait front
+    PassengerMetrics passengers;        // Merged over the runs
+    long long floorsTraveled = 0;
+
+    // Wait at percentile `p` over every passenger who arrived, counting
+    // those never picked up as the longest waits; -1 when more than 1 - p
+    // of them were never picked up (the percentile is unbounded)
+    int waitAt(double p) const;
+    long long unserved() const { return passengers.waiting.load(); }
+};
+
+struct SweepResult {
+    std::vector<SweepPoint> points;     // Ascending cost, then wait
+    int cutOff = 0;                     // Points dropped early
+    long long runs = 0;
+    long long ticks = 0;
+    double elapsedSeconds = 0.0;
+
+    // Cheapest point meeting the SLA (nullptr if none or no SLA)
+    const SweepPoint* cheapestMeetingSla(const SweepConfig& config) const;
+};
+
+// ============== Sweep Runner ==============
+// Runs the points on a pool of threads, each point on one thread with
+// seeds traffic.seed + run. A run is ticksPerRun ticks of traffic, then up
+// to as many again with no new arrivals while anyone is still waiting; by
+// then whoever is left was not going to be picked up. A point depends only
+// on its own config and seeds, so results do not change with the thread
+// count. In MinCars mode one task is one setting of the other axes,
+// bisecting the sorted car counts (wait is taken to fall as cars are
+// added), so it evaluates about log2(cars) points instead of all of them.
+
+class SweepRunner {
+private:
+    SweepConfig config_;
+
+public:
+    // Throws std::invalid_argument for an empty or out-of-range axis,
+    // bad run counts or a MinCars search without an SLA
+    explicit SweepRunner(const SweepConfig& config);
+
+    SweepResult run() const;
+
+    bool meetsSla(const SweepPoint& point) const;
+    int getThreadCount() const;
+    int getTaskCount() const;
+};
+
+#endif // SWEEP_HPP
@@ -0,0 +1,100 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include "Types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ============== Trace Format ==============
+// Binary call trace: one TraceHeader followed by fixed-size TraceRecords,
+// little-endian, in non-decreasing tick order. The layout is plain data so
+// a trace can be memory-mapped and read in place.
+
+constexpr char kTraceMagic[8] = {'E', 'L', 'V', 'T', 'R', 'A', 'C', 'E'};
+constexpr std::uint32_t kTraceVersion = 1;
+
+struct TraceHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t recordSize;
+    std::uint64_t recordCount;
+    std::uint16_t numFloors;      // Building the trace was recorded on
+    std::uint16_t numElevators;
+    std::uint32_t reserved;
+};
+static_assert(sizeof(TraceHeader) == 32, "TraceHeader layout changed");
+
+struct TraceRecord {
+    std::uint32_t tick;
+    std::uint8_t type;            // EventType
+    std::uint8_t direction;       // Direction
+    std::int16_t floor;
+    std::int16_t elevatorId;
+    std::int16_t destination;     // PassengerArrival / DestinationCall only
+    std::uint32_t reserved32;
+
+    static TraceRecord fromEvent(int tick, const Event& event);
+    Event toEvent() const;
+};
+static_assert(sizeof(TraceRecord) == 16, "TraceRecord layout changed");
+
+// ============== Trace Writer ==============
+// Appends records to a trace file. Thread-safe: request threads record
+// concurrently. The header's record count is patched in on close().
+
+class TraceWriter {
+private:
+    std::ofstream out_;
+    TraceHeader header_{};
+    std::vector<TraceRecord> buffer_;
+    std::mutex mutex_;
+    bool open_ = false;
+
+    void flushLocked();
+
+public:
+    // Throws std::runtime_error if the file cannot be created
+    TraceWriter(const std::string& path, const Config& config);
+    ~TraceWriter();
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    void record(int tick, const Event& event);
+    // A run of events at one tick, under a single lock
+    void record(int tick, const Event* events, std::size_t count);
+    void close();
+    std::uint64_t getRecordCount();
+};
+
+// ============== Trace Reader ==============
+// Memory-maps a trace file read-only; records are accessed in place.
+
+class TraceReader {
+private:
+    const void* mapping_ = nullptr;
+    std::size_t mappedSize_ = 0;
+    const TraceHeader* header_ = nullptr;
+    const TraceRecord* records_ = nullptr;
+    std::size_t count_ = 0;
+
+public:
+    // Throws std::runtime_error on I/O errors or an invalid trace
+    explicit TraceReader(const std::string& path);
+    ~TraceReader();
+
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    const TraceHeader& getHeader() const { return *header_; }
+    std::size_t size() const { return count_; }
+    const TraceRecord* begin() const { return records_; }
+    const TraceRecord* end() const { return records_ + count_; }
+    const TraceRecord& operator[](std::size_t i) const { return records_[i]; }
+};
+
+#endif // TRACE_HPP
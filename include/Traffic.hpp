@@ -0,0 +1,113 @@
+#ifndef TRAFFIC_HPP
+#define TRAFFIC_HPP
+
+#include "Types.hpp"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+class SimulationEngine;
+struct RunStats;
+
+// ============== Traffic Profiles ==============
+// Standard mixes of incoming (lobby -> upper floor), outgoing (upper floor
+// -> lobby) and interfloor (upper -> upper) trips. Uniform draws origin
+// and destination from every floor alike.
+
+enum class TrafficProfile {
+    Uniform,
+    UpPeak,         // Morning: 85% incoming, 10% outgoing, 5% interfloor
+    DownPeak,       // Evening: 5% incoming, 85% outgoing, 10% interfloor
+    Lunch,          // Two-way: 45% incoming, 45% outgoing, 10% interfloor
+    Interfloor      // Interfloor trips only
+};
+
+struct TrafficMix {
+    double incoming = 0.0;
+    double outgoing = 0.0;
+    double interfloor = 1.0;
+};
+
+// What each arrival is submitted as
+enum class TrafficEmit {
+    Passengers,         // PassengerArrival: simulated rider + its call
+    HallCalls,          // Up/down hall call only
+    DestinationCalls    // Destination keypad entry only
+};
+
+// Piecewise-linear multiplier of the base rate; held flat past the ends
+struct RatePoint {
+    int tick = 0;
+    double scale = 1.0;
+};
+
+// ============== Traffic Configuration ==============
+
+struct TrafficConfig {
+    TrafficProfile profile = TrafficProfile::Uniform;
+    TrafficEmit emit = TrafficEmit::Passengers;
+    double callsPerTick = 0.2;          // Mean arrivals per tick at scale 1
+    std::vector<RatePoint> rateCurve;   // Ascending ticks; empty = constant
+    int lobbyFloor = 1;
+    std::uint32_t seed = 1;
+};
+
+TrafficMix trafficMix(TrafficProfile profile);
+std::string trafficProfileToString(TrafficProfile profile);
+// "uniform", "up-peak", "down-peak", "lunch", "interfloor";
+// throws std::invalid_argument otherwise
+TrafficProfile parseTrafficProfile(const std::string& name);
+
+// ============== Traffic Generator ==============
+// Seeded Poisson arrivals in virtual time. Gaps between arrivals are
+// exponential at the curve's peak rate and thinned down to the rate at
+// each arrival's time, so a varying rate costs one draw per candidate
+// and nothing per empty tick. Arrivals come out as Requests in time
+// order; drive() hands each tick's burst to requestBatch and runs the
+// engine straight to the next arrival.
+
+class TrafficGenerator {
+private:
+    TrafficConfig config_;
+    int numFloors_;
+    std::mt19937 gen_;
+    std::exponential_distribution<double> gap_;
+    std::uniform_real_distribution<double> unit_{0.0, 1.0};
+    TrafficMix mix_;
+    double peakRate_ = 0.0;
+    double nextTime_;                   // Next candidate arrival, in ticks
+    long long generated_ = 0;
+    std::vector<Request> batch_;        // drive(): one tick's arrivals
+
+    void advance();
+    int drawFloor();                    // Any floor
+    int drawUpperFloor();               // Any floor but the lobby
+    Request makeRequest(int origin, int destination) const;
+
+public:
+    // Throws std::invalid_argument for a negative rate or scale, a curve
+    // out of order or a lobby outside 1..numFloors
+    TrafficGenerator(const TrafficConfig& config, int numFloors);
+
+    // Append every arrival before tick + 1 not yet produced; returns how
+    // many were appended
+    size_t generate(int tick, std::vector<Request>& out);
+
+    // Drop whatever would arrive before `tick` (the process is memoryless,
+    // so this is one fresh gap from `tick`, not a replay of the skipped ones)
+    void skipTo(int tick);
+
+    // Run `ticks` ticks of a headless engine with this traffic from its
+    // current tick (skipping ahead to it, for a warm start). Identical to
+    // submitting generate(t) before each runTicks(1), but quiet stretches
+    // run as one runTicks call.
+    RunStats drive(SimulationEngine& engine, int ticks);
+
+    double rateAt(double tick) const;   // Arrivals per tick at `tick`
+    // First tick that may still produce an arrival (INT_MAX if none)
+    int nextArrivalTick() const;
+    long long getGeneratedCount() const { return generated_; }
+};
+
+#endif // TRAFFIC_HPP
@@ -1,12 +1,12 @@
 #ifndef TYPES_HPP
 #define TYPES_HPP
 
-#include <chrono>
+#include <cstdint>
 #include <string>
 
 // ============== Enums =============
 
-enum class Direction { 
+enum class Direction : std::uint8_t { 
     Up, 
     Down, 
     Idle 
@@ -20,19 +20,70 @@ enum class ElevatorState {
     DoorsClosing    // Preparing to move
 };
 
-enum class EventType {
+enum class EventType : std::uint8_t {
     HallCall,       // Floor button pressed
     CarCall,        // Destination selected in car
     ElevatorArrived,// Elevator reached a floor
     DoorsOpened,
     DoorsClosed,
     Tick,           // Simulation time advance
-    Shutdown        // Graceful termination
+    Shutdown,       // Graceful termination
+    PassengerArrival,// Passenger appears at `floor` heading for `destination`
+    DestinationCall // Destination keypad at `floor`: someone wants `destination`
 };
 
 enum class ControllerType { 
     Master, 
-    Distributed 
+    Distributed,
+    Destination     // Destination dispatch: keypad calls grouped by zone
+};
+
+enum class DispatchPolicy {
+    NearestFirst,   // Always head for the closest destination
+    Collective      // Sweep (LOOK): finish one direction, stop for calls on the way
+};
+
+enum class CostModel {
+    Distance,       // costToServe: floors away plus flat direction/full penalties
+    Eta             // EtaTable: ticks to arrive over queued stops and door cycles
+};
+
+enum class TimeAdvance {
+    FixedTick,      // Visit every car every tick
+    NextEvent       // Headless: jump straight over ticks in which nothing can happen
+};
+
+enum class MotionModel {
+    Fixed,          // floorTravelTicks per floor, no energy accounting
+    Kinematic       // Jerk-limited run profile: ticks per floor and energy per trip
+};
+
+// ============== Limits ==============
+
+constexpr int kMaxFloors = 255;     // Floors are bits 1..255 of a FloorMask
+constexpr int kMaxElevators = 64;   // Cars fit a 64-bit car mask
+
+// ============== Hall Call Slots ==============
+// Dense index for per-(floor, direction) tables: two slots per floor
+
+constexpr int hallCallSlot(int floor, Direction dir) {
+    return floor * 2 + (dir == Direction::Down ? 1 : 0);
+}
+
+// ============== Motion Parameters ==============
+// Car dynamics and drive for MotionModel::Kinematic, in SI units
+
+struct MotionParams {
+    double floorHeight = 3.5;       // m
+    double maxSpeed = 2.5;          // m/s
+    double maxAccel = 1.0;          // m/s^2
+    double maxJerk = 1.5;           // m/s^3
+    double carMass = 1200.0;        // kg, empty car
+    double passengerMass = 75.0;    // kg
+    double counterweightLoad = 0.5; // Counterweight balances the car plus this share of full load
+    double frictionForce = 300.0;   // N, guides and ropes while moving
+    double driveEfficiency = 0.8;   // Work delivered per joule drawn
+    double regenEfficiency = 0.6;   // Joules returned per joule of braking or overhauling work
 };
 
 // ============== Configuration ==============
@@ -45,17 +96,74 @@ struct Config {
     int doorOpenTicks = 3;
     int floorTravelTicks = 2;
     ControllerType controllerType = ControllerType::Master;
+    DispatchPolicy dispatchPolicy = DispatchPolicy::NearestFirst;
+    CostModel costModel = CostModel::Distance;  // Master assignment / Distributed claims
+    int reassignPeriod = 0;       // Master: re-optimise hall calls every n ticks (0 = off)
+    int reassignMinGain = 4;      // ...moving a call only if it saves this much cost
+    int destinationZoneSize = 0;  // Destination dispatch zone height (0 = floors / cars)
+    int carWorkers = 0;           // Distributed: threads running per-car logic (0 = serial)
+    TimeAdvance timeAdvance = TimeAdvance::FixedTick;  // Headless runs and replays
+    MotionModel motionModel = MotionModel::Fixed;  // Kinematic: tickDurationMs is sim time
+    MotionParams motion;
+    bool headless = false;        // Virtual time: run ticks back to back, no sleep
+    bool profiling = false;       // Time each tick phase (needs ELEVATOR_PROFILING)
+    bool loggingEnabled = true;
+    std::string logFile;          // Raw binary log instead of text (empty = text)
+    std::string sharedStateName;  // Publish each tick to this shm object (empty = off)
 };
 
 // ============== Event ==============
+// 12 bytes, trivially copyable: queues and drain buffers move them with
+// plain copies and never touch the clock. `tick` is the simulation tick the
+// event was queued on. Floors, cars and destinations fit int16 (kMaxFloors,
+// kMaxElevators), as in TraceRecord.
 
 struct Event {
-    EventType type;
-    int floor = -1;
-    int elevatorId = -1;
+    EventType type = EventType::HallCall;
     Direction direction = Direction::Idle;
-    std::chrono::steady_clock::time_point timestamp = 
-        std::chrono::steady_clock::now();
+    std::int16_t floor = -1;
+    std::int16_t elevatorId = -1;
+    std::int16_t destination = -1;  // PassengerArrival / DestinationCall only
+    std::int32_t tick = 0;
+};
+static_assert(sizeof(Event) == 12, "Event layout changed");
+
+// ============== Request ==============
+// One externally submitted call, as taken by SimulationEngine::requestBatch.
+// `type` is HallCall, CarCall, PassengerArrival or DestinationCall.
+
+struct Request {
+    EventType type = EventType::HallCall;
+    int floor = -1;             // Call floor / passenger origin
+    int elevatorId = -1;        // CarCall only
+    Direction direction = Direction::Idle;  // HallCall only
+    int destination = -1;       // PassengerArrival / DestinationCall only
+
+    static Request hallCall(int floor, Direction dir) {
+        Request request;
+        request.floor = floor;
+        request.direction = dir;
+        return request;
+    }
+    static Request carCall(int elevatorId, int floor) {
+        Request request;
+        request.type = EventType::CarCall;
+        request.elevatorId = elevatorId;
+        request.floor = floor;
+        return request;
+    }
+    static Request passenger(int origin, int destination) {
+        Request request;
+        request.type = EventType::PassengerArrival;
+        request.floor = origin;
+        request.destination = destination;
+        return request;
+    }
+    static Request destinationCall(int origin, int destination) {
+        Request request = passenger(origin, destination);
+        request.type = EventType::DestinationCall;
+        return request;
+    }
 };
 
 // ============== Utility Functions ==============
@@ -80,4 +188,13 @@ inline std::string stateToString(ElevatorState state) {
     return "Unknown";
 }
 
+inline std::string controllerToString(ControllerType type) {
+    switch (type) {
+        case ControllerType::Master: return "Master";
+        case ControllerType::Distributed: return "Distributed";
+        case ControllerType::Destination: return "Destination";
+    }
+    return "Unknown";
+}
+
 #endif // TYPES_HPP
@@ -0,0 +1,49 @@
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ============== Worker Pool ==============
+// Fixed set of threads that run one indexed job at a time. run(count, job)
+// calls job(0) .. job(count-1) spread over the workers and the calling
+// thread and returns only once every index is done, so each call is a
+// barrier. Indices are pulled from a shared counter; between jobs the
+// workers sleep on a condition variable.
+
+class WorkerPool {
+private:
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+
+    const std::function<void(int)>* job_ = nullptr;
+    int count_ = 0;
+    std::atomic<int> next_{0};
+    int busy_ = 0;                  // Workers still inside the current job
+    std::uint64_t generation_ = 0;  // Bumped once per run()
+    bool stopping_ = false;
+
+    void workerLoop();
+    void drainJob();
+
+public:
+    // `workers` threads besides the caller; 0 runs every job inline
+    explicit WorkerPool(int workers);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void run(int count, const std::function<void(int)>& job);
+
+    int getThreadCount() const { return static_cast<int>(threads_.size()) + 1; }
+};
+
+#endif // WORKER_POOL_HPP
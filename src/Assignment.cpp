@@ -0,0 +1,79 @@
+#include "Assignment.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+// ============== AssignmentSolver Implementation ==============
+
+void AssignmentSolver::reset(int rows, int cols) {
+    if (rows < 0 || cols < rows) {
+        throw std::invalid_argument("Assignment needs 0 <= rows <= cols");
+    }
+    rows_ = rows;
+    cols_ = cols;
+    cost_.resize(static_cast<size_t>(rows) * cols);
+    u_.resize(rows + 1);
+    v_.resize(cols + 1);
+    rowOfCol_.resize(cols + 1);
+    way_.resize(cols + 1);
+    minv_.resize(cols + 1);
+    used_.resize(cols + 1);
+    result_.resize(rows);
+}
+
+const std::vector<int>& AssignmentSolver::solve() {
+    constexpr long long kInf = std::numeric_limits<long long>::max() / 4;
+    std::fill(u_.begin(), u_.end(), 0);
+    std::fill(v_.begin(), v_.end(), 0);
+    std::fill(rowOfCol_.begin(), rowOfCol_.end(), 0);
+
+    for (int row = 1; row <= rows_; ++row) {
+        // Grow an alternating tree from `row` until it reaches a free column
+        rowOfCol_[0] = row;
+        int col0 = 0;
+        std::fill(minv_.begin(), minv_.end(), kInf);
+        std::fill(used_.begin(), used_.end(), 0);
+        do {
+            used_[col0] = 1;
+            int row0 = rowOfCol_[col0];
+            const int* costRow = &cost_[static_cast<size_t>(row0 - 1) * cols_];
+            long long delta = kInf;
+            int col1 = 0;
+            for (int col = 1; col <= cols_; ++col) {
+                if (used_[col]) continue;
+                long long reduced = costRow[col - 1] - u_[row0] - v_[col];
+                if (reduced < minv_[col]) {
+                    minv_[col] = reduced;
+                    way_[col] = col0;
+                }
+                if (minv_[col] < delta) {
+                    delta = minv_[col];
+                    col1 = col;
+                }
+            }
+            for (int col = 0; col <= cols_; ++col) {
+                if (used_[col]) {
+                    u_[rowOfCol_[col]] += delta;
+                    v_[col] -= delta;
+                } else {
+                    minv_[col] -= delta;
+                }
+            }
+            col0 = col1;
+        } while (rowOfCol_[col0] != 0);
+
+        // Flip the augmenting path
+        do {
+            int col1 = way_[col0];
+            rowOfCol_[col0] = rowOfCol_[col1];
+            col0 = col1;
+        } while (col0 != 0);
+    }
+
+    for (int col = 1; col <= cols_; ++col) {
+        if (rowOfCol_[col] > 0) {
+            result_[rowOfCol_[col] - 1] = col - 1;
+        }
+    }
+    return result_;
+}
@@ -0,0 +1,325 @@
+#include "AsyncLog.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+
+constexpr std::size_t kRingMask = AsyncLogSink::kRingCapacity - 1;
+static_assert((AsyncLogSink::kRingCapacity & kRingMask) == 0,
+              "Ring capacity must be a power of two");
+
+constexpr auto kIdleWait = std::chrono::milliseconds(2);
+
+std::atomic<std::uint64_t> nextSinkId{1};
+
+// Last ring this thread used; avoids the registry lock on every write
+struct RingCache {
+    std::uint64_t sinkId = 0;
+    void* ring = nullptr;
+};
+thread_local RingCache ringCache;
+
+const char* directionName(std::uint8_t dir) {
+    switch (static_cast<Direction>(dir)) {
+        case Direction::Up: return "Up";
+        case Direction::Down: return "Down";
+        case Direction::Idle: return "Idle";
+    }
+    return "Unknown";
+}
+
+const char* stateName(std::uint8_t state) {
+    switch (static_cast<ElevatorState>(state)) {
+        case ElevatorState::Idle: return "Idle";
+        case ElevatorState::Moving: return "Moving";
+        case ElevatorState::DoorsOpening: return "DoorsOpening";
+        case ElevatorState::DoorsOpen: return "DoorsOpen";
+        case ElevatorState::DoorsClosing: return "DoorsClosing";
+    }
+    return "Unknown";
+}
+
+void appendf(std::string& out, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+void appendf(std::string& out, const char* fmt, ...) {
+    char buf[128];
+    va_list args;
+    va_start(args, fmt);
+    int n = std::vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (n > 0) {
+        out.append(buf, std::min(static_cast<std::size_t>(n), sizeof(buf) - 1));
+    }
+}
+
+}  // namespace
+
+// ============== Per-Thread Ring ==============
+
+struct AsyncLogSink::Ring {
+    std::thread::id owner;
+    alignas(64) std::atomic<std::size_t> tail{0};  // Written by the owner
+    alignas(64) std::atomic<std::size_t> head{0};  // Written by the worker
+    std::array<LogRecord, kRingCapacity> records;
+};
+
+// ============== AsyncLogSink Implementation ==============
+
+AsyncLogSink::AsyncLogSink(std::ostream& out)
+    : out_(out), id_(nextSinkId.fetch_add(1)) {
+    batch_.reserve(kRingCapacity);
+    worker_ = std::thread(&AsyncLogSink::run, this);
+}
+
+AsyncLogSink::AsyncLogSink(std::ostream& out, const std::string& rawPath)
+    : out_(out), raw_(rawPath, std::ios::binary | std::ios::trunc),
+      id_(nextSinkId.fetch_add(1)) {
+    if (!raw_) {
+        throw std::runtime_error("Cannot create log file: " + rawPath);
+    }
+    raw_.write(kLogMagic, sizeof(kLogMagic));
+    batch_.reserve(kRingCapacity);
+    worker_ = std::thread(&AsyncLogSink::run, this);
+}
+
+AsyncLogSink::~AsyncLogSink() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    worker_.join();
+}
+
+AsyncLogSink::Ring* AsyncLogSink::localRing() {
+    if (ringCache.sinkId == id_) {
+        return static_cast<Ring*>(ringCache.ring);
+    }
+
+    // Slow path: first write from this thread, or it switched sinks
+    std::lock_guard<std::mutex> lock(ringsMutex_);
+    std::thread::id self = std::this_thread::get_id();
+    Ring* ring = nullptr;
+    for (auto& r : rings_) {
+        if (r->owner == self) {
+            ring = r.get();
+            break;
+        }
+    }
+    if (!ring) {
+        rings_.push_back(std::make_unique<Ring>());
+        ring = rings_.back().get();
+        ring->owner = self;
+    }
+    ringCache.sinkId = id_;
+    ringCache.ring = ring;
+    return ring;
+}
+
+void AsyncLogSink::write(const LogRecord& record) {
+    Ring* ring = localRing();
+    std::size_t tail = ring->tail.load(std::memory_order_relaxed);
+    if (tail - ring->head.load(std::memory_order_acquire) >= kRingCapacity) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ring->records[tail & kRingMask] = record;
+    ring->tail.store(tail + 1, std::memory_order_release);
+}
+
+void AsyncLogSink::writeLine(const std::string& line) {
+    std::lock_guard<std::mutex> lock(outMutex_);
+    out_ << line << "\n";
+}
+
+void AsyncLogSink::flush() {
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    // Two completed passes guarantee one started after this call
+    std::uint64_t target = passes_ + 2;
+    flushRequested_ = true;
+    wake_.notify_one();
+    passDone_.wait(lock, [&] { return passes_ >= target; });
+}
+
+std::uint64_t AsyncLogSink::getDropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+bool AsyncLogSink::drainOnce() {
+    batch_.clear();
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        for (auto& ring : rings_) {
+            std::size_t head = ring->head.load(std::memory_order_relaxed);
+            std::size_t tail = ring->tail.load(std::memory_order_acquire);
+            for (; head != tail; ++head) {
+                batch_.push_back(ring->records[head & kRingMask]);
+            }
+            ring->head.store(head, std::memory_order_release);
+        }
+    }
+    if (batch_.empty()) {
+        return false;
+    }
+
+    // Rings are per thread; restore tick order across them
+    std::stable_sort(batch_.begin(), batch_.end(),
+                     [](const LogRecord& a, const LogRecord& b) { return a.tick < b.tick; });
+
+    if (raw_.is_open()) {
+        raw_.write(reinterpret_cast<const char*>(batch_.data()),
+                   static_cast<std::streamsize>(batch_.size() * sizeof(LogRecord)));
+        raw_.flush();
+        return true;
+    }
+
+    text_.clear();
+    for (const LogRecord& record : batch_) {
+        format(record, text_);
+        text_ += '\n';
+    }
+    std::lock_guard<std::mutex> lock(outMutex_);
+    out_ << text_;
+    out_.flush();
+    return true;
+}
+
+void AsyncLogSink::run() {
+    for (;;) {
+        bool drained = drainOnce();
+
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        ++passes_;
+        passDone_.notify_all();
+        if (stopping_) {
+            lock.unlock();
+            while (drainOnce()) {
+            }
+            return;
+        }
+        if (!drained && !flushRequested_) {
+            wake_.wait_for(lock, kIdleWait, [this] { return stopping_ || flushRequested_; });
+        }
+        flushRequested_ = false;
+    }
+}
+
+void AsyncLogSink::format(const LogRecord& record, std::string& out) {
+    if (record.tick >= 0) {
+        appendf(out, "[T%04d] ", record.tick);
+    } else {
+        std::time_t time = static_cast<std::time_t>(record.wallSeconds);
+        std::tm local{};
+        localtime_r(&time, &local);
+        appendf(out, "[%02d:%02d:%02d] ", local.tm_hour, local.tm_min, local.tm_sec);
+    }
+
+    switch (record.kind) {
+        case LogKind::Event:
+            out += "[EVENT] ";
+            switch (static_cast<EventType>(record.code)) {
+                case EventType::HallCall:
+                    appendf(out, "HallCall floor=%d dir=%s", record.floor,
+                            directionName(record.direction));
+                    break;
+                case EventType::CarCall:
+                    appendf(out, "CarCall elevator=%d floor=%d", record.elevatorId, record.floor);
+                    break;
+                case EventType::ElevatorArrived:
+                    appendf(out, "ElevatorArrived elevator=%d floor=%d",
+                            record.elevatorId, record.floor);
+                    break;
+                case EventType::DoorsOpened:
+                    appendf(out, "DoorsOpened elevator=%d", record.elevatorId);
+                    break;
+                case EventType::DoorsClosed:
+                    appendf(out, "DoorsClosed elevator=%d", record.elevatorId);
+                    break;
+                case EventType::Tick:
+                    out += "Tick";
+                    break;
+                case EventType::Shutdown:
+                    out += "Shutdown";
+                    break;
+                case EventType::PassengerArrival:
+                    appendf(out, "PassengerArrival floor=%d dest=%d", record.floor,
+                            record.destination);
+                    break;
+                case EventType::DestinationCall:
+                    appendf(out, "DestinationCall floor=%d dest=%d", record.floor,
+                            record.destination);
+                    break;
+            }
+            break;
+
+        case LogKind::ElevatorState: {
+            appendf(out, "[ELEVATOR %d] floor=%d state=%s dir=%s passengers=%d",
+                    record.elevatorId, record.floor, stateName(record.code),
+                    directionName(record.direction), record.passengers);
+            bool first = true;
+            for (int w = 0; w < 4; ++w) {
+                for (std::uint64_t bits = record.carCalls[w]; bits; bits &= bits - 1) {
+                    out += first ? " carCalls={" : ",";
+                    appendf(out, "%d", w * 64 + __builtin_ctzll(bits));
+                    first = false;
+                }
+            }
+            if (!first) out += "}";
+            break;
+        }
+
+        case LogKind::HallCall:
+            appendf(out, "[HALL CALL] floor=%d dir=%s", record.floor,
+                    directionName(record.direction));
+            break;
+
+        case LogKind::CarCall:
+            appendf(out, "[CAR CALL] elevator=%d floor=%d", record.elevatorId, record.floor);
+            break;
+
+        case LogKind::Passenger:
+            appendf(out, "[PASSENGER] floor=%d -> dest=%d", record.floor, record.destination);
+            break;
+
+        case LogKind::DestinationCall:
+            appendf(out, "[DEST CALL] floor=%d -> dest=%d", record.floor, record.destination);
+            break;
+
+        case LogKind::Assignment:
+            appendf(out, "[ASSIGNMENT] elevator=%d -> floor=%d dir=%s", record.elevatorId,
+                    record.floor, directionName(record.direction));
+            break;
+    }
+}
+
+std::size_t AsyncLogSink::decode(const std::string& rawPath, std::ostream& out) {
+    std::ifstream in(rawPath, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open log file: " + rawPath);
+    }
+    char magic[sizeof(kLogMagic)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kLogMagic, sizeof(magic)) != 0) {
+        throw std::runtime_error("Not a binary log file: " + rawPath);
+    }
+
+    std::size_t count = 0;
+    std::string line;
+    LogRecord record;
+    while (in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        line.clear();
+        format(record, line);
+        out << line << "\n";
+        ++count;
+    }
+    if (in.gcount() != 0) {
+        throw std::runtime_error("Truncated log record in: " + rawPath);
+    }
+    return count;
+}
@@ -0,0 +1,111 @@
+#include "BatchRunner.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// ============== BatchRunner Implementation ==============
+
+BatchRunner::BatchRunner(const BatchConfig& config) : config_(config) {
+    if (config.runs < 1) {
+        throw std::invalid_argument("Batch run count must be positive");
+    }
+    if (config.ticksPerRun < 1) {
+        throw std::invalid_argument("Ticks per run must be positive");
+    }
+    if (config.callsPerTick < 0.0) {
+        throw std::invalid_argument("Call rate must not be negative");
+    }
+    config_.base.headless = true;
+    config_.base.loggingEnabled = false;
+    config_.base.sharedStateName.clear();
+}
+
+int BatchRunner::getThreadCount() const {
+    int threads = config_.threads;
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    return std::clamp(threads, 1, config_.runs);
+}
+
+RunStats BatchRunner::runOne(const Config& config, int ticks, const TrafficConfig& traffic,
+                             BatchResult& into, const SimulationSnapshot* warmStart) {
+    std::unique_ptr<SimulationEngine> owned =
+        warmStart ? std::make_unique<SimulationEngine>(*warmStart, config)
+                  : std::make_unique<SimulationEngine>(config);
+    SimulationEngine& engine = *owned;
+    TrafficGenerator generator(traffic, engine.getBuilding().getNumFloors());
+    RunStats stats = generator.drive(engine, ticks);
+
+    into.metrics.merge(engine.getBuilding().getMetrics());
+    into.passengers.merge(engine.getPassengerMetrics());
+    return stats;
+}
+
+RunStats BatchRunner::runOne(const Config& config, int ticks, double callsPerTick,
+                             std::uint32_t seed, BatchResult& into,
+                             const SimulationSnapshot* warmStart) {
+    TrafficConfig traffic;
+    traffic.callsPerTick = callsPerTick;
+    traffic.seed = seed;
+    return runOne(config, ticks, traffic, into, warmStart);
+}
+
+BatchResult BatchRunner::run(ControllerType controller) const {
+    Config config = config_.base;
+    config.controllerType = controller;
+    if (config_.warmStart) {
+        ControllerType saved = config_.warmStart->getConfig().controllerType;
+        if (saved != controller) {
+            throw std::invalid_argument("Warm start snapshot was taken with the " +
+                                        controllerToString(saved) + " controller");
+        }
+    }
+
+    int threadCount = getThreadCount();
+    std::vector<BatchResult> partials(threadCount);
+    std::atomic<int> nextRun{0};
+
+    auto begin = std::chrono::steady_clock::now();
+
+    auto worker = [&](BatchResult& local) {
+        for (int run = nextRun.fetch_add(1); run < config_.runs; run = nextRun.fetch_add(1)) {
+            TrafficConfig traffic;
+            traffic.profile = config_.traffic;
+            traffic.callsPerTick = config_.callsPerTick;
+            traffic.seed = config_.seed + static_cast<std::uint32_t>(run);
+            RunStats stats = runOne(config, config_.ticksPerRun, traffic, local,
+                                    config_.warmStart);
+            local.ticks += stats.ticks;
+            local.eventsProcessed += stats.eventsProcessed;
+            ++local.runs;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (int i = 1; i < threadCount; ++i) {
+        threads.emplace_back(worker, std::ref(partials[i]));
+    }
+    worker(partials[0]);  // The caller is worker 0
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    BatchResult result;
+    result.controller = controller;
+    for (const BatchResult& partial : partials) {
+        result.runs += partial.runs;
+        result.ticks += partial.ticks;
+        result.eventsProcessed += partial.eventsProcessed;
+        result.metrics.merge(partial.metrics);
+        result.passengers.merge(partial.passengers);
+    }
+    result.elapsedSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - begin).count();
+    return result;
+}
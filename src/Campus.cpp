@@ -0,0 +1,194 @@
+#include "Campus.hpp"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+// ============== CampusSimulator Implementation ==============
+
+namespace {
+
+int workerThreads(const CampusConfig& config) {
+    int threads = config.threads;
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    // The calling thread is one of them
+    return std::clamp(threads, 1, std::max<int>(1, static_cast<int>(config.shards.size()))) - 1;
+}
+
+} // namespace
+
+CampusSimulator::CampusSimulator(const CampusConfig& config)
+    : config_(config), pool_(workerThreads(config)) {
+    if (config.shards.empty()) {
+        throw std::invalid_argument("Campus needs at least one shard");
+    }
+    if (config.transferShare < 0.0 || config.transferShare > 1.0) {
+        throw std::invalid_argument("Transfer share must be 0-1");
+    }
+    if (config.transferTicks < 0) {
+        throw std::invalid_argument("Transfer time must not be negative");
+    }
+
+    // Engines keep a pointer to their shard's arrival log: never regrow
+    shards_.reserve(config.shards.size());
+    for (size_t i = 0; i < config.shards.size(); ++i) {
+        const ShardConfig& spec = config.shards[i];
+        if (spec.callsPerTick < 0.0) {
+            throw std::invalid_argument("Call rate must not be negative");
+        }
+        if (spec.transferFloor < 1 || spec.transferFloor > spec.config.numFloors) {
+            throw std::invalid_argument("Transfer floor " + std::to_string(spec.transferFloor) +
+                                        " is outside shard " + std::to_string(i));
+        }
+
+        Shard& shard = shards_.emplace_back();
+        shard.spec = spec;
+        if (shard.spec.name.empty()) {
+            shard.spec.name = "shard " + std::to_string(i);
+        }
+        // Shards are the unit of parallelism; a tick's cars run inline
+        shard.spec.config.headless = true;
+        shard.spec.config.loggingEnabled = false;
+        shard.spec.config.sharedStateName.clear();
+        shard.spec.config.carWorkers = 0;
+        shard.engine = std::make_unique<SimulationEngine>(shard.spec.config);
+        shard.engine->setArrivalLog(&shard.arrivals);
+        shard.gen.seed(config.seed + static_cast<std::uint32_t>(i));
+    }
+}
+
+const SimulationEngine& CampusSimulator::getShard(int index) const {
+    return *shards_.at(index).engine;
+}
+
+void CampusSimulator::admit(Shard& shard, const Transfer& transfer, int tick) {
+    if (transfer.destination == shard.spec.transferFloor) {
+        // Trip ends at the lobby it was handed to
+        ++shard.transfersCompleted;
+        shard.transferJourneyTicks.record(tick - transfer.startTick);
+        return;
+    }
+    int id = shard.engine->spawnPassenger(shard.spec.transferFloor, transfer.destination);
+    if (id >= 0) {
+        shard.legs[id] = Leg{-1, transfer.destination, transfer.startTick};
+    }
+}
+
+void CampusSimulator::tickShard(int index) {
+    Shard& shard = shards_[index];
+    SimulationEngine& engine = *shard.engine;
+    const int tick = engine.getCurrentTick();
+    const int numFloors = shard.spec.config.numFloors;
+    const int numShards = static_cast<int>(shards_.size());
+
+    // Riders handed over from other shards whose walk is over
+    size_t kept = 0;
+    for (const Transfer& transfer : shard.inbox) {
+        if (transfer.deliverTick <= tick) {
+            admit(shard, transfer, tick);
+        } else {
+            shard.inbox[kept++] = transfer;
+        }
+    }
+    shard.inbox.resize(kept);
+
+    // Local load: some trips end in another shard, via this shard's lobby
+    std::poisson_distribution<int> arrivals(shard.spec.callsPerTick);
+    std::uniform_int_distribution<int> floorDist(1, numFloors);
+    std::bernoulli_distribution transferDist(numShards > 1 ? config_.transferShare : 0.0);
+    for (int n = arrivals(shard.gen); n > 0; --n) {
+        int origin = floorDist(shard.gen);
+        if (transferDist(shard.gen)) {
+            std::uniform_int_distribution<int> otherDist(0, numShards - 2);
+            int target = otherDist(shard.gen);
+            target += target >= index ? 1 : 0;
+            const ShardConfig& targetSpec = shards_[target].spec;
+            std::uniform_int_distribution<int> destDist(1, targetSpec.config.numFloors);
+            int destination = destDist(shard.gen);
+
+            if (origin == shard.spec.transferFloor) {
+                shard.outbox.push_back({target, destination, tick + 1 + config_.transferTicks, tick});
+                ++shard.transfersOut;
+                continue;
+            }
+            int id = engine.spawnPassenger(origin, shard.spec.transferFloor);
+            if (id >= 0) {
+                shard.legs[id] = Leg{target, destination, tick};
+            }
+        } else if (numFloors > 1) {
+            int destination = floorDist(shard.gen);
+            if (destination != origin) {
+                engine.spawnPassenger(origin, destination);
+            }
+        }
+    }
+
+    engine.runTicks(1);
+
+    // Tracked riders who just alighted either hop on or are done
+    const int now = engine.getCurrentTick();
+    for (const Passenger& p : shard.arrivals) {
+        auto it = shard.legs.find(p.id);
+        if (it == shard.legs.end()) {
+            continue;
+        }
+        const Leg& leg = it->second;
+        if (leg.nextShard >= 0) {
+            shard.outbox.push_back({leg.nextShard, leg.destination,
+                                    now + config_.transferTicks, leg.startTick});
+            ++shard.transfersOut;
+        } else {
+            ++shard.transfersCompleted;
+            shard.transferJourneyTicks.record(now - leg.startTick);
+        }
+        shard.legs.erase(it);
+    }
+    shard.arrivals.clear();
+}
+
+void CampusSimulator::route() {
+    // Shard order, then send order: identical for any thread count
+    for (Shard& from : shards_) {
+        for (const Transfer& transfer : from.outbox) {
+            shards_[transfer.shard].inbox.push_back(transfer);
+        }
+        from.outbox.clear();
+    }
+}
+
+CampusResult CampusSimulator::runTicks(int count) {
+    CampusResult result;
+    std::vector<long long> eventsBefore;
+    eventsBefore.reserve(shards_.size());
+    for (const Shard& shard : shards_) {
+        eventsBefore.push_back(shard.engine->getEventsProcessed());
+    }
+
+    const std::function<void(int)> job = [this](int index) { tickShard(index); };
+    auto begin = std::chrono::steady_clock::now();
+    for (int t = 0; t < count; ++t) {
+        pool_.run(static_cast<int>(shards_.size()), job);  // Barrier per tick
+        route();
+    }
+    result.elapsedSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - begin).count();
+    result.ticks = count > 0 ? count : 0;
+
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        const Shard& shard = shards_[i];
+        ShardResult& out = result.shards.emplace_back();
+        out.name = shard.spec.name;
+        out.eventsProcessed = shard.engine->getEventsProcessed() - eventsBefore[i];
+        out.transfersOut = shard.transfersOut;
+        out.passengers = shard.engine->getPassengerMetrics();
+
+        result.eventsProcessed += out.eventsProcessed;
+        result.transfersSent += shard.transfersOut;
+        result.transfersCompleted += shard.transfersCompleted;
+        result.transferJourneyTicks.merge(shard.transferJourneyTicks);
+        result.passengers.merge(out.passengers);
+    }
+    return result;
+}
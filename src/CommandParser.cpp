@@ -0,0 +1,113 @@
+#include "CommandParser.hpp"
+#include <charconv>
+
+// ============== Command Parser Implementation ==============
+
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+void skipSpace(std::string_view& text) {
+    size_t i = 0;
+    while (i < text.size() && isSpace(text[i])) ++i;
+    text.remove_prefix(i);
+}
+
+std::string_view nextWord(std::string_view& text) {
+    skipSpace(text);
+    size_t i = 0;
+    while (i < text.size() && !isSpace(text[i])) ++i;
+    std::string_view word = text.substr(0, i);
+    text.remove_prefix(i);
+    return word;
+}
+
+bool nextInt(std::string_view& text, int& value) {
+    skipSpace(text);
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+    if (begin != end && *begin == '+') ++begin;
+    auto [ptr, ec] = std::from_chars(begin, end, value);
+    if (ec != std::errc()) {
+        return false;
+    }
+    text.remove_prefix(static_cast<size_t>(ptr - text.data()));
+    return true;
+}
+
+bool nextDirection(std::string_view& text, Direction& dir) {
+    skipSpace(text);
+    if (text.empty()) {
+        return false;
+    }
+    switch (text.front()) {
+        case 'u': case 'U': dir = Direction::Up; return true;
+        case 'd': case 'D': dir = Direction::Down; return true;
+        default: return false;
+    }
+}
+
+}  // namespace
+
+Command parseCommand(std::string_view line) {
+    Command command;
+    command.word = nextWord(line);
+    std::string_view word = command.word;
+
+    if (word.empty() || word.front() == '#') {
+        return command;
+    }
+
+    int a = 0;
+    int b = 0;
+    Direction dir = Direction::Idle;
+    command.kind = CommandKind::Request;
+    if (word == "hall") {
+        if (nextInt(line, a) && nextDirection(line, dir)) {
+            command.request = Request::hallCall(a, dir);
+            return command;
+        }
+        command.usage = "hall <floor> <u|d>";
+    } else if (word == "car") {
+        if (nextInt(line, a) && nextInt(line, b)) {
+            command.request = Request::carCall(a, b);
+            return command;
+        }
+        command.usage = "car <elevator_id> <floor>";
+    } else if (word == "pass") {
+        if (nextInt(line, a) && nextInt(line, b)) {
+            command.request = Request::passenger(a, b);
+            return command;
+        }
+        command.usage = "pass <from_floor> <to_floor>";
+    } else if (word == "dest") {
+        if (nextInt(line, a) && nextInt(line, b)) {
+            command.request = Request::destinationCall(a, b);
+            return command;
+        }
+        command.usage = "dest <from_floor> <to_floor>";
+    } else if (word == "status") {
+        command.kind = CommandKind::Status;
+        return command;
+    } else if (word == "stats") {
+        command.kind = CommandKind::Stats;
+        return command;
+    } else if (word == "metrics") {
+        command.kind = CommandKind::Metrics;
+        return command;
+    } else if (word == "help") {
+        command.kind = CommandKind::Help;
+        return command;
+    } else if (word == "quit" || word == "exit" || word == "q") {
+        command.kind = CommandKind::Quit;
+        return command;
+    } else {
+        command.kind = CommandKind::Unknown;
+        return command;
+    }
+
+    command.kind = CommandKind::BadArgs;
+    return command;
+}
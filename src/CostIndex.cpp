@@ -0,0 +1,109 @@
+#include "CostIndex.hpp"
+#include <cstdlib>
+#include <limits>
+
+// ============== CostIndex Implementation ==============
+
+CostIndex::CostIndex(int numFloors, int numCars)
+    : bucketOf_(numCars, -1), floorOf_(numCars, 0), numFloors_(numFloors) {
+    for (Bucket& bucket : buckets_) {
+        bucket.carsAt.assign(numFloors + 1, 0);
+    }
+}
+
+int CostIndex::classify(const FleetState& fleet, int car) {
+    int bucket = 3;  // Busy at a floor with no direction
+    if (fleet.state[car] == ElevatorState::Idle) {
+        bucket = 0;
+    } else if (fleet.direction[car] == Direction::Up) {
+        bucket = 1;
+    } else if (fleet.direction[car] == Direction::Down) {
+        bucket = 2;
+    }
+    if (fleet.passengers[car] >= fleet.capacity[car]) {
+        bucket += 4;
+    }
+    return bucket;
+}
+
+// Mirrors Elevator::costToServe for any car in `bucket` at `carFloor`
+int CostIndex::costAt(int bucket, int carFloor, int floor, Direction dir) const {
+    int cost = std::abs(carFloor - floor);
+    if (bucket >= 4) {
+        cost += 4 * numFloors_;
+    }
+    switch (bucket & 3) {
+        case 0:
+            return cost;
+        case 1:
+            return (dir == Direction::Up && floor > carFloor) ? cost : cost + 2 * numFloors_;
+        case 2:
+            return (dir == Direction::Down && floor < carFloor) ? cost : cost + 2 * numFloors_;
+        default:
+            return cost + 2 * numFloors_;
+    }
+}
+
+void CostIndex::update(const FleetState& fleet, int car) {
+    int bucket = classify(fleet, car);
+    int floor = fleet.floor[car];
+    int& oldBucket = bucketOf_[car];
+    int& oldFloor = floorOf_[car];
+    if (bucket == oldBucket && floor == oldFloor) {
+        return;
+    }
+
+    std::uint64_t bit = std::uint64_t{1} << car;
+    if (oldBucket >= 0) {
+        Bucket& from = buckets_[oldBucket];
+        if ((from.carsAt[oldFloor] &= ~bit) == 0) {
+            from.occupied.reset(oldFloor);
+            if (from.occupied.empty()) {
+                liveBuckets_ &= ~(1u << oldBucket);
+            }
+        }
+    }
+    Bucket& to = buckets_[bucket];
+    to.carsAt[floor] |= bit;
+    to.occupied.set(floor);
+    liveBuckets_ |= 1u << bucket;
+    oldBucket = bucket;
+    oldFloor = floor;
+}
+
+void CostIndex::rebuild(const FleetState& fleet) {
+    *this = CostIndex(numFloors_, fleet.size());
+    for (int car = 0; car < fleet.size(); ++car) {
+        update(fleet, car);
+    }
+}
+
+int CostIndex::bestCar(int floor, Direction dir) const {
+    int bestCar = -1;
+    int bestCost = std::numeric_limits<int>::max();
+
+    auto consider = [&](int bucket, int carFloor) {
+        if (carFloor < 0) {
+            return;
+        }
+        int cost = costAt(bucket, carFloor, floor, dir);
+        int car = __builtin_ctzll(buckets_[bucket].carsAt[carFloor]);
+        if (cost < bestCost || (cost == bestCost && car < bestCar)) {
+            bestCost = cost;
+            bestCar = car;
+        }
+    };
+
+    // Within a bucket the cost only grows with distance on each side of
+    // the call, so the nearest occupied floor per side is the only candidate
+    for (unsigned live = liveBuckets_; live; live &= live - 1) {
+        int bucket = __builtin_ctz(live);
+        const FloorMask& occupied = buckets_[bucket].occupied;
+        if (occupied.test(floor)) {
+            consider(bucket, floor);
+        }
+        consider(bucket, occupied.nextBelow(floor));
+        consider(bucket, occupied.nextAbove(floor));
+    }
+    return bestCar;
+}
@@ -1,5 +1,6 @@
 #include "Domain.hpp"
 #include <algorithm>
+#include <limits>
 #include <stdexcept>
 
 // ============== Floor Implementation ==============
@@ -18,156 +19,168 @@ int Floor::getNumber() const { return floorNumber_; }
 // ============== Elevator Implementation ==============
 
 Elevator::Elevator(int id, int capacity, int startFloor)
-    : id_(id), currentFloor_(startFloor), capacity_(capacity) {}
+    : ownedFleet_(std::make_unique<FleetState>(1, capacity, startFloor)),
+      fleet_(ownedFleet_.get()), index_(0), id_(id) {}
 
-int Elevator::getId() const { 
-    std::lock_guard<std::mutex> lock(mutex_);
-    return id_; 
+Elevator::Elevator(FleetState& fleet, int id, CostIndex* costIndex)
+    : fleet_(&fleet), costIndex_(costIndex), index_(id), id_(id) {}
+
+void Elevator::setCostIndex(CostIndex* costIndex) {
+    costIndex_ = costIndex;
 }
 
+void Elevator::reindex() {
+    if (costIndex_) {
+        costIndex_->update(*fleet_, index_);
+    }
+}
+
+int Elevator::getId() const { return id_; }
+
 int Elevator::getCurrentFloor() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return currentFloor_;
+    return fleet_->floor[index_];
 }
 
 Direction Elevator::getDirection() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return direction_;
+    return fleet_->direction[index_];
 }
 
 ElevatorState Elevator::getState() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return state_;
+    return fleet_->state[index_];
 }
 
 int Elevator::getPassengerCount() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return passengerCount_;
+    return fleet_->passengers[index_];
 }
 
 int Elevator::getCapacity() const {
-    return capacity_;  // Immutable, no lock needed
+    return fleet_->capacity[index_];
 }
 
-std::set<int> Elevator::getCarCalls() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return carCalls_;
+FloorMask Elevator::getCarCalls() const {
+    return fleet_->carCalls[index_];
 }
 
 int Elevator::getTicksRemaining() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return ticksRemaining_;
+    return fleet_->ticksRemaining[index_];
 }
 
 void Elevator::addCarCall(int floor) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    carCalls_.insert(floor);
+    fleet_->carCalls[index_].set(floor);
 }
 
 void Elevator::removeCarCall(int floor) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    carCalls_.erase(floor);
+    fleet_->carCalls[index_].reset(floor);
 }
 
 bool Elevator::hasCarCallAt(int floor) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return carCalls_.count(floor) > 0;
+    return fleet_->carCalls[index_].test(floor);
 }
 
 bool Elevator::hasAnyCarCalls() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return !carCalls_.empty();
+    return fleet_->carCalls[index_].any();
 }
 
 void Elevator::startMoving(Direction dir, int ticksToArrive) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    direction_ = dir;
-    state_ = ElevatorState::Moving;
-    ticksRemaining_ = ticksToArrive;
+    fleet_->direction[index_] = dir;
+    fleet_->state[index_] = ElevatorState::Moving;
+    fleet_->ticksRemaining[index_] = ticksToArrive;
+    fleet_->runFloors[index_] = 1;
+    reindex();
 }
 
 void Elevator::decrementTick() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (ticksRemaining_ > 0) {
-        --ticksRemaining_;
+    int& ticks = fleet_->ticksRemaining[index_];
+    if (ticks > 0) {
+        --ticks;
     }
 }
 
-void Elevator::arriveAtFloor(int floor) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    currentFloor_ = floor;
-    state_ = ElevatorState::DoorsOpening;
+void Elevator::arriveAtFloor(int floor, int ticksToOpen) {
+    fleet_->floor[index_] = floor;
+    fleet_->state[index_] = ElevatorState::DoorsOpening;
+    fleet_->ticksRemaining[index_] = ticksToOpen;
+    fleet_->runFloors[index_] = 0;
+    reindex();
+}
+
+void Elevator::passFloor(int floor, int ticksToNext) {
+    fleet_->floor[index_] = floor;
+    fleet_->ticksRemaining[index_] = ticksToNext;
+    ++fleet_->runFloors[index_];
+    reindex();
 }
 
 void Elevator::openDoors(int ticksToOpen) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    state_ = ElevatorState::DoorsOpening;
-    ticksRemaining_ = ticksToOpen;
+    fleet_->state[index_] = ElevatorState::DoorsOpening;
+    fleet_->ticksRemaining[index_] = ticksToOpen;
+    reindex();
 }
 
 void Elevator::setDoorsOpen(int ticksOpen) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    state_ = ElevatorState::DoorsOpen;
-    ticksRemaining_ = ticksOpen;
+    fleet_->state[index_] = ElevatorState::DoorsOpen;
+    fleet_->ticksRemaining[index_] = ticksOpen;
+    reindex();
 }
 
 void Elevator::closeDoors(int ticksToClose) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    state_ = ElevatorState::DoorsClosing;
-    ticksRemaining_ = ticksToClose;
+    fleet_->state[index_] = ElevatorState::DoorsClosing;
+    fleet_->ticksRemaining[index_] = ticksToClose;
+    reindex();
 }
 
 void Elevator::setIdle() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    state_ = ElevatorState::Idle;
-    direction_ = Direction::Idle;
-    ticksRemaining_ = 0;
+    fleet_->state[index_] = ElevatorState::Idle;
+    fleet_->direction[index_] = Direction::Idle;
+    fleet_->ticksRemaining[index_] = 0;
+    reindex();
 }
 
 bool Elevator::hasCallsAbove() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return std::any_of(carCalls_.begin(), carCalls_.end(),
-        [this](int f) { return f > currentFloor_; });
+    return fleet_->carCalls[index_].anyAbove(fleet_->floor[index_]);
 }
 
 bool Elevator::hasCallsBelow() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return std::any_of(carCalls_.begin(), carCalls_.end(),
-        [this](int f) { return f < currentFloor_; });
+    return fleet_->carCalls[index_].anyBelow(fleet_->floor[index_]);
 }
 
 std::optional<int> Elevator::getNextCarCallInDirection() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+    const FloorMask& carCalls = fleet_->carCalls[index_];
+    int currentFloor = fleet_->floor[index_];
+    Direction direction = fleet_->direction[index_];
     
-    if (carCalls_.empty()) return std::nullopt;
+    if (carCalls.empty()) return std::nullopt;
     
-    if (direction_ == Direction::Up) {
-        auto it = carCalls_.upper_bound(currentFloor_);
-        if (it != carCalls_.end()) return *it;
-    } else if (direction_ == Direction::Down) {
-        auto it = carCalls_.lower_bound(currentFloor_);
-        if (it != carCalls_.begin()) return *std::prev(it);
+    if (direction == Direction::Up) {
+        int next = carCalls.nextAbove(currentFloor);
+        if (next >= 0) return next;
+    } else if (direction == Direction::Down) {
+        int next = carCalls.nextBelow(currentFloor);
+        if (next >= 0) return next;
     }
     
     // No calls in current direction, return closest
-    return *std::min_element(carCalls_.begin(), carCalls_.end(),
-        [this](int a, int b) {
-            return std::abs(a - currentFloor_) < std::abs(b - currentFloor_);
-        });
+    return carCalls.nearest(currentFloor);
 }
 
 int Elevator::costToServe(int floor, Direction dir, int numFloors) const {
-    std::lock_guard<std::mutex> lock(mutex_);
+    int currentFloor = fleet_->floor[index_];
+    Direction direction = fleet_->direction[index_];
     
-    int distance = std::abs(currentFloor_ - floor);
+    int distance = std::abs(currentFloor - floor);
+    
+    // A full car can only pick up after dropping someone off
+    if (!canBoard()) {
+        distance += 4 * numFloors;
+    }
     
-    if (state_ == ElevatorState::Idle) {
+    if (fleet_->state[index_] == ElevatorState::Idle) {
         return distance;
     }
     
-    bool sameDirection = (direction_ == dir);
-    bool onTheWay = (direction_ == Direction::Up && floor > currentFloor_) ||
-                    (direction_ == Direction::Down && floor < currentFloor_);
+    bool sameDirection = (direction == dir);
+    bool onTheWay = (direction == Direction::Up && floor > currentFloor) ||
+                    (direction == Direction::Down && floor < currentFloor);
     
     if (sameDirection && onTheWay) {
         return distance;
@@ -178,40 +191,59 @@ int Elevator::costToServe(int floor, Direction dir, int numFloors) const {
 }
 
 bool Elevator::canBoard() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return passengerCount_ < capacity_;
+    return fleet_->passengers[index_] < fleet_->capacity[index_];
 }
 
 void Elevator::boardPassenger() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (passengerCount_ < capacity_) {
-        ++passengerCount_;
+    if (canBoard()) {
+        ++fleet_->passengers[index_];
+        reindex();
     }
 }
 
 void Elevator::alightPassenger() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (passengerCount_ > 0) {
-        --passengerCount_;
+    int& count = fleet_->passengers[index_];
+    if (count > 0) {
+        --count;
+        reindex();
     }
 }
 
 // ============== Building Implementation ==============
 
-Building::Building(const Config& config) : config_(config) {
+Building::Building(const Config& config)
+    : config_(config), motion_(config), snapshot_(std::clamp(config.numElevators, 0, kMaxElevators)) {
+    if (config.numFloors < 1 || config.numFloors > kMaxFloors) {
+        throw std::invalid_argument("Floor count must be 1-" + std::to_string(kMaxFloors));
+    }
+    if (config.numElevators < 1 || config.numElevators > kMaxElevators) {
+        throw std::invalid_argument("Elevator count must be 1-" + std::to_string(kMaxElevators));
+    }
+    
     // Create floors (1-indexed)
     floors_.reserve(config.numFloors);
     for (int i = 1; i <= config.numFloors; ++i) {
         floors_.emplace_back(i);
     }
     
-    // Create elevators
+    // Create elevators: one fleet slot each, plus a handle onto it
+    fleet_ = FleetState(config.numElevators, config.carCapacity, 1);
+    costIndex_ = CostIndex(config.numFloors, config.numElevators);
+    costIndex_.rebuild(fleet_);
     elevators_.reserve(config.numElevators);
     for (int i = 0; i < config.numElevators; ++i) {
-        elevators_.push_back(
-            std::make_unique<Elevator>(i, config.carCapacity, 1)
-        );
+        elevators_.emplace_back(fleet_, i, &costIndex_);
+    }
+    
+    upCallSince_.assign(config.numFloors + 1, -1);
+    downCallSince_.assign(config.numFloors + 1, -1);
+    carCallSince_.assign(static_cast<size_t>(config.numElevators) * (config.numFloors + 1), -1);
+    
+    if (!config.sharedStateName.empty()) {
+        sharedState_ = std::make_unique<SharedStateWriter>(
+            config.sharedStateName, config.numFloors, config.numElevators);
     }
+    publishSnapshot(0);
 }
 
 int Building::getNumFloors() const { return config_.numFloors; }
@@ -222,14 +254,46 @@ Elevator& Building::getElevator(int id) {
     if (!isValidElevator(id)) {
         throw std::out_of_range("Invalid elevator ID: " + std::to_string(id));
     }
-    return *elevators_[id];
+    return elevators_[id];
 }
 
 const Elevator& Building::getElevator(int id) const {
     if (!isValidElevator(id)) {
         throw std::out_of_range("Invalid elevator ID: " + std::to_string(id));
     }
-    return *elevators_[id];
+    return elevators_[id];
+}
+
+FleetState& Building::getFleet() { return fleet_; }
+const FleetState& Building::getFleet() const { return fleet_; }
+const CostIndex& Building::getCostIndex() const { return costIndex_; }
+
+void Building::suspendCostIndex() {
+    for (Elevator& elev : elevators_) {
+        elev.setCostIndex(nullptr);
+    }
+}
+
+void Building::resumeCostIndex() {
+    for (int i = 0; i < fleet_.size(); ++i) {
+        elevators_[i].setCostIndex(&costIndex_);
+        costIndex_.update(fleet_, i);
+    }
+}
+
+void Building::publishSnapshot(int tick) {
+    snapshot_.publish(tick, fleet_, upCalls_, downCalls_);
+    if (sharedState_) {
+        sharedState_->publish(tick, fleet_, upCalls_, downCalls_);
+    }
+}
+
+FleetSnapshot Building::getSnapshot() const {
+    return snapshot_.read();
+}
+
+void Building::readSnapshot(FleetSnapshot& out) const {
+    snapshot_.read(out);
 }
 
 Floor& Building::getFloor(int number) {
@@ -246,59 +310,169 @@ const Floor& Building::getFloor(int number) const {
     return floors_[number - 1];
 }
 
+void Building::setCurrentTick(int tick) { currentTick_ = tick; }
+int Building::getCurrentTick() const { return currentTick_; }
+
 void Building::registerHallCall(int floor, Direction dir) {
-    std::lock_guard<std::mutex> lock(mutex_);
     if (!isValidFloor(floor)) return;
     
     Floor& f = floors_[floor - 1];
     if (dir == Direction::Up) {
+        if (!upCalls_.test(floor)) upCallSince_[floor] = currentTick_;
+        upCalls_.set(floor);
         f.pressUpButton();
     } else if (dir == Direction::Down) {
+        if (!downCalls_.test(floor)) downCallSince_[floor] = currentTick_;
+        downCalls_.set(floor);
         f.pressDownButton();
     }
 }
 
 void Building::clearHallCall(int floor, Direction dir) {
-    std::lock_guard<std::mutex> lock(mutex_);
     if (!isValidFloor(floor)) return;
     
+    std::lock_guard<ProfiledMutex> lock(callMutex_);
     Floor& f = floors_[floor - 1];
     if (dir == Direction::Up) {
+        if (upCalls_.test(floor)) metrics_.waitTicks.record(currentTick_ - upCallSince_[floor]);
+        upCalls_.reset(floor);
         f.clearUpButton();
     } else if (dir == Direction::Down) {
+        if (downCalls_.test(floor)) metrics_.waitTicks.record(currentTick_ - downCallSince_[floor]);
+        downCalls_.reset(floor);
         f.clearDownButton();
     }
 }
 
 bool Building::hasHallCall(int floor, Direction dir) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!isValidFloor(floor)) return false;
-    
-    const Floor& f = floors_[floor - 1];
     if (dir == Direction::Up) {
-        return f.isUpPressed();
+        return upCalls_.test(floor);
     } else if (dir == Direction::Down) {
-        return f.isDownPressed();
+        return downCalls_.test(floor);
     }
     return false;
 }
 
+bool Building::hasAnyHallCalls() const {
+    return upCalls_.any() || downCalls_.any();
+}
+
+const FloorMask& Building::getHallCallMask(Direction dir) const {
+    return dir == Direction::Down ? downCalls_ : upCalls_;
+}
+
+void Building::registerCarCall(int elevatorId, int floor) {
+    Elevator& elev = getElevator(elevatorId);
+    if (!isValidFloor(floor)) return;
+    
+    if (!elev.hasCarCallAt(floor)) {
+        carCallSince_[static_cast<size_t>(elevatorId) * (config_.numFloors + 1) + floor] = currentTick_;
+    }
+    elev.addCarCall(floor);
+}
+
+void Building::clearCarCall(int elevatorId, int floor) {
+    Elevator& elev = getElevator(elevatorId);
+    if (!elev.hasCarCallAt(floor)) return;
+    
+    int since = carCallSince_[static_cast<size_t>(elevatorId) * (config_.numFloors + 1) + floor];
+    {
+        std::lock_guard<ProfiledMutex> lock(callMutex_);
+        metrics_.travelTicks.record(currentTick_ - since);
+    }
+    elev.removeCarCall(floor);
+}
+
+const CallMetrics& Building::getMetrics() const { return metrics_; }
+void Building::resetMetrics() { metrics_.clear(); }
+void Building::recordFloorTraveled(int floors) { metrics_.floorsTraveled += floors; }
+
+void Building::recordTrips(int trips, const TripEnergy& energy) {
+    metrics_.trips += trips;
+    metrics_.energyDrawn += energy.drawn;
+    metrics_.energyRegenerated += energy.regenerated;
+}
+
 std::vector<std::pair<int, Direction>> Building::getAllHallCalls() const {
-    std::lock_guard<std::mutex> lock(mutex_);
     std::vector<std::pair<int, Direction>> calls;
     
-    for (const auto& floor : floors_) {
-        if (floor.isUpPressed()) {
-            calls.emplace_back(floor.getNumber(), Direction::Up);
+    for (int floor : upCalls_ | downCalls_) {
+        if (upCalls_.test(floor)) {
+            calls.emplace_back(floor, Direction::Up);
         }
-        if (floor.isDownPressed()) {
-            calls.emplace_back(floor.getNumber(), Direction::Down);
+        if (downCalls_.test(floor)) {
+            calls.emplace_back(floor, Direction::Down);
         }
     }
     
     return calls;
 }
 
+void Building::saveState(SnapshotWriter& out) const {
+    for (int i = 0; i < fleet_.size(); ++i) {
+        out.putInt(fleet_.floor[i]);
+        out.putEnum(fleet_.direction[i]);
+        out.putEnum(fleet_.state[i]);
+        out.putInt(fleet_.ticksRemaining[i]);
+        out.putInt(fleet_.passengers[i]);
+        out.putInt(fleet_.runFloors[i]);
+        out.putMask(fleet_.carCalls[i]);
+        for (int floor : fleet_.carCalls[i]) {
+            out.putInt(carCallSince_[static_cast<size_t>(i) * (config_.numFloors + 1) + floor]);
+        }
+    }
+    
+    // Pending hall calls with the tick each was registered
+    out.putMask(upCalls_);
+    for (int floor : upCalls_) {
+        out.putInt(upCallSince_[floor]);
+    }
+    out.putMask(downCalls_);
+    for (int floor : downCalls_) {
+        out.putInt(downCallSince_[floor]);
+    }
+}
+
+void Building::loadState(SnapshotReader& in) {
+    const int numFloors = config_.numFloors;
+    std::fill(carCallSince_.begin(), carCallSince_.end(), -1);
+    for (int i = 0; i < fleet_.size(); ++i) {
+        fleet_.floor[i] = in.getInt(1, numFloors);
+        fleet_.direction[i] = in.getEnum(Direction::Idle);
+        fleet_.state[i] = in.getEnum(ElevatorState::DoorsClosing);
+        fleet_.ticksRemaining[i] = in.getInt(0, std::numeric_limits<int>::max());
+        fleet_.passengers[i] = in.getInt(0, fleet_.capacity[i]);
+        fleet_.runFloors[i] = in.getInt(0, numFloors);
+        fleet_.carCalls[i] = in.getMask(numFloors);
+        for (int floor : fleet_.carCalls[i]) {
+            carCallSince_[static_cast<size_t>(i) * (numFloors + 1) + floor] = in.getInt();
+        }
+    }
+    
+    std::fill(upCallSince_.begin(), upCallSince_.end(), -1);
+    std::fill(downCallSince_.begin(), downCallSince_.end(), -1);
+    upCalls_ = in.getMask(numFloors);
+    for (int floor : upCalls_) {
+        upCallSince_[floor] = in.getInt();
+    }
+    downCalls_ = in.getMask(numFloors);
+    for (int floor : downCalls_) {
+        downCallSince_[floor] = in.getInt();
+    }
+    
+    // Floor buttons mirror the registry
+    for (Floor& f : floors_) {
+        f.clearUpButton();
+        f.clearDownButton();
+        if (upCalls_.test(f.getNumber())) f.pressUpButton();
+        if (downCalls_.test(f.getNumber())) f.pressDownButton();
+    }
+    
+    metrics_.clear();
+    costIndex_.rebuild(fleet_);
+    publishSnapshot(currentTick_);
+}
+
 bool Building::isValidFloor(int floor) const {
     return floor >= 1 && floor <= config_.numFloors;
 }
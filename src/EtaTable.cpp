@@ -0,0 +1,139 @@
+#include "EtaTable.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+// ============== EtaTable Implementation ==============
+
+EtaTable::EtaTable(const Config& config, int numCars)
+    : numFloors_(config.numFloors), slots_(hallCallSlot(config.numFloors + 1, Direction::Up)),
+      travelTicks_(std::max(1, config.floorTravelTicks)),
+      stopTicks_(std::max(0, config.doorOpenTicks) + 2),
+      doorOpenTicks_(std::max(0, config.doorOpenTicks)),
+      keys_(numCars), eta_(static_cast<size_t>(numCars) * slots_, 0),
+      sweepBack_(static_cast<size_t>(numCars) * (config.numFloors + 2), 0),
+      refreshes_(numCars, 0) {}
+
+bool EtaTable::update(const FleetState& fleet, int car, const FloorMask& stops,
+                      Direction heading) {
+    Key key;
+    key.floor = fleet.floor[car];
+    key.state = fleet.state[car];
+    key.direction = fleet.direction[car];
+    key.heading = key.state == ElevatorState::Moving ? key.direction : heading;
+    key.full = fleet.passengers[car] >= fleet.capacity[car];
+    key.stops = stops;
+    if (key == keys_[car]) {
+        return false;
+    }
+    keys_[car] = key;
+    compute(car, key);
+    ++refreshes_[car];
+    return true;
+}
+
+long long EtaTable::getRefreshCount() const {
+    long long total = 0;
+    for (long long n : refreshes_) total += n;
+    return total;
+}
+
+void EtaTable::compute(int car, const Key& key) {
+    int* row = &eta_[static_cast<size_t>(car) * slots_];
+    int* sweepBack = &sweepBack_[static_cast<size_t>(car) * (numFloors_ + 2)];
+    std::fill(row, row + slots_, -1);
+    auto at = [row](int floor, Direction dir) -> int& {
+        return row[hallCallSlot(floor, dir)];
+    };
+    auto setOnce = [&](int floor, Direction dir, int t) {
+        int& slot = at(floor, dir);
+        if (slot < 0) slot = t;
+    };
+
+    const int p = key.floor;
+    const FloorMask& stops = key.stops;
+    const bool moving = key.state == ElevatorState::Moving;
+
+    // Ticks (beyond the live timer) until a stationary car can leave p;
+    // a moving car reaches the next floor when its timer runs out
+    int ready = 0;
+    switch (key.state) {
+        case ElevatorState::DoorsOpening: ready = doorOpenTicks_ + 1; break;
+        case ElevatorState::DoorsOpen: ready = 1; break;
+        default: break;
+    }
+
+    if (key.heading == Direction::Idle) {
+        // Nowhere to go first: straight to the call
+        int start = ready + (!moving && stops.test(p) ? stopTicks_ : 0);
+        for (int f = 1; f <= numFloors_; ++f) {
+            int t = f == p ? ready : start + std::abs(f - p) * travelTicks_;
+            at(f, Direction::Up) = t;
+            at(f, Direction::Down) = t;
+        }
+    } else {
+        const Direction u = key.heading;
+        const Direction back = u == Direction::Up ? Direction::Down : Direction::Up;
+        const int sign = u == Direction::Up ? 1 : -1;
+        auto inShaft = [this](int f) { return f >= 1 && f <= numFloors_; };
+        auto behind = [&](int f) { return moving ? (f - p) * sign <= 0 : (f - p) * sign < 0; };
+
+        // Leg 1: on in the heading to the farthest stop ahead (a moving car
+        // at least to the next floor), turning there for reverse calls
+        int t = -travelTicks_;  // A moving car is "at" p one floor's travel ago
+        if (!moving) {
+            at(p, Direction::Up) = ready;
+            at(p, Direction::Down) = ready;
+            t = ready + (stops.test(p) ? stopTicks_ : 0);
+        }
+        int farthest = u == Direction::Up ? stops.highest() : stops.lowest();
+        int last = farthest >= 0 && (farthest - p) * sign > 0 ? farthest : (moving ? p + sign : p);
+        if (!inShaft(last)) {
+            last = p;
+        }
+        int turn = t;
+        for (int f = p + sign; inShaft(f); f += sign) {
+            t += travelTicks_;
+            setOnce(f, u, t);
+            if ((f - last) * sign >= 0) {
+                setOnce(f, back, t);  // Carries on to the call and turns there
+            }
+            if ((f - last) * sign <= 0 && stops.test(f)) {
+                t += stopTicks_;
+            }
+            if (f == last) {
+                turn = t;
+            }
+        }
+
+        // Leg 2: back from the turn, serving the stops behind p
+        t = turn;
+        for (int f = last - sign; inShaft(f); f -= sign) {
+            t += travelTicks_;
+            sweepBack[f] = t;
+            setOnce(f, back, t);
+            if (behind(f) && stops.test(f)) {
+                t += stopTicks_;
+            }
+        }
+
+        // Leg 3: heading-direction calls behind p. Past the last stop
+        // behind, the car goes to the call and turns there; short of it,
+        // the car turns at that stop and comes back.
+        int farthestBehind = u == Direction::Up ? stops.lowest() : stops.highest();
+        bool anyBehind = farthestBehind >= 0 && behind(farthestBehind);
+        for (int f = p - (moving ? 0 : sign); inShaft(f); f -= sign) {
+            if (!anyBehind || (f - farthestBehind) * sign <= 0) {
+                setOnce(f, u, sweepBack[f]);
+            } else {
+                int leave = sweepBack[farthestBehind] + stopTicks_;
+                setOnce(f, u, leave + std::abs(f - farthestBehind) * travelTicks_);
+            }
+        }
+    }
+
+    // A full car picks up only after dropping someone off (as costToServe)
+    int penalty = key.full ? 4 * numFloors_ * travelTicks_ : 0;
+    for (int i = 0; i < slots_; ++i) {
+        row[i] = std::max(row[i], 0) + penalty;
+    }
+}
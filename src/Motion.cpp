@@ -0,0 +1,136 @@
+#include "Motion.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+constexpr double kGravity = 9.81;
+constexpr int kBisectSteps = 64;
+
+}  // namespace
+
+// ============== Motion Profile Implementation ==============
+
+MotionProfile::MotionProfile(const Config& config)
+    : kinematic_(config.motionModel == MotionModel::Kinematic),
+      travelTicks_(config.floorTravelTicks), params_(config.motion) {
+    if (!kinematic_) {
+        return;
+    }
+    const MotionParams& p = params_;
+    if (!(p.floorHeight > 0.0 && p.maxSpeed > 0.0 && p.maxAccel > 0.0 && p.maxJerk > 0.0)) {
+        throw std::invalid_argument("Motion profile needs positive floor height, speed, "
+                                    "acceleration and jerk");
+    }
+    if (!(p.driveEfficiency > 0.0 && p.driveEfficiency <= 1.0 &&
+          p.regenEfficiency > 0.0 && p.regenEfficiency <= 1.0)) {
+        throw std::invalid_argument("Drive and regeneration efficiencies must be in (0, 1]");
+    }
+    if (config.tickDurationMs < 1) {
+        throw std::invalid_argument("Kinematic motion needs a positive tick duration");
+    }
+
+    // Cumulative free-run ticks per floor, then the braking remainder that
+    // makes an n-floor run take runTime ticks
+    const double tick = config.tickDurationMs / 1000.0;
+    const int floors = std::max(1, config.numFloors);
+    passTicks_.assign(floors + 1, 1);
+    brakeTicks_.assign(floors + 1, 0);
+    runSpeed_.assign(floors + 1, 0.0);
+    long long elapsed = 0;
+    for (int k = 1; k <= floors; ++k) {
+        long long reached = std::llround(freeRunTime(k * p.floorHeight) / tick);
+        passTicks_[k] = static_cast<int>(std::max(1LL, reached - elapsed));
+        elapsed += passTicks_[k];
+        long long run = std::llround(runTime(k * p.floorHeight) / tick);
+        brakeTicks_[k] = static_cast<int>(std::max(0LL, run - elapsed));
+        runSpeed_[k] = peakSpeed(k * p.floorHeight);
+    }
+}
+
+double MotionProfile::accelTime(double speed) const {
+    const double a = params_.maxAccel;
+    const double j = params_.maxJerk;
+    // Reaches maxAccel only if the speed change is at least a^2 / j
+    return speed >= a * a / j ? speed / a + a / j : 2.0 * std::sqrt(speed / j);
+}
+
+double MotionProfile::freeRunDistance(double time) const {
+    const double v = params_.maxSpeed;
+    const double j = params_.maxJerk;
+    const double ta = accelTime(v);
+    const double tj = std::min(params_.maxAccel / j, ta / 2.0);  // Jerk phase length
+    if (time >= ta) {
+        return v * ta / 2.0 + v * (time - ta);  // Cruising
+    }
+    if (time <= tj) {
+        return j * time * time * time / 6.0;
+    }
+    if (time <= ta - tj) {
+        // Constant acceleration after the first jerk phase
+        double tau = time - tj;
+        return j * tj * tj * tj / 6.0 + j * tj * tj / 2.0 * tau + j * tj * tau * tau / 2.0;
+    }
+    // Easing into maxSpeed: the mirror image of the first jerk phase
+    double u = ta - time;
+    return v * ta / 2.0 - (v * u - j * u * u * u / 6.0);
+}
+
+double MotionProfile::peakSpeed(double distance) const {
+    // Accelerating 0 -> v and braking back covers v x accelTime(v), which
+    // grows with v
+    const double v = params_.maxSpeed;
+    if (distance >= v * accelTime(v)) {
+        return v;
+    }
+    double lo = 0.0;
+    double hi = v;
+    for (int i = 0; i < kBisectSteps; ++i) {
+        double mid = (lo + hi) / 2.0;
+        (mid * accelTime(mid) < distance ? lo : hi) = mid;
+    }
+    return (lo + hi) / 2.0;
+}
+
+double MotionProfile::runTime(double distance) const {
+    if (distance <= 0.0) {
+        return 0.0;
+    }
+    double peak = peakSpeed(distance);
+    double ramp = accelTime(peak);
+    return 2.0 * ramp + std::max(0.0, distance - peak * ramp) / peak;
+}
+
+double MotionProfile::freeRunTime(double distance) const {
+    double lo = 0.0;
+    double hi = accelTime(params_.maxSpeed) + distance / params_.maxSpeed;
+    for (int i = 0; i < kBisectSteps; ++i) {
+        double mid = (lo + hi) / 2.0;
+        (freeRunDistance(mid) < distance ? lo : hi) = mid;
+    }
+    return (lo + hi) / 2.0;
+}
+
+TripEnergy MotionProfile::tripEnergy(int floors, Direction dir, int passengers,
+                                     int capacity) const {
+    TripEnergy energy;
+    if (!kinematic_ || floors <= 0) {
+        return energy;
+    }
+    const MotionParams& p = params_;
+    double distance = floors * p.floorHeight;
+    double load = passengers * p.passengerMass;
+    double counterweight = p.carMass + p.counterweightLoad * capacity * p.passengerMass;
+    double speed = floors < static_cast<int>(runSpeed_.size()) ? runSpeed_[floors]
+                                                               : peakSpeed(distance);
+
+    double kinetic = 0.5 * (p.carMass + load + counterweight) * speed * speed;
+    double rise = dir == Direction::Down ? -distance : distance;
+    double potential = (p.carMass + load - counterweight) * kGravity * rise;
+
+    double motoring = kinetic + p.frictionForce * distance + std::max(0.0, potential);
+    double generating = kinetic + std::max(0.0, -potential);
+    energy.drawn = motoring / p.driveEfficiency;
+    energy.regenerated = generating * p.regenEfficiency;
+    return energy;
+}
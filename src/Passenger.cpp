@@ -0,0 +1,178 @@
+#include "Passenger.hpp"
+#include <limits>
+
+// ============== PassengerModel Implementation ==============
+
+PassengerModel::PassengerModel(Building& building)
+    : building_(building),
+      waitingUp_(building.getNumFloors() + 1),
+      waitingDown_(building.getNumFloors() + 1),
+      riding_(building.getNumElevators()) {}
+
+std::deque<Passenger>& PassengerModel::waiting(int floor, Direction dir) {
+    return dir == Direction::Down ? waitingDown_[floor] : waitingUp_[floor];
+}
+
+int PassengerModel::spawn(int origin, int destination, int tick) {
+    if (!building_.isValidFloor(origin) || !building_.isValidFloor(destination) ||
+        origin == destination) {
+        return -1;
+    }
+
+    Passenger passenger;
+    passenger.id = nextId_++;
+    passenger.origin = origin;
+    passenger.destination = destination;
+    passenger.arrivalTick = tick;
+    waiting(origin, passenger.direction()).push_back(passenger);
+
+    metrics_.spawned.store(metrics_.spawned.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);
+    metrics_.waiting.store(metrics_.waiting.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);
+    return passenger.id;
+}
+
+void PassengerModel::exchange(int car, int floor, int tick, IScheduler& scheduler) {
+    Elevator& elev = building_.getElevator(car);
+    std::vector<Passenger>& riders = riding_[car];
+
+    // Alight everyone bound for this floor
+    int alighted = 0;
+    for (size_t i = 0; i < riders.size();) {
+        const Passenger& p = riders[i];
+        if (p.destination != floor) {
+            ++i;
+            continue;
+        }
+        metrics_.journeyTicks.record(tick - p.arrivalTick);
+        metrics_.rideTicks.record(tick - p.boardTick);
+        elev.alightPassenger();
+        ++alighted;
+        if (arrivals_) {
+            arrivals_->push_back(p);
+        }
+        riders[i] = riders.back();
+        riders.pop_back();
+    }
+
+    // Board one direction per stop: the car's own, else whoever is waiting
+    Direction boardDir = (elev.getDirection() == Direction::Down) ? Direction::Down
+                                                                  : Direction::Up;
+    if (waiting(floor, boardDir).empty()) {
+        boardDir = (boardDir == Direction::Up) ? Direction::Down : Direction::Up;
+    }
+
+    // FIFO among the riders the scheduler lets on (destination dispatch
+    // only takes those allocated to this car)
+    std::deque<Passenger>& queue = waiting(floor, boardDir);
+    int boarded = 0;
+    for (auto it = queue.begin(); it != queue.end() && elev.canBoard();) {
+        if (!scheduler.acceptsPassenger(car, floor, it->destination)) {
+            ++it;
+            continue;
+        }
+        Passenger p = *it;
+        it = queue.erase(it);
+        p.boardTick = tick;
+        metrics_.waitTicks.record(tick - p.arrivalTick);
+        elev.boardPassenger();
+        riders.push_back(p);
+        ++boarded;
+        scheduler.handleCarCall(car, p.destination);
+    }
+
+    if (alighted || boarded) {
+        auto adjust = [](auto& counter, int by) {
+            counter.store(counter.load(std::memory_order_relaxed) + by,
+                          std::memory_order_relaxed);
+        };
+        adjust(metrics_.delivered, alighted);
+        adjust(metrics_.riding, boarded - alighted);
+        adjust(metrics_.waiting, -boarded);
+    }
+
+    // Arrival cleared the hall call; anyone still here calls again (a
+    // scheduler that already has their trip ignores the repeat)
+    for (Direction dir : {Direction::Up, Direction::Down}) {
+        for (const Passenger& p : waiting(floor, dir)) {
+            scheduler.handlePassengerCall(floor, p.destination);
+        }
+    }
+}
+
+void PassengerModel::setArrivalLog(std::vector<Passenger>* log) {
+    arrivals_ = log;
+}
+
+int PassengerModel::getWaitingCount(int floor, Direction dir) const {
+    if (!building_.isValidFloor(floor)) return 0;
+    const auto& queues = (dir == Direction::Down) ? waitingDown_ : waitingUp_;
+    return static_cast<int>(queues[floor].size());
+}
+
+int PassengerModel::getRidingCount(int car) const {
+    if (!building_.isValidElevator(car)) return 0;
+    return static_cast<int>(riding_[car].size());
+}
+
+const PassengerMetrics& PassengerModel::getMetrics() const {
+    return metrics_;
+}
+
+void PassengerModel::saveState(SnapshotWriter& out) const {
+    auto put = [&out](const Passenger& p) {
+        out.putInt(p.id);
+        out.putInt(p.origin);
+        out.putInt(p.destination);
+        out.putInt(p.arrivalTick);
+        out.putInt(p.boardTick);
+    };
+    out.putInt(nextId_);
+    for (int floor = 1; floor <= building_.getNumFloors(); ++floor) {
+        for (const auto* queue : {&waitingUp_[floor], &waitingDown_[floor]}) {
+            out.putInt(static_cast<int>(queue->size()));
+            for (const Passenger& p : *queue) put(p);
+        }
+    }
+    for (const auto& riders : riding_) {
+        out.putInt(static_cast<int>(riders.size()));
+        for (const Passenger& p : riders) put(p);
+    }
+}
+
+void PassengerModel::loadState(SnapshotReader& in) {
+    const int numFloors = building_.getNumFloors();
+    auto get = [&in, numFloors]() {
+        Passenger p;
+        p.id = in.getInt(0, std::numeric_limits<int>::max());
+        p.origin = in.getInt(1, numFloors);
+        p.destination = in.getInt(1, numFloors);
+        p.arrivalTick = in.getInt();
+        p.boardTick = in.getInt();
+        return p;
+    };
+    
+    metrics_ = PassengerMetrics{};
+    int waitingCount = 0;
+    int ridingCount = 0;
+    nextId_ = in.getInt(0, std::numeric_limits<int>::max());
+    for (int floor = 1; floor <= numFloors; ++floor) {
+        for (auto* queue : {&waitingUp_[floor], &waitingDown_[floor]}) {
+            queue->clear();
+            for (int n = in.getInt(0, std::numeric_limits<int>::max()); n > 0; --n) {
+                queue->push_back(get());
+                ++waitingCount;
+            }
+        }
+    }
+    for (auto& riders : riding_) {
+        riders.clear();
+        for (int n = in.getInt(0, std::numeric_limits<int>::max()); n > 0; --n) {
+            riders.push_back(get());
+            ++ridingCount;
+        }
+    }
+    metrics_.waiting.store(waitingCount, std::memory_order_relaxed);
+    metrics_.riding.store(ridingCount, std::memory_order_relaxed);
+}
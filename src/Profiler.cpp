@@ -0,0 +1,129 @@
+#include "Profiler.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+
+// ============== TickProfiler Implementation ==============
+
+const char* tickPhaseName(TickPhase phase) {
+    switch (phase) {
+        case TickPhase::Cars: return "cars";
+        case TickPhase::Scheduler: return "scheduler";
+        case TickPhase::Drain: return "drain";
+        case TickPhase::Dispatch: return "dispatch";
+        case TickPhase::Publish: return "publish";
+        case TickPhase::Count: break;
+    }
+    return "unknown";
+}
+
+void TickProfiler::endTick(const Stamp& begin, long long events) {
+#if ELEVATOR_PROFILING
+    if (!enabled_) return;
+    auto clampNs = [](std::int64_t ns) {
+        return static_cast<int>(std::min<std::int64_t>(ns, std::numeric_limits<int>::max()));
+    };
+    for (int i = 0; i < kTickPhases; ++i) {
+        phaseNs_[i].record(clampNs(pending_[i]));
+        pending_[i] = 0;
+    }
+    tickNs_.record(clampNs((Clock::now() - begin.at).count()));
+    eventsPerTick_.record(static_cast<int>(std::min<long long>(events, std::numeric_limits<int>::max())));
+#else
+    (void)begin;
+    (void)events;
+#endif
+}
+
+void TickProfiler::printReport(std::ostream& out, const ProfileCounters& counters) const {
+    out << "\n========== Profile at Tick " << counters.tick << " ==========\n";
+    if (!kProfilingCompiled) {
+        out << "Profiling not compiled in (ELEVATOR_PROFILING=OFF)\n";
+        return;
+    }
+    if (!isEnabled()) {
+        out << "Tick timing off (start with --profile)\n";
+    } else {
+        auto row = [&](const char* name, const HdrHistogram& ns) {
+            out << "  " << std::left << std::setw(10) << name << std::right
+                << std::fixed << std::setprecision(2)
+                << std::setw(10) << ns.mean() / 1000.0
+                << std::setw(10) << ns.percentile(0.5) / 1000.0
+                << std::setw(10) << ns.percentile(0.99) / 1000.0
+                << std::setw(10) << ns.max() / 1000.0 << "\n";
+        };
+        out << "Ticks profiled: " << tickNs_.count() << " (+" << getSkippedTicks()
+            << " skipped)\n"
+            << "  phase      mean(us)   p50(us)   p99(us)   max(us)\n";
+        for (int i = 0; i < kTickPhases; ++i) {
+            row(tickPhaseName(static_cast<TickPhase>(i)), phaseNs_[i]);
+        }
+        row("tick", tickNs_);
+        out.unsetf(std::ios::fixed);
+        out << "Events/tick: mean " << eventsPerTick_.mean()
+            << ", p99 " << eventsPerTick_.percentile(0.99)
+            << ", max " << eventsPerTick_.max() << "\n";
+    }
+    out << "Events processed: " << counters.eventsProcessed << "\n"
+        << "Event queue: high-water " << counters.queue.highWater
+        << ", contended " << counters.queue.contended << "\n"
+        << "Lock contention: building " << counters.buildingContended
+        << ", scheduler " << counters.schedulerContended << "\n"
+        << "==========================================\n";
+}
+
+void TickProfiler::writePrometheus(std::ostream& out, const ProfileCounters& counters) const {
+    auto summary = [&](const char* name, const char* help, const HdrHistogram& h, double scale) {
+        out << "# HELP " << name << " " << help << "\n"
+            << "# TYPE " << name << " summary\n";
+        for (double q : {0.5, 0.9, 0.99}) {
+            out << name << "{quantile=\"" << q << "\"} " << h.percentile(q) * scale << "\n";
+        }
+        out << name << "_sum " << static_cast<double>(h.sum()) * scale << "\n"
+            << name << "_count " << h.count() << "\n";
+    };
+    auto counter = [&](const char* name, const char* help, const char* type,
+                       unsigned long long value) {
+        out << "# HELP " << name << " " << help << "\n"
+            << "# TYPE " << name << " " << type << "\n"
+            << name << " " << value << "\n";
+    };
+
+    counter("elevator_tick", "Current simulation tick", "gauge",
+            static_cast<unsigned long long>(counters.tick));
+    counter("elevator_events_processed_total", "Events dispatched by the tick loop", "counter",
+            static_cast<unsigned long long>(counters.eventsProcessed));
+    if (!kProfilingCompiled) {
+        return;
+    }
+
+    counter("elevator_event_queue_high_water", "Deepest event backlog seen at a drain",
+            "gauge", counters.queue.highWater);
+    out << "# HELP elevator_lock_contended_total Lock acquisitions that had to wait\n"
+        << "# TYPE elevator_lock_contended_total counter\n"
+        << "elevator_lock_contended_total{lock=\"event_queue\"} " << counters.queue.contended << "\n"
+        << "elevator_lock_contended_total{lock=\"building\"} " << counters.buildingContended << "\n"
+        << "elevator_lock_contended_total{lock=\"scheduler\"} " << counters.schedulerContended << "\n";
+
+    if (!isEnabled()) {
+        return;
+    }
+    counter("elevator_ticks_skipped_total", "Ticks jumped by next-event time advance",
+            "counter", static_cast<unsigned long long>(getSkippedTicks()));
+    summary("elevator_tick_seconds", "Wall time of one tick", tickNs_, 1e-9);
+    out << "# HELP elevator_tick_phase_seconds Wall time of one tick phase\n"
+        << "# TYPE elevator_tick_phase_seconds summary\n";
+    for (int i = 0; i < kTickPhases; ++i) {
+        const HdrHistogram& h = phaseNs_[i];
+        const char* phase = tickPhaseName(static_cast<TickPhase>(i));
+        for (double q : {0.5, 0.9, 0.99}) {
+            out << "elevator_tick_phase_seconds{phase=\"" << phase << "\",quantile=\"" << q
+                << "\"} " << h.percentile(q) * 1e-9 << "\n";
+        }
+        out << "elevator_tick_phase_seconds_sum{phase=\"" << phase << "\"} "
+            << static_cast<double>(h.sum()) * 1e-9 << "\n"
+            << "elevator_tick_phase_seconds_count{phase=\"" << phase << "\"} " << h.count() << "\n";
+    }
+    summary("elevator_events_per_tick", "Events dispatched in one tick", eventsPerTick_, 1.0);
+}
@@ -1,20 +1,104 @@
 #include "Scheduler.hpp"
 #include <algorithm>
+#include <cstdint>
 #include <limits>
 
+// ============== Dispatch Policy Helpers ==============
+
+int pickTarget(DispatchPolicy policy, int current, Direction sweep,
+               const FloorMask& destinations) {
+    if (policy == DispatchPolicy::NearestFirst || sweep == Direction::Idle) {
+        return destinations.nearest(current);
+    }
+    if (destinations.test(current)) {
+        return current;
+    }
+    int ahead = (sweep == Direction::Up) ? destinations.nextAbove(current)
+                                         : destinations.nextBelow(current);
+    if (ahead >= 0) {
+        return ahead;
+    }
+    return (sweep == Direction::Up) ? destinations.nextBelow(current)
+                                    : destinations.nextAbove(current);
+}
+
+Direction headingOf(const Config& config, const FleetState& fleet, int car,
+                    Direction sweep, const FloorMask& stops) {
+    if (fleet.state[car] == ElevatorState::Moving) {
+        return fleet.direction[car];
+    }
+    int current = fleet.floor[car];
+    FloorMask elsewhere = stops;
+    elsewhere.reset(current);  // Served before it leaves
+    if (elsewhere.empty()) {
+        return Direction::Idle;
+    }
+    Direction last = fleet.direction[car] != Direction::Idle ? fleet.direction[car] : sweep;
+    int target = pickTarget(config.dispatchPolicy, current, last, elsewhere);
+    return target > current ? Direction::Up : Direction::Down;
+}
+
+namespace {
+
+Direction opposite(Direction dir) {
+    return dir == Direction::Up ? Direction::Down
+         : dir == Direction::Down ? Direction::Up
+         : Direction::Idle;
+}
+
+}  // namespace
+
 // ============== Master Controller Implementation ==============
 
 MasterController::MasterController(Building& building, EventQueue<Event>& queue)
-    : building_(building), eventQueue_(queue) {}
+    : building_(building), eventQueue_(queue),
+      assignments_(hallCallSlot(building.getNumFloors() + 1, Direction::Up), -1),
+      assignedUp_(building.getNumElevators()),
+      assignedDown_(building.getNumElevators()),
+      sweep_(building.getNumElevators(), Direction::Idle),
+      eta_(building.getConfig(), building.getNumElevators()) {}
 
 void MasterController::handleHallCall(int floor, Direction dir) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    if (!building_.isValidFloor(floor) || dir == Direction::Idle) {
+        return;
+    }
     
-    auto key = std::make_pair(floor, dir);
+    int elevatorId = -1;
+    {
+        std::lock_guard<ProfiledMutex> lock(mutex_);
+        elevatorId = assignHallCall(floor, dir);
+    }
     
+    // Dispatch outside the lock: dispatchElevator takes mutex_ itself
+    if (elevatorId >= 0) {
+        dispatchElevator(elevatorId);
+    }
+}
+
+void MasterController::handleHallCalls(const std::vector<std::pair<int, Direction>>& calls) {
+    std::uint64_t toDispatch = 0;  // Bit per car
+    {
+        std::lock_guard<ProfiledMutex> lock(mutex_);
+        for (const auto& [floor, dir] : calls) {
+            if (!building_.isValidFloor(floor) || dir == Direction::Idle) {
+                continue;
+            }
+            int elevatorId = assignHallCall(floor, dir);
+            if (elevatorId >= 0) {
+                toDispatch |= std::uint64_t{1} << elevatorId;
+            }
+        }
+    }
+    
+    for (; toDispatch; toDispatch &= toDispatch - 1) {
+        dispatchElevator(__builtin_ctzll(toDispatch));
+    }
+}
+
+int MasterController::assignHallCall(int floor, Direction dir) {
     // Check if already assigned
-    if (assignments_.find(key) != assignments_.end()) {
-        return;  // Already assigned
+    if (assignments_[hallCallSlot(floor, dir)] >= 0) {
+        return -1;
     }
     
     // Register in building
@@ -23,9 +107,9 @@ void MasterController::handleHallCall(int floor, Direction dir) {
     // Select best elevator
     int elevatorId = selectElevator(floor, dir);
     if (elevatorId >= 0) {
-        assignments_[key] = elevatorId;
-        dispatchElevator(elevatorId);
+        assign(floor, dir, elevatorId);
     }
+    return elevatorId;
 }
 
 void MasterController::handleCarCall(int elevatorId, int floor) {
@@ -33,7 +117,7 @@ void MasterController::handleCarCall(int elevatorId, int floor) {
         return;
     }
     
-    building_.getElevator(elevatorId).addCarCall(floor);
+    building_.registerCarCall(elevatorId, floor);
     dispatchElevator(elevatorId);
 }
 
@@ -49,7 +133,17 @@ void MasterController::onElevatorArrived(int elevatorId, int floor) {
     }
     
     // Clear car call
-    elev.removeCarCall(floor);
+    building_.clearCarCall(elevatorId, floor);
+    
+    // A collective car turning around here serves the other direction too
+    if (building_.getConfig().dispatchPolicy == DispatchPolicy::Collective &&
+        !anyAhead(destinationsOf(elevatorId), floor, dir)) {
+        Direction back = opposite(dir);
+        if (auto assignment = getAssignment(floor, back); assignment && *assignment == elevatorId) {
+            clearAssignment(floor, back);
+            building_.clearHallCall(floor, back);
+        }
+    }
 }
 
 void MasterController::onDoorsOpened(int elevatorId, int floor) {
@@ -65,33 +159,153 @@ void MasterController::onDoorsClosed(int elevatorId) {
 
 void MasterController::tick() {
     // Process any pending reassignments or idle elevator dispatch
-    for (int i = 0; i < building_.getNumElevators(); ++i) {
-        Elevator& elev = building_.getElevator(i);
-        if (elev.getState() == ElevatorState::Idle) {
+    int period = building_.getConfig().reassignPeriod;
+    if (period > 0 && ++ticksSinceReassign_ >= period) {
+        ticksSinceReassign_ = 0;
+        reassignCalls();
+    }
+    
+    const FleetState& fleet = building_.getFleet();
+    for (int i = 0; i < fleet.size(); ++i) {
+        if (fleet.state[i] == ElevatorState::Idle) {
             dispatchElevator(i);
         }
     }
 }
 
+int MasterController::quietTicks() {
+    const FleetState& fleet = building_.getFleet();
+    bool anyAssigned = false;
+    for (int i = 0; i < fleet.size(); ++i) {
+        FloorMask destinations = destinationsOf(i);
+        if (fleet.state[i] == ElevatorState::Idle && !destinations.empty()) {
+            return 0;  // Dispatched on the next tick
+        }
+        anyAssigned = anyAssigned || !destinations.empty();
+    }
+    
+    // The next reassignment pass may move calls; with none assigned it is
+    // a no-op and ticks can be skipped straight through it
+    int period = building_.getConfig().reassignPeriod;
+    if (period > 0 && anyAssigned) {
+        return period - ticksSinceReassign_ - 1;
+    }
+    return std::numeric_limits<int>::max();
+}
+
+void MasterController::skipTicks(int ticks) {
+    int period = building_.getConfig().reassignPeriod;
+    if (period > 0) {
+        ticksSinceReassign_ = (ticksSinceReassign_ + ticks) % period;
+    }
+}
+
 int MasterController::selectElevator(int floor, Direction dir) {
-    int bestElevator = -1;
-    int bestCost = std::numeric_limits<int>::max();
+    const Config& config = building_.getConfig();
+    if (config.costModel != CostModel::Eta) {
+        return building_.getCostIndex().bestCar(floor, dir);
+    }
     
-    for (int i = 0; i < building_.getNumElevators(); ++i) {
-        const Elevator& elev = building_.getElevator(i);
-        int cost = calculateCost(elev, floor, dir);
+    const FleetState& fleet = building_.getFleet();
+    int bestCar = -1;
+    int bestEta = std::numeric_limits<int>::max();
+    for (int car = 0; car < fleet.size(); ++car) {
+        FloorMask stops = stopsOf(car);
+        eta_.update(fleet, car, stops, headingOf(config, fleet, car, sweep_[car], stops));
+        int eta = eta_.eta(fleet, car, floor, dir);
+        if (eta < bestEta) {
+            bestEta = eta;
+            bestCar = car;
+        }
+    }
+    return bestCar;
+}
+
+int MasterController::reassignCalls() {
+    const Config& config = building_.getConfig();
+    int cars = building_.getNumElevators();
+    if (cars < 2) {
+        return 0;
+    }
+    
+    int stopCost = stopCostFloors(config);  // Per extra call on the same car
+    
+    std::uint64_t toDispatch = 0;  // Bit per car
+    int moved = 0;
+    {
+        std::lock_guard<ProfiledMutex> lock(mutex_);
+        outstanding_.clear();
+        for (int slot = 0; slot < static_cast<int>(assignments_.size()); ++slot) {
+            if (assignments_[slot] >= 0) {
+                outstanding_.push_back(slot);
+            }
+        }
+        int calls = static_cast<int>(outstanding_.size());
+        if (calls == 0) {
+            return 0;
+        }
         
-        if (cost < bestCost) {
-            bestCost = cost;
-            bestElevator = i;
+        // Column car * perCar + k: this car's (k+1)-th call of the pass
+        int perCar = (calls + cars - 1) / cars;
+        solver_.reset(calls, cars * perCar);
+        for (int row = 0; row < calls; ++row) {
+            int floor = outstanding_[row] / 2;
+            Direction dir = (outstanding_[row] & 1) ? Direction::Down : Direction::Up;
+            for (int car = 0; car < cars; ++car) {
+                int cost = building_.getElevator(car).costToServe(floor, dir, config.numFloors);
+                for (int k = 0; k < perCar; ++k) {
+                    solver_.cost(row, car * perCar + k) = cost + k * stopCost;
+                }
+            }
         }
+        
+        const std::vector<int>& columns = solver_.solve();
+        for (int row = 0; row < calls; ++row) {
+            int slot = outstanding_[row];
+            int owner = assignments_[slot];
+            int car = columns[row] / perCar;
+            if (car == owner ||
+                solver_.cost(row, owner * perCar) - solver_.cost(row, car * perCar) <
+                    config.reassignMinGain) {
+                continue;
+            }
+            int floor = slot / 2;
+            Direction dir = (slot & 1) ? Direction::Down : Direction::Up;
+            (dir == Direction::Up ? assignedUp_ : assignedDown_)[owner].reset(floor);
+            assign(floor, dir, car);
+            toDispatch |= std::uint64_t{1} << car;
+            ++moved;
+        }
+        reassignments_ += moved;
     }
     
-    return bestElevator;
+    for (; toDispatch; toDispatch &= toDispatch - 1) {
+        dispatchElevator(__builtin_ctzll(toDispatch));
+    }
+    return moved;
 }
 
-int MasterController::calculateCost(const Elevator& elev, int floor, Direction dir) {
-    return elev.costToServe(floor, dir, building_.getNumFloors());
+long long MasterController::getReassignments() const {
+    std::lock_guard<ProfiledMutex> lock(mutex_);
+    return reassignments_;
+}
+
+FloorMask MasterController::destinationsOf(int elevatorId) {
+    std::lock_guard<ProfiledMutex> lock(mutex_);
+    return stopsOf(elevatorId);
+}
+
+FloorMask MasterController::stopsOf(int elevatorId) const {
+    const Elevator& elev = building_.getElevator(elevatorId);
+    FloorMask destinations = elev.getCarCalls();
+    
+    // Add assigned hall call destinations, unless a full car still has
+    // riders to drop off (it cannot pick anyone up until then)
+    if (elev.canBoard() || destinations.empty()) {
+        destinations |= assignedUp_[elevatorId];
+        destinations |= assignedDown_[elevatorId];
+    }
+    return destinations;
 }
 
 void MasterController::dispatchElevator(int elevatorId) {
@@ -102,88 +316,184 @@ void MasterController::dispatchElevator(int elevatorId) {
     }
     
     // Find next destination: car calls + assigned hall calls
-    std::set<int> destinations = elev.getCarCalls();
-    
-    // Add assigned hall call destinations
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        for (const auto& [key, assignedId] : assignments_) {
-            if (assignedId == elevatorId) {
-                destinations.insert(key.first);
-            }
-        }
-    }
-    
+    FloorMask destinations = destinationsOf(elevatorId);
     if (destinations.empty()) {
         return;  // Nothing to do
     }
     
-    // Find closest destination
     int current = elev.getCurrentFloor();
-    auto closest = std::min_element(destinations.begin(), destinations.end(),
-        [current](int a, int b) {
-            return std::abs(a - current) < std::abs(b - current);
-        });
-    
-    int target = *closest;
-    Direction dir = (target > current) ? Direction::Up : Direction::Down;
+    int target = pickTarget(building_.getConfig().dispatchPolicy, current,
+                            sweep_[elevatorId], destinations);
     
     if (target == current) {
-        // Already at destination, open doors
+        // Already at destination: serve it here, then open doors
+        serveFloor(elevatorId, current);
         elev.openDoors(building_.getConfig().doorOpenTicks);
     } else {
-        elev.startMoving(dir, building_.getConfig().floorTravelTicks);
+        Direction dir = (target > current) ? Direction::Up : Direction::Down;
+        sweep_[elevatorId] = dir;
+        elev.startMoving(dir, building_.getMotion().passTicks(1));
     }
 }
 
-bool MasterController::shouldStopAtFloor(int elevatorId, int floor) {
+bool MasterController::shouldStopAt(int elevatorId, int floor) {
     const Elevator& elev = building_.getElevator(elevatorId);
+    Direction dir = elev.getDirection();
     
-    // Check car call
     if (elev.hasCarCallAt(floor)) {
         return true;
     }
+    if (!anyAhead(destinationsOf(elevatorId), floor, dir)) {
+        return true;  // Nothing further on: this is the last stop
+    }
+    if (!elev.canBoard()) {
+        return false;
+    }
     
-    // Check hall call assignment
-    Direction dir = elev.getDirection();
-    if (auto assignment = getAssignment(floor, dir); assignment && *assignment == elevatorId) {
-        return true;
+    std::lock_guard<ProfiledMutex> lock(mutex_);
+    if (building_.getConfig().dispatchPolicy == DispatchPolicy::NearestFirst) {
+        return assignedUp_[elevatorId].test(floor) || assignedDown_[elevatorId].test(floor);
     }
     
+    // Collective: pick up same-direction callers on the way, taking the
+    // call over if another car was heading for it
+    int owner = assignments_[hallCallSlot(floor, dir)];
+    if (owner == elevatorId) {
+        return true;
+    }
+    if (owner >= 0 || building_.hasHallCall(floor, dir)) {
+        if (owner >= 0) {
+            (dir == Direction::Up ? assignedUp_ : assignedDown_)[owner].reset(floor);
+        }
+        assign(floor, dir, elevatorId);
+        return true;
+    }
     return false;
 }
 
+void MasterController::serveFloor(int elevatorId, int floor) {
+    building_.clearCarCall(elevatorId, floor);
+    
+    for (Direction dir : {Direction::Up, Direction::Down}) {
+        if (auto assignment = getAssignment(floor, dir); assignment && *assignment == elevatorId) {
+            clearAssignment(floor, dir);
+            building_.clearHallCall(floor, dir);
+        }
+    }
+}
+
 std::optional<int> MasterController::getAssignment(int floor, Direction dir) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto key = std::make_pair(floor, dir);
-    auto it = assignments_.find(key);
-    if (it != assignments_.end()) {
-        return it->second;
+    if (!building_.isValidFloor(floor) || dir == Direction::Idle) {
+        return std::nullopt;
+    }
+    
+    std::lock_guard<ProfiledMutex> lock(mutex_);
+    int assignedId = assignments_[hallCallSlot(floor, dir)];
+    if (assignedId >= 0) {
+        return assignedId;
     }
     return std::nullopt;
 }
 
 void MasterController::clearAssignment(int floor, Direction dir) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    assignments_.erase(std::make_pair(floor, dir));
+    if (!building_.isValidFloor(floor) || dir == Direction::Idle) {
+        return;
+    }
+    
+    std::lock_guard<ProfiledMutex> lock(mutex_);
+    int& assignedId = assignments_[hallCallSlot(floor, dir)];
+    if (assignedId >= 0) {
+        auto& masks = (dir == Direction::Up) ? assignedUp_ : assignedDown_;
+        masks[assignedId].reset(floor);
+        assignedId = -1;
+    }
+}
+
+void MasterController::assign(int floor, Direction dir, int elevatorId) {
+    assignments_[hallCallSlot(floor, dir)] = elevatorId;
+    auto& masks = (dir == Direction::Up) ? assignedUp_ : assignedDown_;
+    masks[elevatorId].set(floor);
+}
+
+void MasterController::saveState(SnapshotWriter& out) const {
+    std::lock_guard<ProfiledMutex> lock(mutex_);
+    int assigned = static_cast<int>(
+        std::count_if(assignments_.begin(), assignments_.end(), [](int car) { return car >= 0; }));
+    out.putInt(assigned);
+    for (size_t slot = 0; slot < assignments_.size(); ++slot) {
+        if (assignments_[slot] >= 0) {
+            out.putInt(static_cast<int>(slot));
+            out.putInt(assignments_[slot]);
+        }
+    }
+    for (Direction dir : sweep_) {
+        out.putEnum(dir);
+    }
+    out.putInt(ticksSinceReassign_);
+}
+
+void MasterController::loadState(SnapshotReader& in) {
+    std::lock_guard<ProfiledMutex> lock(mutex_);
+    const int numFloors = building_.getNumFloors();
+    std::fill(assignments_.begin(), assignments_.end(), -1);
+    for (auto& mask : assignedUp_) mask.clear();
+    for (auto& mask : assignedDown_) mask.clear();
+    
+    for (int n = in.getInt(0, static_cast<int>(assignments_.size())); n > 0; --n) {
+        int slot = in.getInt(hallCallSlot(1, Direction::Up),
+                             hallCallSlot(numFloors, Direction::Down));
+        int car = in.getInt(0, building_.getNumElevators() - 1);
+        assign(slot / 2, (slot & 1) ? Direction::Down : Direction::Up, car);
+    }
+    for (Direction& dir : sweep_) {
+        dir = in.getEnum(Direction::Idle);
+    }
+    int period = building_.getConfig().reassignPeriod;
+    int sinceReassign = in.getInt(0, std::numeric_limits<int>::max());
+    ticksSinceReassign_ = period > 0 ? sinceReassign % period : 0;
 }
 
 // ============== Distributed Controller Implementation ==============
 
 DistributedController::DistributedController(Building& building, EventQueue<Event>& queue)
-    : building_(building), eventQueue_(queue) {}
+    : building_(building), eventQueue_(queue),
+      claimBoard_(hallCallSlot(building.getNumFloors() + 1, Direction::Up)),
+      claimedUp_(building.getNumElevators()),
+      claimedDown_(building.getNumElevators()),
+      sweep_(building.getNumElevators(), Direction::Idle),
+      bids_(claimBoard_.size()),
+      bidFloor_(building.getNumElevators(), -1),
+      bidDir_(building.getNumElevators(), Direction::Idle),
+      eta_(building.getConfig(), building.getNumElevators()) {
+    for (std::atomic<int>& slot : claimBoard_) {
+        slot.store(kNotPosted);
+    }
+    for (std::atomic<int>& bid : bids_) {
+        bid.store(kNoBid);
+    }
+}
 
 void DistributedController::handleHallCall(int floor, Direction dir) {
+    if (!building_.isValidFloor(floor) || dir == Direction::Idle) {
+        return;
+    }
+    
     // Register in building and claim board (unclaimed)
     building_.registerHallCall(floor, dir);
+    postCall(floor, dir);
+}
+
+bool DistributedController::postCall(int floor, Direction dir) {
+    if (!building_.isValidFloor(floor) || dir == Direction::Idle) {
+        return false;
+    }
     
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto key = std::make_pair(floor, dir);
-        if (claimBoard_.find(key) == claimBoard_.end()) {
-            claimBoard_[key] = -1;  // Unclaimed
-        }
+    int expected = kNotPosted;
+    if (!claimBoard_[hallCallSlot(floor, dir)].compare_exchange_strong(expected, kUnclaimed)) {
+        return false;
     }
+    openMask(dir).set(floor);
+    return true;
 }
 
 void DistributedController::handleCarCall(int elevatorId, int floor) {
@@ -191,7 +501,7 @@ void DistributedController::handleCarCall(int elevatorId, int floor) {
         return;
     }
     
-    building_.getElevator(elevatorId).addCarCall(floor);
+    building_.registerCarCall(elevatorId, floor);
     decideNextAction(elevatorId);
 }
 
@@ -206,7 +516,56 @@ void DistributedController::onElevatorArrived(int elevatorId, int floor) {
     }
     
     // Clear car call
-    elev.removeCarCall(floor);
+    building_.clearCarCall(elevatorId, floor);
+    
+    // A collective car turning around here serves the other direction too
+    if (building_.getConfig().dispatchPolicy == DispatchPolicy::Collective &&
+        !anyAhead(destinationsOf(elevatorId), floor, dir)) {
+        Direction back = opposite(dir);
+        if (hasClaim(elevatorId, floor, back)) {
+            releaseClaim(floor, back);
+            building_.clearHallCall(floor, back);
+        }
+    }
+}
+
+StopDecision DistributedController::stopDecision(int elevatorId, int floor) {
+    const Elevator& elev = building_.getElevator(elevatorId);
+    Direction dir = elev.getDirection();
+    
+    if (elev.hasCarCallAt(floor)) {
+        return StopDecision::Stop;
+    }
+    if (!anyAhead(destinationsOf(elevatorId), floor, dir)) {
+        return StopDecision::Stop;  // Nothing further on: this is the last stop
+    }
+    if (!elev.canBoard()) {
+        return StopDecision::Pass;
+    }
+    
+    if (building_.getConfig().dispatchPolicy == DispatchPolicy::NearestFirst) {
+        return hasClaim(elevatorId, floor, Direction::Up) ||
+               hasClaim(elevatorId, floor, Direction::Down)
+                   ? StopDecision::Stop : StopDecision::Pass;
+    }
+    
+    // Collective: our own same-direction claim, or an open one we pass
+    if (hasClaim(elevatorId, floor, dir)) {
+        return StopDecision::Stop;
+    }
+    return claimBoard_[hallCallSlot(floor, dir)].load() == kUnclaimed
+               ? StopDecision::Bid : StopDecision::Pass;
+}
+
+bool DistributedController::shouldStopAt(int elevatorId, int floor) {
+    switch (stopDecision(elevatorId, floor)) {
+        case StopDecision::Stop:
+            return true;
+        case StopDecision::Bid:
+            return tryClaim(elevatorId, floor, building_.getElevator(elevatorId).getDirection());
+        default:
+            return false;
+    }
 }
 
 void DistributedController::onDoorsOpened(int elevatorId, int floor) {
@@ -220,84 +579,260 @@ void DistributedController::onDoorsClosed(int elevatorId) {
 
 void DistributedController::tick() {
     // Each elevator tries to claim calls
-    for (int i = 0; i < building_.getNumElevators(); ++i) {
+    const FleetState& fleet = building_.getFleet();
+    for (int i = 0; i < fleet.size(); ++i) {
         tryClaimCalls(i);
         
-        Elevator& elev = building_.getElevator(i);
-        if (elev.getState() == ElevatorState::Idle) {
+        if (fleet.state[i] == ElevatorState::Idle) {
             decideNextAction(i);
         }
     }
 }
 
-void DistributedController::tryClaimCalls(int elevatorId) {
+int DistributedController::quietTicks() {
+    if (openUp_.load().any() || openDown_.load().any()) {
+        return 0;  // Some car may claim it
+    }
+    const FleetState& fleet = building_.getFleet();
+    for (int i = 0; i < fleet.size(); ++i) {
+        if (fleet.state[i] == ElevatorState::Idle && !destinationsOf(i).empty()) {
+            return 0;
+        }
+    }
+    return std::numeric_limits<int>::max();
+}
+
+bool DistributedController::maySeekCalls(int elevatorId) const {
     const Elevator& elev = building_.getElevator(elevatorId);
     
     // Only idle or low-activity elevators should claim new calls
     if (elev.getState() != ElevatorState::Idle && elev.hasAnyCarCalls()) {
-        return;
+        return false;
     }
+    return elev.canBoard();  // Full: leave the call to a car that can take it
+}
+
+bool DistributedController::nearestCall(int current, const FloorMask& up, const FloorMask& down,
+                                        int& floor, Direction& dir) {
+    // Closest floor wins, ties go to the lower floor, then to Up (the order
+    // a full board scan would visit)
+    int upFloor = up.nearest(current);
+    int downFloor = down.nearest(current);
     
-    std::lock_guard<std::mutex> lock(mutex_);
+    floor = upFloor;
+    dir = Direction::Up;
+    if (downFloor >= 0) {
+        int upDistance = std::abs(upFloor - current);
+        int downDistance = std::abs(downFloor - current);
+        if (upFloor < 0 || downDistance < upDistance ||
+            (downDistance == upDistance && downFloor < upFloor)) {
+            floor = downFloor;
+            dir = Direction::Down;
+        }
+    }
+    return floor >= 0;
+}
+
+bool DistributedController::soonestCall(const FleetState& fleet, int elevatorId,
+                                        const FloorMask& up, const FloorMask& down,
+                                        int& floor, Direction& dir) const {
+    // Earliest arrival wins; ties go to the lower floor, then to Up
+    int bestEta = std::numeric_limits<int>::max();
+    floor = -1;
+    for (Direction d : {Direction::Up, Direction::Down}) {
+        for (int f : d == Direction::Up ? up : down) {
+            int eta = eta_.eta(fleet, elevatorId, f, d);
+            if (eta < bestEta || (eta == bestEta && f < floor)) {
+                bestEta = eta;
+                floor = f;
+                dir = d;
+            }
+        }
+    }
+    return floor >= 0;
+}
+
+void DistributedController::tryClaimCalls(int elevatorId) {
+    if (!maySeekCalls(elevatorId)) {
+        return;
+    }
     
-    int current = elev.getCurrentFloor();
-    int bestFloor = -1;
-    Direction bestDir = Direction::Idle;
-    int bestDistance = std::numeric_limits<int>::max();
-    
-    // Find nearest unclaimed call
-    for (auto& [key, claimerId] : claimBoard_) {
-        if (claimerId == -1) {  // Unclaimed
-            int distance = std::abs(key.first - current);
-            if (distance < bestDistance) {
-                bestDistance = distance;
-                bestFloor = key.first;
-                bestDir = key.second;
+    // Nearest (or soonest reached) unclaimed call. Another car may win the
+    // CAS first; then try the next one.
+    int current = building_.getElevator(elevatorId).getCurrentFloor();
+    FloorMask openUp = openUp_.load();
+    FloorMask openDown = openDown_.load();
+    int floor;
+    Direction dir;
+    if (building_.getConfig().costModel == CostModel::Eta) {
+        const FleetState& fleet = building_.getFleet();
+        FloorMask stops = destinationsOf(elevatorId);
+        eta_.update(fleet, elevatorId, stops,
+                    headingOf(building_.getConfig(), fleet, elevatorId, sweep_[elevatorId], stops));
+        while (soonestCall(fleet, elevatorId, openUp, openDown, floor, dir)) {
+            if (tryClaim(elevatorId, floor, dir)) {
+                return;
             }
+            (dir == Direction::Up ? openUp : openDown).reset(floor);
+        }
+        return;
+    }
+    while (nearestCall(current, openUp, openDown, floor, dir)) {
+        if (tryClaim(elevatorId, floor, dir)) {
+            return;
         }
+        (dir == Direction::Up ? openUp : openDown).reset(floor);
+    }
+}
+
+// ---- Per-car workers: bid, barrier, resolve ----
+
+void DistributedController::placeBid(int elevatorId, int floor, Direction dir) {
+    // Keep the lowest id: CAS down until ours is in or a lower one is
+    std::atomic<int>& bid = bids_[hallCallSlot(floor, dir)];
+    int current = bid.load();
+    while (elevatorId < current && !bid.compare_exchange_weak(current, elevatorId)) {
+    }
+    bidFloor_[elevatorId] = floor;
+    bidDir_[elevatorId] = dir;
+}
+
+bool DistributedController::resolveBid(int elevatorId) {
+    int floor = bidFloor_[elevatorId];
+    if (floor < 0) {
+        return false;
+    }
+    Direction dir = bidDir_[elevatorId];
+    bidFloor_[elevatorId] = -1;
+    
+    // Losers only compare, so the winner may reset the slot for the next
+    // phase while they look
+    std::atomic<int>& bid = bids_[hallCallSlot(floor, dir)];
+    if (bid.load() != elevatorId) {
+        return false;
+    }
+    bid.store(kNoBid);
+    return tryClaim(elevatorId, floor, dir);
+}
+
+StopDecision DistributedController::bidStopAt(int elevatorId, int floor) {
+    StopDecision decision = stopDecision(elevatorId, floor);
+    if (decision == StopDecision::Bid) {
+        placeBid(elevatorId, floor, building_.getElevator(elevatorId).getDirection());
+    }
+    return decision;
+}
+
+bool DistributedController::resolveStopAt(int elevatorId, int floor) {
+    (void)floor;
+    return resolveBid(elevatorId);
+}
+
+void DistributedController::bidCarTick(int elevatorId) {
+    if (!maySeekCalls(elevatorId)) {
+        return;
     }
     
-    // Claim it
-    if (bestFloor >= 0) {
-        claimBoard_[std::make_pair(bestFloor, bestDir)] = elevatorId;
+    // One bid on the nearest (or soonest reached) open call; a car outbid
+    // here tries again next tick. Each worker refreshes only its own row.
+    int floor;
+    Direction dir;
+    bool found;
+    if (building_.getConfig().costModel == CostModel::Eta) {
+        const FleetState& fleet = building_.getFleet();
+        FloorMask stops = destinationsOf(elevatorId);
+        eta_.update(fleet, elevatorId, stops,
+                    headingOf(building_.getConfig(), fleet, elevatorId, sweep_[elevatorId], stops));
+        found = soonestCall(fleet, elevatorId, openUp_.load(), openDown_.load(), floor, dir);
+    } else {
+        found = nearestCall(building_.getElevator(elevatorId).getCurrentFloor(),
+                            openUp_.load(), openDown_.load(), floor, dir);
+    }
+    if (found) {
+        placeBid(elevatorId, floor, dir);
+    }
+}
+
+void DistributedController::resolveCarTick(int elevatorId) {
+    resolveBid(elevatorId);
+    if (building_.getFleet().state[elevatorId] == ElevatorState::Idle) {
+        decideNextAction(elevatorId);
     }
 }
 
 bool DistributedController::tryClaim(int elevatorId, int floor, Direction dir) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto key = std::make_pair(floor, dir);
+    if (!building_.isValidFloor(floor) || dir == Direction::Idle) {
+        return false;
+    }
+    
+    std::atomic<int>& slot = claimBoard_[hallCallSlot(floor, dir)];
+    if (slot.load() != kUnclaimed) {
+        return false;  // Plain load first: passing cars probe every floor
+    }
     
-    auto it = claimBoard_.find(key);
-    if (it != claimBoard_.end() && it->second == -1) {
-        it->second = elevatorId;
+    // Masks first, so anyone who sees the claim on the board also sees them
+    openMask(dir).reset(floor);
+    claimedMask(elevatorId, dir).set(floor);
+    int expected = kUnclaimed;
+    if (slot.compare_exchange_strong(expected, elevatorId)) {
         return true;
     }
+    claimedMask(elevatorId, dir).reset(floor);
     return false;
 }
 
 void DistributedController::releaseClaim(int floor, Direction dir) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    claimBoard_.erase(std::make_pair(floor, dir));
+    if (!building_.isValidFloor(floor) || dir == Direction::Idle) {
+        return;
+    }
+    
+    std::atomic<int>& slot = claimBoard_[hallCallSlot(floor, dir)];
+    int claimerId = slot.load();
+    while (claimerId != kNotPosted) {
+        if (claimerId >= 0) {
+            claimedMask(claimerId, dir).reset(floor);
+        } else {
+            openMask(dir).reset(floor);
+        }
+        // Fails only if the call was claimed or released meanwhile: redo
+        if (slot.compare_exchange_weak(claimerId, kNotPosted)) {
+            return;
+        }
+    }
 }
 
 bool DistributedController::hasClaim(int elevatorId, int floor, Direction dir) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto key = std::make_pair(floor, dir);
-    auto it = claimBoard_.find(key);
-    return it != claimBoard_.end() && it->second == elevatorId;
+    if (!building_.isValidFloor(floor) || dir == Direction::Idle) {
+        return false;
+    }
+    
+    return claimBoard_[hallCallSlot(floor, dir)].load() == elevatorId;
+}
+
+FloorMask DistributedController::getClaimedFloors(int elevatorId) {
+    return claimedUp_[elevatorId].load() | claimedDown_[elevatorId].load();
 }
 
-std::vector<std::pair<int, Direction>> DistributedController::getClaimsFor(int elevatorId) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    std::vector<std::pair<int, Direction>> claims;
+void DistributedController::serveFloor(int elevatorId, int floor) {
+    building_.clearCarCall(elevatorId, floor);
     
-    for (const auto& [key, claimerId] : claimBoard_) {
-        if (claimerId == elevatorId) {
-            claims.push_back(key);
+    for (Direction dir : {Direction::Up, Direction::Down}) {
+        if (hasClaim(elevatorId, floor, dir)) {
+            releaseClaim(floor, dir);
+            building_.clearHallCall(floor, dir);
         }
     }
+}
+
+FloorMask DistributedController::destinationsOf(int elevatorId) {
+    const Elevator& elev = building_.getElevator(elevatorId);
+    FloorMask destinations = elev.getCarCalls();
     
-    return claims;
+    // A full car delivers its riders before serving its claims
+    if (elev.canBoard() || destinations.empty()) {
+        destinations |= getClaimedFloors(elevatorId);
+    }
+    return destinations;
 }
 
 void DistributedController::decideNextAction(int elevatorId) {
@@ -308,30 +843,463 @@ void DistributedController::decideNextAction(int elevatorId) {
     }
     
     // Collect destinations: car calls + claimed hall calls
-    std::set<int> destinations = elev.getCarCalls();
+    FloorMask destinations = destinationsOf(elevatorId);
+    if (destinations.empty()) {
+        return;
+    }
+    
+    int current = elev.getCurrentFloor();
+    int target = pickTarget(building_.getConfig().dispatchPolicy, current,
+                            sweep_[elevatorId], destinations);
+    
+    if (target == current) {
+        serveFloor(elevatorId, current);
+        elev.openDoors(building_.getConfig().doorOpenTicks);
+    } else {
+        Direction dir = (target > current) ? Direction::Up : Direction::Down;
+        sweep_[elevatorId] = dir;
+        elev.startMoving(dir, building_.getMotion().passTicks(1));
+    }
+}
+
+void DistributedController::saveState(SnapshotWriter& out) const {
+    std::vector<std::pair<int, int>> posted;
+    for (size_t slot = 0; slot < claimBoard_.size(); ++slot) {
+        int owner = claimBoard_[slot].load();
+        if (owner != kNotPosted) {
+            posted.emplace_back(static_cast<int>(slot), owner);
+        }
+    }
+    out.putInt(static_cast<int>(posted.size()));
+    for (const auto& [slot, owner] : posted) {
+        out.putInt(slot);
+        out.putInt(owner);
+    }
+    for (Direction dir : sweep_) {
+        out.putEnum(dir);
+    }
+}
+
+void DistributedController::loadState(SnapshotReader& in) {
+    const int numFloors = building_.getNumFloors();
+    for (std::atomic<int>& slot : claimBoard_) {
+        slot.store(kNotPosted);
+    }
+    openUp_.clear();
+    openDown_.clear();
+    for (auto& mask : claimedUp_) mask.clear();
+    for (auto& mask : claimedDown_) mask.clear();
+    
+    // The open and claimed masks follow from the board
+    for (int n = in.getInt(0, static_cast<int>(claimBoard_.size())); n > 0; --n) {
+        int slot = in.getInt(hallCallSlot(1, Direction::Up),
+                             hallCallSlot(numFloors, Direction::Down));
+        int owner = in.getInt(kUnclaimed, building_.getNumElevators() - 1);
+        int floor = slot / 2;
+        Direction dir = (slot & 1) ? Direction::Down : Direction::Up;
+        claimBoard_[slot].store(owner);
+        if (owner == kUnclaimed) {
+            openMask(dir).set(floor);
+        } else {
+            claimedMask(owner, dir).set(floor);
+        }
+    }
+    for (Direction& dir : sweep_) {
+        dir = in.getEnum(Direction::Idle);
+    }
+}
+
+// ============== Destination Controller Implementation ==============
+
+DestinationController::DestinationController(Building& building, EventQueue<Event>& queue)
+    : building_(building), eventQueue_(queue),
+      zoneSize_(building.getConfig().destinationZoneSize > 0
+                    ? building.getConfig().destinationZoneSize
+                    : (building.getNumFloors() + building.getNumElevators() - 1) /
+                          building.getNumElevators()),
+      pending_(hallCallSlot(building.getNumFloors() + 1, Direction::Up)),
+      pickupUp_(building.getNumElevators()),
+      pickupDown_(building.getNumElevators()),
+      planned_(building.getNumElevators()),
+      promised_(building.getNumElevators(), 0),
+      sweep_(building.getNumElevators(), Direction::Idle),
+      boardingFloor_(building.getNumElevators(), -1),
+      boardingTo_(building.getNumElevators()) {}
+
+int DestinationController::getZone(int floor) const {
+    return (floor - 1) / zoneSize_;
+}
+
+FloorMask& DestinationController::pickups(int elevatorId, Direction dir) {
+    return dir == Direction::Down ? pickupDown_[elevatorId] : pickupUp_[elevatorId];
+}
+
+void DestinationController::handleHallCall(int floor, Direction dir) {
+    if (!building_.isValidFloor(floor) || dir == Direction::Idle) {
+        return;
+    }
+    
+    int elevatorId = -1;
+    {
+        std::lock_guard<ProfiledMutex> lock(mutex_);
+        if (!pending_[hallCallSlot(floor, dir)].empty()) {
+            return;  // A car is already coming to this floor in this direction
+        }
+        elevatorId = allocate(floor, dir, -1, false);
+    }
+    
+    if (elevatorId >= 0) {
+        dispatch(elevatorId);
+    }
+}
+
+void DestinationController::handleDestinationCall(int origin, int destination) {
+    allocateTrip(origin, destination, true);
+}
+
+void DestinationController::handlePassengerCall(int origin, int destination) {
+    allocateTrip(origin, destination, false);
+}
+
+void DestinationController::allocateTrip(int origin, int destination, bool keyed) {
+    if (!building_.isValidFloor(origin) || !building_.isValidFloor(destination) ||
+        origin == destination) {
+        return;
+    }
+    Direction dir = destination > origin ? Direction::Up : Direction::Down;
+    
+    int elevatorId = -1;
+    {
+        std::lock_guard<ProfiledMutex> lock(mutex_);
+        for (Allocation& allocation : pending_[hallCallSlot(origin, dir)]) {
+            if (allocation.destinations.test(destination)) {
+                if (keyed) {
+                    allocation.keyed.set(destination);
+                }
+                return;  // Same trip already allocated
+            }
+        }
+        elevatorId = allocate(origin, dir, destination, keyed);
+    }
+    
+    if (elevatorId >= 0) {
+        dispatch(elevatorId);
+    }
+}
+
+int DestinationController::selectCar(int origin, Direction dir, int destination) const {
+    const Config& config = building_.getConfig();
+    int stopCost = stopCostFloors(config);
+    
+    // Floors of the destination's zone
+    int zoneLow = destination > 0 ? getZone(destination) * zoneSize_ + 1 : 0;
+    int zoneHigh = zoneLow + zoneSize_ - 1;
+    
+    int bestElevator = -1;
+    int bestCost = std::numeric_limits<int>::max();
+    for (int i = 0; i < building_.getNumElevators(); ++i) {
+        const Elevator& elev = building_.getElevator(i);
+        int cost = elev.costToServe(origin, dir, config.numFloors);
+        
+        // Another stop at the origin, unless this car already picks up there
+        const FloorMask& pickupMask = dir == Direction::Down ? pickupDown_[i] : pickupUp_[i];
+        if (!pickupMask.test(origin)) {
+            cost += stopCost;
+        }
+        // A zone this car does not serve yet means stops it would not make
+        if (destination > 0) {
+            FloorMask stops = elev.getCarCalls();
+            stops |= planned_[i];
+            int next = stops.nextAbove(zoneLow - 1);
+            if (next < 0 || next > zoneHigh) {
+                cost += 2 * stopCost;
+            }
+        }
+        // Promised a full load already
+        if (elev.getPassengerCount() + promised_[i] >= elev.getCapacity()) {
+            cost += 4 * config.numFloors;
+        }
+        
+        if (cost < bestCost) {
+            bestCost = cost;
+            bestElevator = i;
+        }
+    }
+    return bestElevator;
+}
+
+int DestinationController::allocate(int origin, Direction dir, int destination, bool keyed) {
+    int elevatorId = selectCar(origin, dir, destination);
+    if (elevatorId < 0) {
+        return -1;
+    }
+    
+    std::vector<Allocation>& allocations = pending_[hallCallSlot(origin, dir)];
+    auto it = std::find_if(allocations.begin(), allocations.end(),
+                           [elevatorId](const Allocation& a) { return a.car == elevatorId; });
+    if (it == allocations.end()) {
+        allocations.push_back(Allocation{elevatorId, FloorMask(), FloorMask(), 0});
+        it = allocations.end() - 1;
+    }
+    if (destination > 0) {
+        it->destinations.set(destination);
+        if (keyed) {
+            it->keyed.set(destination);
+        }
+        planned_[elevatorId].set(destination);
+    }
+    ++it->requests;
+    ++promised_[elevatorId];
+    pickups(elevatorId, dir).set(origin);
+    building_.registerHallCall(origin, dir);
+    return elevatorId;
+}
+
+void DestinationController::servePickup(int elevatorId, int floor, Direction dir) {
+    if (dir == Direction::Idle) {
+        return;
+    }
+    
+    std::lock_guard<ProfiledMutex> lock(mutex_);
+    FloorMask& mask = pickups(elevatorId, dir);
+    if (!mask.test(floor)) {
+        return;
+    }
+    mask.reset(floor);
+    
+    std::vector<Allocation>& allocations = pending_[hallCallSlot(floor, dir)];
+    for (size_t i = 0; i < allocations.size(); ++i) {
+        if (allocations[i].car != elevatorId) {
+            continue;
+        }
+        // Riders press their own car calls as they board
+        for (int destination : allocations[i].keyed) {
+            building_.registerCarCall(elevatorId, destination);
+        }
+        boardingFloor_[elevatorId] = floor;
+        boardingTo_[elevatorId] |= allocations[i].destinations;
+        promised_[elevatorId] -= allocations[i].requests;
+        allocations.erase(allocations.begin() + static_cast<std::ptrdiff_t>(i));
+        break;
+    }
+    if (allocations.empty()) {
+        building_.clearHallCall(floor, dir);
+    }
+    
+    // Planned destinations: whatever this car still has to pick up
+    FloorMask planned;
+    for (Direction d : {Direction::Up, Direction::Down}) {
+        for (int origin : pickups(elevatorId, d)) {
+            for (const Allocation& allocation : pending_[hallCallSlot(origin, d)]) {
+                if (allocation.car == elevatorId) {
+                    planned |= allocation.destinations;
+                }
+            }
+        }
+    }
+    planned_[elevatorId] = planned;
+}
+
+void DestinationController::endStop(int elevatorId) {
+    std::lock_guard<ProfiledMutex> lock(mutex_);
+    boardingFloor_[elevatorId] = -1;
+    boardingTo_[elevatorId].clear();
+}
+
+void DestinationController::handleCarCall(int elevatorId, int floor) {
+    if (!building_.isValidElevator(elevatorId) || !building_.isValidFloor(floor)) {
+        return;
+    }
+    
+    building_.registerCarCall(elevatorId, floor);
+    dispatch(elevatorId);
+}
+
+void DestinationController::onElevatorArrived(int elevatorId, int floor) {
+    Direction dir = building_.getElevator(elevatorId).getDirection();
+    
+    building_.clearCarCall(elevatorId, floor);
+    endStop(elevatorId);
+    servePickup(elevatorId, floor, dir);
+    
+    // Turning around here: pick up the other direction too
+    FloorMask ahead = destinationsOf(elevatorId);
+    {
+        std::lock_guard<ProfiledMutex> lock(mutex_);
+        ahead |= boardingTo_[elevatorId];
+    }
+    if (!anyAhead(ahead, floor, dir)) {
+        servePickup(elevatorId, floor, opposite(dir));
+    }
+}
+
+void DestinationController::onDoorsOpened(int elevatorId, int floor) {
+    (void)elevatorId;
+    (void)floor;
+}
+
+void DestinationController::onDoorsClosed(int elevatorId) {
+    dispatch(elevatorId);
+}
+
+void DestinationController::tick() {
+    const FleetState& fleet = building_.getFleet();
+    for (int i = 0; i < fleet.size(); ++i) {
+        if (fleet.state[i] == ElevatorState::Idle) {
+            dispatch(i);
+        }
+    }
+}
+
+int DestinationController::quietTicks() {
+    const FleetState& fleet = building_.getFleet();
+    for (int i = 0; i < fleet.size(); ++i) {
+        if (fleet.state[i] == ElevatorState::Idle && !destinationsOf(i).empty()) {
+            return 0;
+        }
+    }
+    return std::numeric_limits<int>::max();
+}
+
+bool DestinationController::shouldStopAt(int elevatorId, int floor) {
+    const Elevator& elev = building_.getElevator(elevatorId);
+    Direction dir = elev.getDirection();
     
-    for (const auto& claim : getClaimsFor(elevatorId)) {
-        destinations.insert(claim.first);
+    if (elev.hasCarCallAt(floor)) {
+        return true;
     }
+    if (!anyAhead(destinationsOf(elevatorId), floor, dir)) {
+        return true;  // Nothing further on: this is the last stop
+    }
+    
+    std::lock_guard<ProfiledMutex> lock(mutex_);
+    return elev.canBoard() && pickups(elevatorId, dir).test(floor);
+}
+
+bool DestinationController::acceptsPassenger(int elevatorId, int origin, int destination) {
+    // Only the trips allocated to this car and picked up at this stop
+    std::lock_guard<ProfiledMutex> lock(mutex_);
+    return boardingFloor_[elevatorId] == origin && boardingTo_[elevatorId].test(destination);
+}
+
+int DestinationController::getAllocation(int origin, int destination) const {
+    if (!building_.isValidFloor(origin) || !building_.isValidFloor(destination) ||
+        origin == destination) {
+        return -1;
+    }
+    Direction dir = destination > origin ? Direction::Up : Direction::Down;
     
+    std::lock_guard<ProfiledMutex> lock(mutex_);
+    for (const Allocation& allocation : pending_[hallCallSlot(origin, dir)]) {
+        if (allocation.destinations.test(destination)) {
+            return allocation.car;
+        }
+    }
+    return -1;
+}
+
+FloorMask DestinationController::destinationsOf(int elevatorId) {
+    const Elevator& elev = building_.getElevator(elevatorId);
+    FloorMask destinations = elev.getCarCalls();
+    
+    // A full car delivers its riders before picking anyone else up
+    if (elev.canBoard() || destinations.empty()) {
+        std::lock_guard<ProfiledMutex> lock(mutex_);
+        destinations |= pickupUp_[elevatorId];
+        destinations |= pickupDown_[elevatorId];
+    }
+    return destinations;
+}
+
+void DestinationController::dispatch(int elevatorId) {
+    Elevator& elev = building_.getElevator(elevatorId);
+    
+    if (elev.getState() != ElevatorState::Idle) {
+        return;
+    }
+    
+    FloorMask destinations = destinationsOf(elevatorId);
     if (destinations.empty()) {
         return;
     }
     
-    // Go to closest
     int current = elev.getCurrentFloor();
-    auto closest = std::min_element(destinations.begin(), destinations.end(),
-        [current](int a, int b) {
-            return std::abs(a - current) < std::abs(b - current);
-        });
-    
-    int target = *closest;
+    int target = pickTarget(DispatchPolicy::Collective, current, sweep_[elevatorId], destinations);
     
     if (target == current) {
+        // Pick up here: the sweep direction first, else the other one
+        Direction first = sweep_[elevatorId] == Direction::Down ? Direction::Down : Direction::Up;
+        bool hasFirst;
+        {
+            std::lock_guard<ProfiledMutex> lock(mutex_);
+            hasFirst = pickups(elevatorId, first).test(current);
+        }
+        building_.clearCarCall(elevatorId, current);
+        endStop(elevatorId);
+        servePickup(elevatorId, current, hasFirst ? first : opposite(first));
         elev.openDoors(building_.getConfig().doorOpenTicks);
     } else {
         Direction dir = (target > current) ? Direction::Up : Direction::Down;
-        elev.startMoving(dir, building_.getConfig().floorTravelTicks);
+        sweep_[elevatorId] = dir;
+        elev.startMoving(dir, building_.getMotion().passTicks(1));
+    }
+}
+
+void DestinationController::saveState(SnapshotWriter& out) const {
+    std::lock_guard<ProfiledMutex> lock(mutex_);
+    int slots = static_cast<int>(std::count_if(pending_.begin(), pending_.end(),
+                                               [](const auto& list) { return !list.empty(); }));
+    out.putInt(slots);
+    for (size_t slot = 0; slot < pending_.size(); ++slot) {
+        if (pending_[slot].empty()) continue;
+        out.putInt(static_cast<int>(slot));
+        out.putInt(static_cast<int>(pending_[slot].size()));
+        for (const Allocation& allocation : pending_[slot]) {
+            out.putInt(allocation.car);
+            out.putMask(allocation.destinations);
+            out.putMask(allocation.keyed);
+            out.putInt(allocation.requests);
+        }
+    }
+    for (int car = 0; car < building_.getNumElevators(); ++car) {
+        out.putMask(pickupUp_[car]);
+        out.putMask(pickupDown_[car]);
+        out.putMask(planned_[car]);
+        out.putInt(promised_[car]);
+        out.putEnum(sweep_[car]);
+        out.putInt(boardingFloor_[car]);
+        out.putMask(boardingTo_[car]);
+    }
+}
+
+void DestinationController::loadState(SnapshotReader& in) {
+    std::lock_guard<ProfiledMutex> lock(mutex_);
+    const int numFloors = building_.getNumFloors();
+    const int numCars = building_.getNumElevators();
+    for (auto& list : pending_) {
+        list.clear();
+    }
+    
+    for (int n = in.getInt(0, static_cast<int>(pending_.size())); n > 0; --n) {
+        int slot = in.getInt(hallCallSlot(1, Direction::Up),
+                             hallCallSlot(numFloors, Direction::Down));
+        for (int count = in.getInt(1, numCars); count > 0; --count) {
+            Allocation allocation;
+            allocation.car = in.getInt(0, numCars - 1);
+            allocation.destinations = in.getMask(numFloors);
+            allocation.keyed = in.getMask(numFloors);
+            allocation.requests = in.getInt(0, std::numeric_limits<int>::max());
+            pending_[slot].push_back(allocation);
+        }
+    }
+    for (int car = 0; car < numCars; ++car) {
+        pickupUp_[car] = in.getMask(numFloors);
+        pickupDown_[car] = in.getMask(numFloors);
+        planned_[car] = in.getMask(numFloors);
+        promised_[car] = in.getInt(0, std::numeric_limits<int>::max());
+        sweep_[car] = in.getEnum(Direction::Idle);
+        boardingFloor_[car] = in.getInt(-1, numFloors);
+        boardingTo_[car] = in.getMask(numFloors);
     }
 }
 
@@ -347,6 +1315,8 @@ std::unique_ptr<IScheduler> createScheduler(
             return std::make_unique<MasterController>(building, queue);
         case ControllerType::Distributed:
             return std::make_unique<DistributedController>(building, queue);
+        case ControllerType::Destination:
+            return std::make_unique<DestinationController>(building, queue);
     }
     return nullptr;
 }
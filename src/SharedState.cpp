@@ -0,0 +1,198 @@
+#include "SharedState.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::size_t kMaskWords = FloorMask::kWords;
+constexpr std::size_t kCarWords = 2 + kMaskWords;  // Motion, load, car calls
+constexpr std::size_t kHeaderBytes = sizeof(SharedStateHeader);
+
+std::size_t regionBytes(int numCars) {
+    return kHeaderBytes + (2 * kMaskWords + static_cast<std::size_t>(numCars) * kCarWords) * 8;
+}
+
+// "/name", as shm_open wants it
+std::string objectName(const std::string& name) {
+    std::string full = !name.empty() && name[0] == '/' ? name : "/" + name;
+    if (full.size() < 2 || full.size() > 255 || full.find('/', 1) != std::string::npos) {
+        throw std::invalid_argument("Invalid shared-memory name: " + name);
+    }
+    return full;
+}
+
+std::runtime_error systemError(const std::string& what, const std::string& name) {
+    return std::runtime_error(what + " " + name + ": " + std::strerror(errno));
+}
+
+}  // namespace
+
+// ============== Shared State Writer ==============
+
+SharedStateWriter::SharedStateWriter(const std::string& name, int numFloors, int numCars)
+    : name_(objectName(name)), bytes_(regionBytes(numCars)), numCars_(numCars) {
+    if (numFloors < 1 || numFloors > kMaxFloors || numCars < 1 || numCars > kMaxElevators) {
+        throw std::invalid_argument("Invalid shared-memory shape");
+    }
+
+    // A fresh object, so readers of a stale one never see it resized
+    shm_unlink(name_.c_str());
+    int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        throw systemError("Cannot create shared memory", name_);
+    }
+    if (ftruncate(fd, static_cast<off_t>(bytes_)) != 0) {
+        close(fd);
+        shm_unlink(name_.c_str());
+        throw systemError("Cannot size shared memory", name_);
+    }
+    data_ = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);  // The mapping keeps the object open
+    if (data_ == MAP_FAILED) {
+        data_ = nullptr;
+        shm_unlink(name_.c_str());
+        throw systemError("Cannot map shared memory", name_);
+    }
+
+    // The new object is zero-filled: fill in the header, magic last
+    header_ = static_cast<SharedStateHeader*>(data_);
+    words_ = reinterpret_cast<std::atomic<std::uint64_t>*>(
+        static_cast<char*>(data_) + kHeaderBytes);
+    header_->version = kSharedStateVersion;
+    header_->headerBytes = static_cast<std::uint16_t>(kHeaderBytes);
+    header_->numFloors = static_cast<std::uint32_t>(numFloors);
+    header_->numCars = static_cast<std::uint32_t>(numCars);
+    header_->maskWords = static_cast<std::uint32_t>(kMaskWords);
+    header_->carBytes = static_cast<std::uint32_t>(kCarWords * 8);
+    header_->totalBytes = bytes_;
+    header_->magic.store(kSharedStateMagic, std::memory_order_release);
+}
+
+SharedStateWriter::~SharedStateWriter() {
+    if (data_) {
+        munmap(data_, bytes_);
+        shm_unlink(name_.c_str());
+    }
+}
+
+void SharedStateWriter::publish(int tick, const FleetState& fleet, const FloorMask& upCalls,
+                                const FloorMask& downCalls) {
+    std::uint64_t seq = header_->sequence.load(std::memory_order_relaxed);
+    header_->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    header_->tick.store(static_cast<std::uint32_t>(tick), std::memory_order_relaxed);
+    for (std::size_t w = 0; w < kMaskWords; ++w) {
+        words_[w].store(upCalls.words()[w], std::memory_order_relaxed);
+        words_[kMaskWords + w].store(downCalls.words()[w], std::memory_order_relaxed);
+    }
+    std::atomic<std::uint64_t>* car = words_ + 2 * kMaskWords;
+    for (int i = 0; i < numCars_; ++i, car += kCarWords) {
+        car[0].store(packCarMotion(fleet, i), std::memory_order_relaxed);
+        car[1].store(packCarLoad(fleet, i), std::memory_order_relaxed);
+        for (std::size_t w = 0; w < kMaskWords; ++w) {
+            car[2 + w].store(fleet.carCalls[i].words()[w], std::memory_order_relaxed);
+        }
+    }
+
+    header_->sequence.store(seq + 2, std::memory_order_release);
+}
+
+// ============== Shared State Reader ==============
+
+SharedStateReader::SharedStateReader(const std::string& name) {
+    std::string full = objectName(name);
+    int fd = shm_open(full.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw systemError("Cannot open shared memory", full);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < kHeaderBytes) {
+        close(fd);
+        throw std::runtime_error("Shared memory " + full + " is not an elevator state export");
+    }
+    bytes_ = static_cast<std::size_t>(info.st_size);
+    data_ = mmap(nullptr, bytes_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data_ == MAP_FAILED) {
+        data_ = nullptr;
+        throw systemError("Cannot map shared memory", full);
+    }
+
+    header_ = static_cast<const SharedStateHeader*>(data_);
+    words_ = reinterpret_cast<const std::atomic<std::uint64_t>*>(
+        static_cast<const char*>(data_) + kHeaderBytes);
+    const auto floors = static_cast<std::int64_t>(header_->numFloors);
+    const auto cars = static_cast<std::int64_t>(header_->numCars);
+    std::string problem;
+    if (header_->magic.load(std::memory_order_acquire) != kSharedStateMagic) {
+        problem = "is not an elevator state export (or not yet initialised)";
+    } else if (header_->version != kSharedStateVersion) {
+        problem = "has layout version " + std::to_string(header_->version) +
+                  ", expected " + std::to_string(kSharedStateVersion);
+    } else if (header_->headerBytes != kHeaderBytes || header_->maskWords != kMaskWords ||
+               header_->carBytes != kCarWords * 8 || floors < 1 || floors > kMaxFloors ||
+               cars < 1 || cars > kMaxElevators ||
+               header_->totalBytes != regionBytes(static_cast<int>(cars)) ||
+               header_->totalBytes > bytes_) {
+        problem = "has an inconsistent header";
+    }
+    if (!problem.empty()) {
+        munmap(data_, bytes_);
+        data_ = nullptr;
+        throw std::runtime_error("Shared memory " + full + " " + problem);
+    }
+    numFloors_ = static_cast<int>(floors);
+    numCars_ = static_cast<int>(cars);
+}
+
+SharedStateReader::~SharedStateReader() {
+    if (data_) {
+        munmap(data_, bytes_);
+    }
+}
+
+bool SharedStateReader::tryRead(FleetSnapshot& out) const {
+    if (out.fleet.size() != numCars_) {
+        out.fleet = FleetState(numCars_, 0, 1);
+    }
+    std::uint64_t before = header_->sequence.load(std::memory_order_acquire);
+    if (before & 1) {
+        return false;  // Publish in progress
+    }
+
+    out.tick = static_cast<int>(header_->tick.load(std::memory_order_relaxed));
+    for (std::size_t w = 0; w < kMaskWords; ++w) {
+        out.upCalls.words()[w] = words_[w].load(std::memory_order_relaxed);
+        out.downCalls.words()[w] = words_[kMaskWords + w].load(std::memory_order_relaxed);
+    }
+    const std::atomic<std::uint64_t>* car = words_ + 2 * kMaskWords;
+    for (int i = 0; i < numCars_; ++i, car += kCarWords) {
+        unpackCarMotion(car[0].load(std::memory_order_relaxed), out.fleet, i);
+        unpackCarLoad(car[1].load(std::memory_order_relaxed), out.fleet, i);
+        for (std::size_t w = 0; w < kMaskWords; ++w) {
+            out.fleet.carCalls[i].words()[w] = car[2 + w].load(std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return header_->sequence.load(std::memory_order_relaxed) == before;
+}
+
+void SharedStateReader::read(FleetSnapshot& out) const {
+    while (!tryRead(out)) {
+        std::this_thread::yield();
+    }
+}
+
+FleetSnapshot SharedStateReader::read() const {
+    FleetSnapshot out;
+    read(out);
+    return out;
+}
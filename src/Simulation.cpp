@@ -1,101 +1,52 @@
 #include "Simulation.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
 #include <iomanip>
+#include <limits>
 #include <sstream>
+#include <stdexcept>
+#include <unistd.h>
 
 // ============== Logger Implementation ==============
 
 Logger::Logger(std::ostream& out, bool enabled)
-    : out_(out), enabled_(enabled) {}
+    : out_(out), enabled_(enabled) {
+    if (enabled_) {
+        sink_ = std::make_unique<AsyncLogSink>(out_);
+    }
+}
 
 void Logger::setTickReference(std::atomic<int>* tick) {
     tickRef_ = tick;
 }
 
-void Logger::log(const std::string& message) {
-    if (!enabled_) return;
-    
-    std::lock_guard<std::mutex> lock(mutex_);
-    out_ << getTimestamp() << " " << message << "\n";
-}
-
-void Logger::logEvent(const Event& event) {
-    if (!enabled_) return;
-    
-    std::ostringstream oss;
-    oss << "[EVENT] ";
-    
-    switch (event.type) {
-        case EventType::HallCall:
-            oss << "HallCall floor=" << event.floor 
-                << " dir=" << directionToString(event.direction);
-            break;
-        case EventType::CarCall:
-            oss << "CarCall elevator=" << event.elevatorId 
-                << " floor=" << event.floor;
-            break;
-        case EventType::ElevatorArrived:
-            oss << "ElevatorArrived elevator=" << event.elevatorId 
-                << " floor=" << event.floor;
-            break;
-        case EventType::DoorsOpened:
-            oss << "DoorsOpened elevator=" << event.elevatorId;
-            break;
-        case EventType::DoorsClosed:
-            oss << "DoorsClosed elevator=" << event.elevatorId;
-            break;
-        case EventType::Tick:
-            oss << "Tick";
-            break;
-        case EventType::Shutdown:
-            oss << "Shutdown";
-            break;
-    }
-    
-    log(oss.str());
+void Logger::setRawOutput(const std::string& path) {
+    sink_.reset();  // Drain the text sink before switching
+    sink_ = std::make_unique<AsyncLogSink>(out_, path);
 }
 
-void Logger::logElevatorState(const Elevator& elev) {
+void Logger::log(const std::string& message) {
     if (!enabled_) return;
-    
-    std::ostringstream oss;
-    oss << "[ELEVATOR " << elev.getId() << "] "
-        << "floor=" << elev.getCurrentFloor() << " "
-        << "state=" << stateToString(elev.getState()) << " "
-        << "dir=" << directionToString(elev.getDirection()) << " "
-        << "passengers=" << elev.getPassengerCount();
-    
-    auto calls = elev.getCarCalls();
-    if (!calls.empty()) {
-        oss << " carCalls={";
-        bool first = true;
-        for (int c : calls) {
-            if (!first) oss << ",";
-            oss << c;
-            first = false;
-        }
-        oss << "}";
-    }
-    
-    log(oss.str());
+    sink_->writeLine(getTimestamp() + " " + message);
 }
 
-void Logger::logHallCall(int floor, Direction dir) {
-    log("[HALL CALL] floor=" + std::to_string(floor) + 
-        " dir=" + directionToString(dir));
+void Logger::flush() {
+    if (sink_) sink_->flush();
 }
 
-void Logger::logCarCall(int elevatorId, int floor) {
-    log("[CAR CALL] elevator=" + std::to_string(elevatorId) + 
-        " floor=" + std::to_string(floor));
+std::uint64_t Logger::getDropped() const {
+    return sink_ ? sink_->getDropped() : 0;
 }
 
-void Logger::logAssignment(int elevatorId, int floor, Direction dir) {
-    log("[ASSIGNMENT] elevator=" + std::to_string(elevatorId) + 
-        " -> floor=" + std::to_string(floor) + 
-        " dir=" + directionToString(dir));
+void Logger::enable() {
+    // The background writer only exists while someone wants output
+    if (!sink_) {
+        sink_ = std::make_unique<AsyncLogSink>(out_);
+    }
+    enabled_ = true;
 }
 
-void Logger::enable() { enabled_ = true; }
 void Logger::disable() { enabled_ = false; }
 bool Logger::isEnabled() const { return enabled_; }
 
@@ -116,17 +67,54 @@ std::string Logger::getTimestamp() const {
 // ============== Simulation Engine Implementation ==============
 
 SimulationEngine::SimulationEngine(const Config& config)
-    : building_(config), config_(config) {
+    : building_(config), passengers_(building_),
+      logger_(std::cout, config.loggingEnabled), config_(config) {
     
+    if (config.loggingEnabled && !config.logFile.empty()) {
+        logger_.setRawOutput(config.logFile);
+    }
     logger_.setTickReference(&currentTick_);
+    profiler_.setEnabled(config.profiling);
     createScheduler();
     
+    outboxes_.resize(config.numElevators);
+    eventQueue_.reserve(kEventReserve);
+    pendingEvents_.reserve(kEventReserve);
+    pendingHallCalls_.reserve(kEventReserve);
+    if (config.carWorkers > 0 && scheduler_->supportsCarWorkers()) {
+        carPool_ = std::make_unique<WorkerPool>(config.carWorkers - 1);
+    }
+    
     logger_.log("Simulation initialized with " + 
                 std::to_string(config.numFloors) + " floors, " +
                 std::to_string(config.numElevators) + " elevators");
     logger_.log("Controller: " + scheduler_->getName());
 }
 
+namespace {
+
+// Shape and controller from the snapshot, tunables from the caller
+Config restoredConfig(const SimulationSnapshot& snapshot, const Config& config) {
+    Config saved = snapshot.getConfig();
+    Config restored = config;
+    restored.numFloors = saved.numFloors;
+    restored.numElevators = saved.numElevators;
+    restored.carCapacity = saved.carCapacity;
+    restored.controllerType = saved.controllerType;
+    return restored;
+}
+
+}  // namespace
+
+SimulationEngine::SimulationEngine(const SimulationSnapshot& snapshot)
+    : SimulationEngine(snapshot, snapshot.getConfig()) {}
+
+SimulationEngine::SimulationEngine(const SimulationSnapshot& snapshot, const Config& config)
+    : SimulationEngine(restoredConfig(snapshot, config)) {
+    restoreState(snapshot);
+    logger_.log("Restored snapshot at tick " + std::to_string(currentTick_.load()));
+}
+
 SimulationEngine::~SimulationEngine() {
     stop();
 }
@@ -139,7 +127,9 @@ void SimulationEngine::start() {
     if (running_.load()) return;
     
     running_.store(true);
-    logger_.log("Simulation starting...");
+    startTime_ = std::chrono::steady_clock::now();
+    logger_.log(config_.headless ? "Simulation starting (headless)..."
+                                 : "Simulation starting...");
     
     // Start simulation loop thread
     threads_.emplace_back(&SimulationEngine::runSimulationLoop, this);
@@ -162,6 +152,7 @@ void SimulationEngine::stop() {
     }
     threads_.clear();
     
+    logger_.flush();
     logger_.log("Simulation stopped.");
 }
 
@@ -169,67 +160,200 @@ bool SimulationEngine::isRunning() const {
     return running_.load();
 }
 
-void SimulationEngine::requestHallCall(int floor, Direction dir) {
-    if (!building_.isValidFloor(floor)) {
-        logger_.log("[ERROR] Invalid floor: " + std::to_string(floor));
-        return;
+RunStats SimulationEngine::runTicks(int count) {
+    RunStats stats;
+    if (running_.load()) {
+        logger_.log("[ERROR] runTicks called while simulation thread is running");
+        return stats;
     }
     
-    if (dir == Direction::Idle) {
-        logger_.log("[ERROR] Hall call must have Up or Down direction");
-        return;
+    long long eventsBefore = eventsProcessed_.load();
+    auto begin = std::chrono::steady_clock::now();
+    
+    for (int i = 0; i < count;) {
+        int skip = quietSpan(count - i);
+        if (skip > 0) {
+            skipQuietTicks(skip);
+            i += skip;
+        } else {
+            step();
+            ++i;
+        }
     }
     
-    // Boundary checks
-    if (floor == 1 && dir == Direction::Down) {
-        logger_.log("[WARN] Cannot go down from floor 1");
-        return;
+    stats.ticks = count > 0 ? count : 0;
+    stats.eventsProcessed = eventsProcessed_.load() - eventsBefore;
+    stats.elapsedSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - begin).count();
+    return stats;
+}
+
+void SimulationEngine::requestHallCall(int floor, Direction dir) {
+    submitRequest(Request::hallCall(floor, dir));
+}
+
+void SimulationEngine::requestPassenger(int origin, int destination) {
+    submitRequest(Request::passenger(origin, destination));
+}
+
+void SimulationEngine::requestDestinationCall(int origin, int destination) {
+    submitRequest(Request::destinationCall(origin, destination));
+}
+
+int SimulationEngine::spawnPassenger(int origin, int destination) {
+    if (running_.load()) {
+        throw std::logic_error("spawnPassenger called while simulation thread is running");
     }
-    if (floor == building_.getNumFloors() && dir == Direction::Up) {
-        logger_.log("[WARN] Cannot go up from top floor");
-        return;
+    Event event{};
+    if (!acceptRequest(Request::passenger(origin, destination), event)) {
+        return -1;
     }
-    
-    logger_.logHallCall(floor, dir);
-    
-    Event event;
-    event.type = EventType::HallCall;
-    event.floor = floor;
-    event.direction = dir;
-    eventQueue_.push(event);
+    logger_.logEvent(event);
+    eventsProcessed_.fetch_add(1, std::memory_order_relaxed);
+    int id = passengers_.spawn(origin, destination, currentTick_.load());
+    scheduler_->handlePassengerCall(origin, destination);
+    return id;
 }
 
 void SimulationEngine::requestCarCall(int elevatorId, int floor) {
-    if (!building_.isValidElevator(elevatorId)) {
-        logger_.log("[ERROR] Invalid elevator: " + std::to_string(elevatorId));
-        return;
-    }
-    if (!building_.isValidFloor(floor)) {
-        logger_.log("[ERROR] Invalid floor: " + std::to_string(floor));
-        return;
+    submitRequest(Request::carCall(elevatorId, floor));
+}
+
+void SimulationEngine::request(const Request& request) {
+    submitRequest(request);
+}
+
+size_t SimulationEngine::requestBatch(const Request* requests, size_t count) {
+    // Per producer thread, so repeated bursts reuse one buffer
+    thread_local std::vector<Event> accepted;
+    accepted.clear();
+    accepted.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        Event event;
+        if (acceptRequest(requests[i], event)) {
+            accepted.push_back(event);
+        }
     }
     
-    logger_.logCarCall(elevatorId, floor);
-    
+    if (traceRecorder_) {
+        traceRecorder_->record(currentTick_.load(), accepted.data(), accepted.size());
+    }
+    eventQueue_.pushBatch(accepted.begin(), accepted.end());
+    return accepted.size();
+}
+
+size_t SimulationEngine::requestBatch(const std::vector<Request>& requests) {
+    return requestBatch(requests.data(), requests.size());
+}
+
+void SimulationEngine::submitRequest(const Request& request) {
     Event event;
-    event.type = EventType::CarCall;
-    event.elevatorId = elevatorId;
-    event.floor = floor;
+    if (!acceptRequest(request, event)) {
+        return;
+    }
+    if (traceRecorder_) {
+        traceRecorder_->record(currentTick_.load(), event);
+    }
     eventQueue_.push(event);
 }
 
+bool SimulationEngine::acceptRequest(const Request& request, Event& event) {
+    event.type = request.type;
+    event.floor = static_cast<std::int16_t>(request.floor);
+    event.tick = currentTick_.load();
+    
+    switch (request.type) {
+        case EventType::HallCall: {
+            int floor = request.floor;
+            Direction dir = request.direction;
+            if (!building_.isValidFloor(floor)) {
+                logger_.log("[ERROR] Invalid floor: " + std::to_string(floor));
+                return false;
+            }
+            if (dir == Direction::Idle) {
+                logger_.log("[ERROR] Hall call must have Up or Down direction");
+                return false;
+            }
+            
+            // Boundary checks
+            if (floor == 1 && dir == Direction::Down) {
+                logger_.log("[WARN] Cannot go down from floor 1");
+                return false;
+            }
+            if (floor == building_.getNumFloors() && dir == Direction::Up) {
+                logger_.log("[WARN] Cannot go up from top floor");
+                return false;
+            }
+            
+            logger_.logHallCall(floor, dir);
+            event.direction = dir;
+            return true;
+        }
+        
+        case EventType::CarCall:
+            if (!building_.isValidElevator(request.elevatorId)) {
+                logger_.log("[ERROR] Invalid elevator: " + std::to_string(request.elevatorId));
+                return false;
+            }
+            if (!building_.isValidFloor(request.floor)) {
+                logger_.log("[ERROR] Invalid floor: " + std::to_string(request.floor));
+                return false;
+            }
+            
+            logger_.logCarCall(request.elevatorId, request.floor);
+            event.elevatorId = static_cast<std::int16_t>(request.elevatorId);
+            return true;
+        
+        case EventType::PassengerArrival:
+        case EventType::DestinationCall: {
+            int origin = request.floor;
+            int destination = request.destination;
+            bool keypad = request.type == EventType::DestinationCall;
+            if (!building_.isValidFloor(origin) || !building_.isValidFloor(destination)) {
+                logger_.log(std::string(keypad ? "[ERROR] Invalid destination call: "
+                                               : "[ERROR] Invalid passenger floors: ") +
+                            std::to_string(origin) + " -> " + std::to_string(destination));
+                return false;
+            }
+            if (origin == destination) {
+                logger_.log(std::string(keypad ? "[WARN] Destination call to its own floor "
+                                               : "[WARN] Passenger already at destination floor ") +
+                            std::to_string(origin));
+                return false;
+            }
+            
+            if (keypad) {
+                logger_.logDestinationCall(origin, destination);
+            } else {
+                logger_.logPassenger(origin, destination);
+            }
+            event.destination = static_cast<std::int16_t>(destination);
+            event.direction = destination > origin ? Direction::Up : Direction::Down;
+            return true;
+        }
+        
+        default:
+            logger_.log("[ERROR] Not a request type: " +
+                        std::to_string(static_cast<int>(request.type)));
+            return false;
+    }
+}
+
 void SimulationEngine::printStatus() const {
-    std::cout << "\n========== Status at Tick " << currentTick_.load() << " ==========\n";
+    // Read the last published snapshot: never touches live fleet state
+    FleetSnapshot snapshot = building_.getSnapshot();
+    const FleetState& fleet = snapshot.fleet;
+    
+    std::cout << "\n========== Status at Tick " << snapshot.tick << " ==========\n";
     
     // Print elevator states
-    for (int i = 0; i < building_.getNumElevators(); ++i) {
-        const Elevator& elev = building_.getElevator(i);
+    for (int i = 0; i < fleet.size(); ++i) {
         std::cout << "Elevator " << i << ": "
-                  << "Floor " << elev.getCurrentFloor() << ", "
-                  << stateToString(elev.getState()) << ", "
-                  << directionToString(elev.getDirection());
+                  << "Floor " << fleet.floor[i] << ", "
+                  << stateToString(fleet.state[i]) << ", "
+                  << directionToString(fleet.direction[i]);
         
-        auto calls = elev.getCarCalls();
+        const auto& calls = fleet.carCalls[i];
         if (!calls.empty()) {
             std::cout << ", CarCalls: {";
             bool first = true;
@@ -244,26 +368,203 @@ void SimulationEngine::printStatus() const {
     }
     
     // Print hall calls
-    auto hallCalls = building_.getAllHallCalls();
-    if (!hallCalls.empty()) {
+    FloorMask hallFloors = snapshot.upCalls | snapshot.downCalls;
+    if (hallFloors.any()) {
         std::cout << "Hall Calls: ";
-        for (const auto& [floor, dir] : hallCalls) {
-            std::cout << floor << directionToString(dir)[0] << " ";
+        for (int floor : hallFloors) {
+            if (snapshot.upCalls.test(floor)) std::cout << floor << "U ";
+            if (snapshot.downCalls.test(floor)) std::cout << floor << "D ";
         }
         std::cout << "\n";
     }
     
+    // Passenger SLAs (relaxed atomic reads, safe from any thread)
+    const PassengerMetrics& pm = passengers_.getMetrics();
+    if (pm.spawned.load(std::memory_order_relaxed) > 0) {
+        std::cout << "Passengers: " << pm.delivered.load(std::memory_order_relaxed)
+                  << " delivered, " << pm.waiting.load(std::memory_order_relaxed)
+                  << " waiting, " << pm.riding.load(std::memory_order_relaxed) << " riding\n"
+                  << "  Wait    p50/p95/p99: " << pm.waitTicks.percentile(0.50) << "/"
+                  << pm.waitTicks.percentile(0.95) << "/" << pm.waitTicks.percentile(0.99)
+                  << " ticks\n"
+                  << "  Journey p50/p95/p99: " << pm.journeyTicks.percentile(0.50) << "/"
+                  << pm.journeyTicks.percentile(0.95) << "/" << pm.journeyTicks.percentile(0.99)
+                  << " ticks\n";
+    }
+    
     std::cout << "==========================================\n\n";
 }
 
+RunStats SimulationEngine::replay(const TraceReader& trace, int drainTicks) {
+    RunStats stats;
+    if (running_.load()) {
+        logger_.log("[ERROR] replay called while simulation thread is running");
+        return stats;
+    }
+    
+    const TraceHeader& header = trace.getHeader();
+    if (header.numFloors != building_.getNumFloors() ||
+        header.numElevators != building_.getNumElevators()) {
+        logger_.log("[WARN] Trace recorded on " + std::to_string(header.numFloors) +
+                    " floors / " + std::to_string(header.numElevators) +
+                    " elevators; out-of-range calls will be rejected");
+    }
+    
+    long long eventsBefore = eventsProcessed_.load();
+    auto begin = std::chrono::steady_clock::now();
+    
+    const TraceRecord* next = trace.begin();
+    const TraceRecord* end = trace.end();
+    while (next != end) {
+        // Inject everything due at this tick, exactly as a live request
+        // arriving during this tick would be
+        int tick = currentTick_.load();
+        for (; next != end && static_cast<int>(next->tick) <= tick; ++next) {
+            Event event = next->toEvent();
+            if (event.type == EventType::HallCall) {
+                requestHallCall(event.floor, event.direction);
+            } else if (event.type == EventType::CarCall) {
+                requestCarCall(event.elevatorId, event.floor);
+            } else if (event.type == EventType::PassengerArrival) {
+                requestPassenger(event.floor, event.destination);
+            } else if (event.type == EventType::DestinationCall) {
+                requestDestinationCall(event.floor, event.destination);
+            }
+        }
+        // Quiet ticks up to the next record can be jumped over
+        int skip = next != end ? quietSpan(static_cast<int>(next->tick) - tick) : 0;
+        if (skip > 0) {
+            skipQuietTicks(skip);
+            stats.ticks += skip;
+            continue;
+        }
+        step();
+        ++stats.ticks;
+    }
+    
+    if (drainTicks > 0) {
+        stats.ticks += runTicks(drainTicks).ticks;
+    }
+    
+    stats.eventsProcessed = eventsProcessed_.load() - eventsBefore;
+    stats.elapsedSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - begin).count();
+    return stats;
+}
+
+SimulationSnapshot SimulationEngine::saveSnapshot() {
+    if (running_.load()) {
+        throw std::logic_error("saveSnapshot called while simulation thread is running");
+    }
+    
+    SnapshotWriter out;
+    writeConfig(out, config_);
+    out.putInt(currentTick_.load());
+    building_.saveState(out);
+    passengers_.saveState(out);
+    scheduler_->saveState(out);
+    
+    // Queued events go in and straight back, in order
+    std::vector<Event> queued;
+    eventQueue_.drain(queued);
+    eventQueue_.pushBatch(queued.begin(), queued.end());
+    out.putInt(static_cast<int>(queued.size()));
+    for (const Event& event : queued) {
+        out.putEnum(event.type);
+        out.putInt(event.floor);
+        out.putInt(event.elevatorId);
+        out.putEnum(event.direction);
+        out.putInt(event.destination);
+        out.putInt(event.tick);
+    }
+    
+    SimulationSnapshot snapshot;
+    snapshot.bytes = out.release();
+    return snapshot;
+}
+
+void SimulationEngine::restoreState(const SimulationSnapshot& snapshot) {
+    SnapshotReader in(snapshot.bytes);
+    readConfig(in);
+    int tick = in.getInt(0, std::numeric_limits<int>::max());
+    currentTick_.store(tick);
+    building_.setCurrentTick(tick);
+    building_.loadState(in);
+    passengers_.loadState(in);
+    scheduler_->loadState(in);
+    
+    for (int n = in.getInt(0, std::numeric_limits<int>::max()); n > 0; --n) {
+        Event event;
+        event.type = in.getEnum(EventType::DestinationCall);
+        event.floor = static_cast<std::int16_t>(in.getInt(-1, kMaxFloors));
+        event.elevatorId = static_cast<std::int16_t>(in.getInt(-1, kMaxElevators - 1));
+        event.direction = in.getEnum(Direction::Idle);
+        event.destination = static_cast<std::int16_t>(in.getInt(-1, kMaxFloors));
+        event.tick = in.getInt(0, tick);
+        eventQueue_.push(event);
+    }
+    if (!in.atEnd()) {
+        throw std::runtime_error("Corrupt snapshot: trailing data");
+    }
+}
+
+void SimulationEngine::setTraceRecorder(TraceWriter* recorder) {
+    traceRecorder_ = recorder;
+}
+
+const TickProfiler& SimulationEngine::getProfiler() const {
+    return profiler_;
+}
+
+ProfileCounters SimulationEngine::getProfileCounters() const {
+    ProfileCounters counters;
+    counters.queue = eventQueue_.counters();
+    counters.buildingContended = building_.getCallLockContention();
+    counters.schedulerContended = scheduler_->getLockContention();
+    counters.eventsProcessed = eventsProcessed_.load();
+    counters.tick = currentTick_.load();
+    return counters;
+}
+
+void SimulationEngine::printStats(std::ostream& out) const {
+    profiler_.printReport(out, getProfileCounters());
+}
+
+void SimulationEngine::writeMetrics(std::ostream& out) const {
+    profiler_.writePrometheus(out, getProfileCounters());
+}
+
+void SimulationEngine::setArrivalLog(std::vector<Passenger>* log) {
+    passengers_.setArrivalLog(log);
+}
+
 int SimulationEngine::getCurrentTick() const {
     return currentTick_.load();
 }
 
+long long SimulationEngine::getEventsProcessed() const {
+    return eventsProcessed_.load();
+}
+
+double SimulationEngine::getTicksPerSecond() const {
+    if (!running_.load()) return 0.0;
+    double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - startTime_).count();
+    return elapsed > 0.0 ? currentTick_.load() / elapsed : 0.0;
+}
+
+void SimulationEngine::flushLog() {
+    logger_.flush();
+}
+
 const Building& SimulationEngine::getBuilding() const {
     return building_;
 }
 
+const PassengerMetrics& SimulationEngine::getPassengerMetrics() const {
+    return passengers_.getMetrics();
+}
+
 Building& SimulationEngine::getBuildingMutable() {
     return building_;
 }
@@ -274,26 +575,88 @@ IScheduler& SimulationEngine::getScheduler() {
 
 void SimulationEngine::runSimulationLoop() {
     while (running_.load()) {
-        // Wait for tick duration
-        std::this_thread::sleep_for(
-            std::chrono::milliseconds(config_.tickDurationMs)
-        );
+        // Wait for tick duration (virtual time runs ticks back to back)
+        if (!config_.headless) {
+            std::this_thread::sleep_for(
+                std::chrono::milliseconds(config_.tickDurationMs)
+            );
+        }
         
         if (!running_.load()) break;
         
-        // Process tick
-        processTick();
-        ++currentTick_;
-        
-        // Process any pending events
-        while (auto event = eventQueue_.tryPop()) {
-            processEvent(*event);
+        step();
+    }
+}
+
+void SimulationEngine::step() {
+    const TickProfiler::Stamp begin = profiler_.start();
+    TickProfiler::Stamp lap = begin;
+    const long long eventsBefore = eventsProcessed_.load(std::memory_order_relaxed);
+    
+    // Process tick
+    processTick(lap);
+    ++currentTick_;
+    building_.setCurrentTick(currentTick_.load());
+    
+    // Process any pending events, one batch drain at a time
+    while (eventQueue_.drain(pendingEvents_) > 0) {
+        profiler_.lap(TickPhase::Drain, lap);
+        for (size_t i = 0; i < pendingEvents_.size();) {
+            if (pendingEvents_[i].type == EventType::HallCall) {
+                i = processHallCallRun(i);
+            } else {
+                processEvent(pendingEvents_[i++]);
+            }
+        }
+        pendingEvents_.clear();
+        profiler_.lap(TickPhase::Dispatch, lap);
+    }
+    profiler_.lap(TickPhase::Drain, lap);  // The final, empty drain
+    
+    // Publish a consistent view for monitoring threads
+    building_.publishSnapshot(currentTick_.load());
+    profiler_.lap(TickPhase::Publish, lap);
+    profiler_.endTick(begin, eventsProcessed_.load(std::memory_order_relaxed) - eventsBefore);
+}
+
+int SimulationEngine::quietSpan(int limit) {
+    if (config_.timeAdvance != TimeAdvance::NextEvent || limit <= 0 || !eventQueue_.empty()) {
+        return 0;
+    }
+    
+    // Ticks before the first car timer runs out (a car already at zero
+    // changes state on the very next tick)
+    const FleetState& fleet = building_.getFleet();
+    int span = limit;
+    for (int i = 0; i < fleet.size() && span > 0; ++i) {
+        if (fleet.state[i] != ElevatorState::Idle) {
+            span = std::min(span, fleet.ticksRemaining[i] - 1);
         }
     }
+    if (span <= 0) {
+        return 0;
+    }
+    return std::min(span, scheduler_->quietTicks());
+}
+
+void SimulationEngine::skipQuietTicks(int ticks) {
+    FleetState& fleet = building_.getFleet();
+    for (int i = 0; i < fleet.size(); ++i) {
+        if (fleet.state[i] != ElevatorState::Idle) {
+            fleet.ticksRemaining[i] -= ticks;
+        }
+    }
+    scheduler_->skipTicks(ticks);
+    profiler_.addSkippedTicks(ticks);
+    
+    currentTick_ += ticks;
+    building_.setCurrentTick(currentTick_.load());
+    building_.publishSnapshot(currentTick_.load());
 }
 
 void SimulationEngine::processEvent(const Event& event) {
     logger_.logEvent(event);
+    eventsProcessed_.fetch_add(1, std::memory_order_relaxed);
     
     switch (event.type) {
         case EventType::HallCall:
@@ -309,9 +672,19 @@ void SimulationEngine::processEvent(const Event& event) {
             break;
             
         case EventType::DoorsOpened:
+            passengers_.exchange(event.elevatorId, event.floor, currentTick_.load(), *scheduler_);
             scheduler_->onDoorsOpened(event.elevatorId, event.floor);
             break;
             
+        case EventType::PassengerArrival:
+            passengers_.spawn(event.floor, event.destination, currentTick_.load());
+            scheduler_->handlePassengerCall(event.floor, event.destination);
+            break;
+            
+        case EventType::DestinationCall:
+            scheduler_->handleDestinationCall(event.floor, event.destination);
+            break;
+            
         case EventType::DoorsClosed:
             scheduler_->onDoorsClosed(event.elevatorId);
             break;
@@ -325,75 +698,210 @@ void SimulationEngine::processEvent(const Event& event) {
     }
 }
 
-void SimulationEngine::processTick() {
+size_t SimulationEngine::processHallCallRun(size_t begin) {
+    pendingHallCalls_.clear();
+    size_t end = begin;
+    for (; end < pendingEvents_.size() && pendingEvents_[end].type == EventType::HallCall; ++end) {
+        const Event& event = pendingEvents_[end];
+        logger_.logEvent(event);
+        pendingHallCalls_.emplace_back(event.floor, event.direction);
+    }
+    eventsProcessed_.fetch_add(static_cast<long long>(end - begin), std::memory_order_relaxed);
+    
+    if (pendingHallCalls_.size() == 1) {
+        scheduler_->handleHallCall(pendingHallCalls_[0].first, pendingHallCalls_[0].second);
+    } else {
+        scheduler_->handleHallCalls(pendingHallCalls_);
+    }
+    return end;
+}
+
+void SimulationEngine::processTick(TickProfiler::Stamp& lap) {
+    if (carPool_) {
+        processTickParallel();
+        profiler_.lap(TickPhase::Cars, lap);
+        return;
+    }
     updateElevators();
+    profiler_.lap(TickPhase::Cars, lap);
     scheduler_->tick();
+    profiler_.lap(TickPhase::Scheduler, lap);
 }
 
 void SimulationEngine::updateElevators() {
+    CarOutbox& out = outboxes_[0];
     for (int i = 0; i < building_.getNumElevators(); ++i) {
-        Elevator& elev = building_.getElevator(i);
-        ElevatorState state = elev.getState();
-        
-        if (state == ElevatorState::Moving) {
-            elev.decrementTick();
-            if (elev.getTicksRemaining() == 0) {
-                // Arrived at next floor
-                int current = elev.getCurrentFloor();
-                int next = (elev.getDirection() == Direction::Up) ? current + 1 : current - 1;
-                elev.arriveAtFloor(next);
-                
-                Event event;
-                event.type = EventType::ElevatorArrived;
-                event.elevatorId = i;
-                event.floor = next;
-                eventQueue_.push(event);
-                
-                logger_.logElevatorState(elev);
+        advanceCar(i, out, false);
+    }
+    flushOutbox(out);
+}
+
+void SimulationEngine::processTickParallel() {
+    int cars = building_.getNumElevators();
+    
+    // Cars change concurrently: nothing may touch the shared cost index
+    building_.suspendCostIndex();
+    
+    carPool_->run(cars, [this](int i) { advanceCar(i, outboxes_[i], true); });
+    
+    bool anyPending = std::any_of(outboxes_.begin(), outboxes_.end(),
+                                  [](const CarOutbox& out) { return out.pendingStop >= 0; });
+    if (anyPending) {
+        carPool_->run(cars, [this](int i) {
+            CarOutbox& out = outboxes_[i];
+            if (out.pendingStop < 0) {
+                return;
             }
-        }
-        else if (state == ElevatorState::DoorsOpening) {
-            elev.decrementTick();
-            if (elev.getTicksRemaining() == 0) {
-                elev.setDoorsOpen(config_.doorOpenTicks);
-                
-                Event event;
-                event.type = EventType::DoorsOpened;
-                event.elevatorId = i;
-                event.floor = elev.getCurrentFloor();
-                eventQueue_.push(event);
+            int floor = out.pendingStop;
+            out.pendingStop = -1;
+            if (scheduler_->resolveStopAt(i, floor)) {
+                arriveCar(i, floor, out);
+            } else {
+                int next = building_.getFleet().runFloors[i] + 1;
+                building_.getElevator(i).passFloor(floor, building_.getMotion().passTicks(next));
             }
-        }
-        else if (state == ElevatorState::DoorsOpen) {
-            elev.decrementTick();
-            if (elev.getTicksRemaining() == 0) {
-                elev.closeDoors(1);  // 1 tick to close
+        });
+    }
+    
+    carPool_->run(cars, [this](int i) { scheduler_->bidCarTick(i); });
+    carPool_->run(cars, [this](int i) { scheduler_->resolveCarTick(i); });
+    
+    building_.resumeCostIndex();
+    for (CarOutbox& out : outboxes_) {
+        flushOutbox(out);
+    }
+}
+
+void SimulationEngine::advanceCar(int i, CarOutbox& out, bool bidding) {
+    // Read and count down straight from the fleet arrays; the Elevator
+    // handle is only used for the (rarer) state transitions
+    FleetState& fleet = building_.getFleet();
+    
+    ElevatorState state = fleet.state[i];
+    if (state == ElevatorState::Idle) {
+        return;
+    }
+    
+    int& ticks = fleet.ticksRemaining[i];
+    if (ticks > 0) {
+        --ticks;
+    }
+    if (ticks != 0) {
+        return;
+    }
+    
+    Elevator& elev = building_.getElevator(i);
+    
+    if (state == ElevatorState::Moving) {
+        // Arrived at next floor
+        int current = fleet.floor[i];
+        int next = (fleet.direction[i] == Direction::Up) ? current + 1 : current - 1;
+        ++out.floorsTraveled;
+        
+        // Pass through unless the scheduler wants this floor (always
+        // stop at the ends of the shaft)
+        bool atEnd = next <= 1 || next >= building_.getNumFloors();
+        if (!atEnd) {
+            StopDecision decision = bidding ? scheduler_->bidStopAt(i, next)
+                                  : scheduler_->shouldStopAt(i, next) ? StopDecision::Stop
+                                                                       : StopDecision::Pass;
+            if (decision == StopDecision::Bid) {
+                out.pendingStop = next;
+                return;
             }
-        }
-        else if (state == ElevatorState::DoorsClosing) {
-            elev.decrementTick();
-            if (elev.getTicksRemaining() == 0) {
-                // Check if more work
-                if (elev.hasAnyCarCalls() || !building_.getAllHallCalls().empty()) {
-                    Event event;
-                    event.type = EventType::DoorsClosed;
-                    event.elevatorId = i;
-                    eventQueue_.push(event);
-                } else {
-                    elev.setIdle();
-                }
+            if (decision == StopDecision::Pass) {
+                elev.passFloor(next, building_.getMotion().passTicks(fleet.runFloors[i] + 1));
+                return;
             }
         }
+        arriveCar(i, next, out);
+    }
+    else if (state == ElevatorState::DoorsOpening) {
+        elev.setDoorsOpen(config_.doorOpenTicks);
+        
+        Event event;
+        event.type = EventType::DoorsOpened;
+        event.elevatorId = i;
+        event.floor = fleet.floor[i];
+        out.events.push_back(event);
+    }
+    else if (state == ElevatorState::DoorsOpen) {
+        elev.closeDoors(1);  // 1 tick to close
+    }
+    else if (state == ElevatorState::DoorsClosing) {
+        // Doors shut: the car is free to be dispatched again
+        elev.setIdle();
+        
+        // Check if more work
+        if (elev.hasAnyCarCalls() || building_.hasAnyHallCalls()) {
+            Event event;
+            event.type = EventType::DoorsClosed;
+            event.elevatorId = i;
+            out.events.push_back(event);
+        }
+    }
+}
+
+void SimulationEngine::arriveCar(int i, int floor, CarOutbox& out) {
+    // Book the run that ends here, then brake and level before the doors
+    // open (an extra tick after the first)
+    const FleetState& fleet = building_.getFleet();
+    const MotionProfile& motion = building_.getMotion();
+    int run = fleet.runFloors[i];
+    TripEnergy energy = motion.tripEnergy(run, fleet.direction[i], fleet.passengers[i],
+                                          fleet.capacity[i]);
+    out.energy.drawn += energy.drawn;
+    out.energy.regenerated += energy.regenerated;
+    ++out.trips;
+    
+    Elevator& elev = building_.getElevator(i);
+    elev.arriveAtFloor(floor, 1 + motion.brakeTicks(run));
+    
+    Event event;
+    event.type = EventType::ElevatorArrived;
+    event.elevatorId = i;
+    event.floor = floor;
+    out.events.push_back(event);
+    
+    logger_.logElevatorState(elev);
+}
+
+void SimulationEngine::flushOutbox(CarOutbox& out) {
+    if (out.floorsTraveled > 0) {
+        building_.recordFloorTraveled(out.floorsTraveled);
+        out.floorsTraveled = 0;
+    }
+    if (out.trips > 0) {
+        building_.recordTrips(out.trips, out.energy);
+        out.trips = 0;
+        out.energy = TripEnergy();
+    }
+    int tick = currentTick_.load();
+    for (Event& event : out.events) {
+        event.tick = tick;
     }
+    eventQueue_.pushBatch(out.events.begin(), out.events.end());
+    out.events.clear();
 }
 
 // ============== CLI Implementation ==============
 
+namespace {
+constexpr size_t kStreamBlock = 64 * 1024;  // Bytes per read() in stream mode
+constexpr size_t kMaxBatch = 4096;          // Calls per requestBatch
+}
+
 CLI::CLI(SimulationEngine& engine) : engine_(engine) {}
 
 void CLI::run() {
     printHelp();
     
+    // Piped input: no one is typing, so read it at full speed
+    if (!isatty(STDIN_FILENO)) {
+        runStream(STDIN_FILENO);
+        return;
+    }
+    
     std::string line;
     while (running_.load() && std::getline(std::cin, line)) {
         if (line.empty()) continue;
@@ -401,6 +909,61 @@ void CLI::run() {
     }
 }
 
+size_t CLI::runScript(const std::string& path) {
+    if (path == "-") {
+        return runStream(STDIN_FILENO);
+    }
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open script: " + path);
+    }
+    size_t lines = runStream(fd);
+    ::close(fd);
+    return lines;
+}
+
+size_t CLI::runStream(int fd) {
+    std::vector<char> buffer(kStreamBlock);
+    size_t filled = 0;
+    size_t lines = 0;
+    
+    while (running_.load()) {
+        if (filled == buffer.size()) {
+            buffer.resize(buffer.size() * 2);  // One line longer than a block
+        }
+        ssize_t got = ::read(fd, buffer.data() + filled, buffer.size() - filled);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        bool eof = got <= 0;
+        size_t scanFrom = filled;
+        filled += eof ? 0 : static_cast<size_t>(got);
+        
+        size_t begin = 0;
+        for (size_t i = scanFrom; i < filled && running_.load(); ++i) {
+            if (buffer[i] == '\n') {
+                feedLine(std::string_view(buffer.data() + begin, i - begin));
+                ++lines;
+                begin = i + 1;
+            }
+        }
+        if (eof) {
+            if (begin < filled && running_.load()) {
+                feedLine(std::string_view(buffer.data() + begin, filled - begin));
+                ++lines;
+            }
+            break;
+        }
+        
+        // Submit what this read delivered before blocking on the next one
+        flushBatch();
+        std::copy(buffer.begin() + begin, buffer.begin() + filled, buffer.begin());
+        filled -= begin;
+    }
+    flushBatch();
+    return lines;
+}
+
 void CLI::stop() {
     running_.store(false);
 }
@@ -410,76 +973,71 @@ void CLI::printHelp() {
               << "Commands:\n"
               << "  hall <floor> <u|d>  - Hall call (e.g., 'hall 5 u')\n"
               << "  car <elev> <floor>  - Car call (e.g., 'car 0 8')\n"
+              << "  pass <from> <to>    - Passenger from floor to floor (e.g., 'pass 1 7')\n"
+              << "  dest <from> <to>    - Destination keypad call (e.g., 'dest 1 7')\n"
               << "  status              - Print current status\n"
+              << "  stats               - Tick phase timings, queue depth, lock contention\n"
+              << "  metrics             - The same counters in Prometheus text format\n"
               << "  help                - Show this help\n"
               << "  quit                - Exit simulation\n"
               << "\n";
 }
 
-void CLI::processCommand(const std::string& line) {
-    std::istringstream iss(line);
-    std::string cmd;
-    iss >> cmd;
-    
-    if (cmd == "hall") {
-        std::string args;
-        std::getline(iss, args);
-        if (!parseHallCall(args)) {
-            std::cout << "Usage: hall <floor> <u|d>\n";
-        }
+void CLI::processCommand(std::string_view line) {
+    Command command = parseCommand(line);
+    if (command.kind == CommandKind::Request) {
+        engine_.request(command.request);
+        return;
     }
-    else if (cmd == "car") {
-        std::string args;
-        std::getline(iss, args);
-        if (!parseCarCall(args)) {
-            std::cout << "Usage: car <elevator_id> <floor>\n";
+    execute(command);
+}
+
+void CLI::feedLine(std::string_view line) {
+    Command command = parseCommand(line);
+    if (command.kind == CommandKind::Request) {
+        batch_.push_back(command.request);
+        if (batch_.size() >= kMaxBatch) {
+            flushBatch();
         }
+        return;
     }
-    else if (cmd == "status") {
-        engine_.printStatus();
-    }
-    else if (cmd == "help") {
-        printHelp();
-    }
-    else if (cmd == "quit" || cmd == "exit" || cmd == "q") {
-        engine_.stop();
-        running_.store(false);
-    }
-    else {
-        std::cout << "Unknown command: " << cmd << ". Type 'help' for usage.\n";
-    }
+    // Anything else acts only after the calls typed before it are queued
+    flushBatch();
+    execute(command);
 }
 
-bool CLI::parseHallCall(const std::string& args) {
-    std::istringstream iss(args);
-    int floor;
-    char dirChar;
-    
-    if (!(iss >> floor >> dirChar)) {
-        return false;
-    }
-    
-    Direction dir;
-    if (dirChar == 'u' || dirChar == 'U') {
-        dir = Direction::Up;
-    } else if (dirChar == 'd' || dirChar == 'D') {
-        dir = Direction::Down;
-    } else {
-        return false;
-    }
-    
-    engine_.requestHallCall(floor, dir);
-    return true;
+void CLI::flushBatch() {
+    if (batch_.empty()) return;
+    engine_.requestBatch(batch_);
+    batch_.clear();
 }
 
-bool CLI::parseCarCall(const std::string& args) {
-    std::istringstream iss(args);
-    int elevatorId, floor;
-    
-    if (!(iss >> elevatorId >> floor)) {
-        return false;
+void CLI::execute(const Command& command) {
+    switch (command.kind) {
+        case CommandKind::Empty:
+        case CommandKind::Request:
+            break;
+        case CommandKind::Status:
+            engine_.printStatus();
+            break;
+        case CommandKind::Stats:
+            engine_.printStats();
+            break;
+        case CommandKind::Metrics:
+            engine_.writeMetrics(std::cout);
+            break;
+        case CommandKind::Help:
+            printHelp();
+            break;
+        case CommandKind::Quit:
+            engine_.stop();
+            running_.store(false);
+            break;
+        case CommandKind::BadArgs:
+            std::cout << "Usage: " << command.usage << "\n";
+            break;
+        case CommandKind::Unknown:
+            std::cout << "Unknown command: " << command.word << ". Type 'help' for usage.\n";
+            break;
     }
-    
-    engine_.requestCarCall(elevatorId, floor);
-    return true;
 }
@@ -0,0 +1,163 @@
+#include "Snapshot.hpp"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+// ============== Snapshot Implementation ==============
+
+SnapshotWriter::SnapshotWriter() {
+    bytes_.reserve(4096);
+    for (char c : kSnapshotMagic) {
+        bytes_.push_back(static_cast<std::uint8_t>(c));
+    }
+    putInt(static_cast<int>(kSnapshotVersion));
+}
+
+void SnapshotWriter::putInt(int value) {
+    auto bits = static_cast<std::uint32_t>(value);
+    for (int shift = 0; shift < 32; shift += 8) {
+        bytes_.push_back(static_cast<std::uint8_t>(bits >> shift));
+    }
+}
+
+void SnapshotWriter::putU64(std::uint64_t value) {
+    for (int shift = 0; shift < 64; shift += 8) {
+        bytes_.push_back(static_cast<std::uint8_t>(value >> shift));
+    }
+}
+
+void SnapshotWriter::putMask(const FloorMask& mask) {
+    for (std::uint64_t word : mask.words()) {
+        putU64(word);
+    }
+}
+
+SnapshotReader::SnapshotReader(const std::vector<std::uint8_t>& bytes) : bytes_(bytes) {
+    if (bytes.size() < sizeof(kSnapshotMagic) ||
+        std::memcmp(bytes.data(), kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) {
+        throw std::runtime_error("Not a simulation snapshot");
+    }
+    pos_ = sizeof(kSnapshotMagic);
+    if (static_cast<std::uint32_t>(getInt()) != kSnapshotVersion) {
+        throw std::runtime_error("Unsupported snapshot version");
+    }
+}
+
+int SnapshotReader::getInt() {
+    if (bytes_.size() - pos_ < 4) {
+        throw std::runtime_error("Truncated snapshot");
+    }
+    std::uint32_t bits = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        bits |= static_cast<std::uint32_t>(bytes_[pos_++]) << shift;
+    }
+    return static_cast<int>(bits);
+}
+
+int SnapshotReader::getInt(int lo, int hi) {
+    int value = getInt();
+    if (value < lo || value > hi) {
+        throw std::runtime_error("Corrupt snapshot: value " + std::to_string(value) +
+                                 " outside " + std::to_string(lo) + ".." + std::to_string(hi));
+    }
+    return value;
+}
+
+std::uint64_t SnapshotReader::getU64() {
+    if (bytes_.size() - pos_ < 8) {
+        throw std::runtime_error("Truncated snapshot");
+    }
+    std::uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 8) {
+        value |= static_cast<std::uint64_t>(bytes_[pos_++]) << shift;
+    }
+    return value;
+}
+
+FloorMask SnapshotReader::getMask(int maxFloor) {
+    FloorMask mask;
+    for (std::uint64_t& word : mask.words()) {
+        word = getU64();
+    }
+    if (mask.test(0) || mask.highest() > maxFloor) {
+        throw std::runtime_error("Corrupt snapshot: floor mask out of range");
+    }
+    return mask;
+}
+
+void writeConfig(SnapshotWriter& out, const Config& config) {
+    out.putInt(config.numFloors);
+    out.putInt(config.numElevators);
+    out.putInt(config.carCapacity);
+    out.putInt(config.tickDurationMs);
+    out.putInt(config.doorOpenTicks);
+    out.putInt(config.floorTravelTicks);
+    out.putEnum(config.controllerType);
+    out.putEnum(config.dispatchPolicy);
+    out.putEnum(config.costModel);
+    out.putInt(config.reassignPeriod);
+    out.putInt(config.reassignMinGain);
+    out.putInt(config.destinationZoneSize);
+    out.putInt(config.carWorkers);
+    out.putEnum(config.timeAdvance);
+    out.putEnum(config.motionModel);
+    out.putInt(config.headless ? 1 : 0);
+    out.putInt(config.loggingEnabled ? 1 : 0);
+}
+
+Config readConfig(SnapshotReader& in) {
+    Config config;
+    config.numFloors = in.getInt(1, kMaxFloors);
+    config.numElevators = in.getInt(1, kMaxElevators);
+    config.carCapacity = in.getInt(1, 1 << 20);
+    config.tickDurationMs = in.getInt();
+    config.doorOpenTicks = in.getInt();
+    config.floorTravelTicks = in.getInt();
+    config.controllerType = in.getEnum(ControllerType::Destination);
+    config.dispatchPolicy = in.getEnum(DispatchPolicy::Collective);
+    config.costModel = in.getEnum(CostModel::Eta);
+    config.reassignPeriod = in.getInt();
+    config.reassignMinGain = in.getInt();
+    config.destinationZoneSize = in.getInt();
+    config.carWorkers = in.getInt();
+    config.timeAdvance = in.getEnum(TimeAdvance::NextEvent);
+    config.motionModel = in.getEnum(MotionModel::Kinematic);
+    config.headless = in.getInt(0, 1) != 0;
+    config.loggingEnabled = in.getInt(0, 1) != 0;
+    return config;
+}
+
+Config SimulationSnapshot::getConfig() const {
+    SnapshotReader in(bytes);
+    return readConfig(in);
+}
+
+int SimulationSnapshot::getTick() const {
+    SnapshotReader in(bytes);
+    readConfig(in);
+    return in.getInt();
+}
+
+void SimulationSnapshot::writeFile(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot create snapshot file: " + path);
+    }
+    out.write(reinterpret_cast<const char*>(bytes.data()),
+              static_cast<std::streamsize>(bytes.size()));
+    if (!out) {
+        throw std::runtime_error("Failed writing snapshot file: " + path);
+    }
+}
+
+SimulationSnapshot SimulationSnapshot::readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open snapshot file: " + path);
+    }
+    SimulationSnapshot snapshot;
+    snapshot.bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    SnapshotReader check(snapshot.bytes);  // Validates the header
+    return snapshot;
+}
@@ -0,0 +1,330 @@
+#include "Sweep.hpp"
+#include "Simulation.hpp"
+#include "WorkerPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+// ============== Axis Parsing ==============
+
+namespace {
+
+int parseInt(const std::string& text, const std::string& whole) {
+    size_t used = 0;
+    int value = 0;
+    try {
+        value = std::stoi(text, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (text.empty() || used != text.size()) {
+        throw std::invalid_argument("Bad number list: '" + whole + "'");
+    }
+    return value;
+}
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream in(text);
+    for (std::string item; std::getline(in, item, ',');) {
+        items.push_back(item);
+    }
+    if (items.empty() || text.back() == ',') {
+        throw std::invalid_argument("Empty item in list: '" + text + "'");
+    }
+    return items;
+}
+
+}  // namespace
+
+std::vector<int> parseIntList(const std::string& text) {
+    std::vector<int> values;
+    for (const std::string& item : splitList(text)) {
+        size_t dash = item.find('-', 1);  // Not a leading minus sign
+        if (dash == std::string::npos) {
+            values.push_back(parseInt(item, text));
+            continue;
+        }
+        size_t colon = item.find(':', dash);
+        int lo = parseInt(item.substr(0, dash), text);
+        int hi = parseInt(item.substr(dash + 1, colon - dash - 1), text);
+        int step = colon == std::string::npos ? 1 : parseInt(item.substr(colon + 1), text);
+        if (hi < lo || step < 1) {
+            throw std::invalid_argument("Bad range '" + item + "' (want lo-hi or lo-hi:step)");
+        }
+        for (long long v = lo; v <= hi; v += step) {
+            values.push_back(static_cast<int>(v));
+        }
+    }
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    return values;
+}
+
+std::vector<ControllerType> parseControllerList(const std::string& text) {
+    std::vector<ControllerType> types;
+    for (const std::string& name : splitList(text)) {
+        ControllerType type;
+        if (name == "master") {
+            type = ControllerType::Master;
+        } else if (name == "distributed") {
+            type = ControllerType::Distributed;
+        } else if (name == "destination") {
+            type = ControllerType::Destination;
+        } else {
+            throw std::invalid_argument("Unknown controller '" + name +
+                                        "' (want master, distributed or destination)");
+        }
+        if (std::find(types.begin(), types.end(), type) == types.end()) {
+            types.push_back(type);
+        }
+    }
+    return types;
+}
+
+// ============== SweepPoint / SweepResult ==============
+
+int SweepPoint::waitAt(double p) const {
+    const HdrHistogram& waits = passengers.waitTicks;
+    double boarded = static_cast<double>(waits.count());
+    double total = boarded + static_cast<double>(unserved());
+    if (total == 0.0) {
+        return 0;
+    }
+    double rank = std::clamp(p, 0.0, 1.0) * total;
+    if (rank > boarded) {
+        return -1;
+    }
+    return waits.percentile(rank / boarded);
+}
+
+const SweepPoint* SweepResult::cheapestMeetingSla(const SweepConfig& config) const {
+    if (config.slaTicks <= 0) {
+        return nullptr;
+    }
+    for (const SweepPoint& point : points) {  // Ascending cost
+        int wait = point.waitAt(config.slaPercentile);
+        if (!point.cutOff && wait >= 0 && wait <= config.slaTicks) {
+            return &point;
+        }
+    }
+    return nullptr;
+}
+
+// ============== SweepRunner Implementation ==============
+
+namespace {
+
+// The axes with every empty one filled in from `base`
+struct Axes {
+    std::vector<int> cars, capacity, door, travel;
+    std::vector<ControllerType> controllers;
+};
+
+Axes resolveAxes(const SweepConfig& config) {
+    auto orBase = [](const std::vector<int>& values, int base) {
+        return values.empty() ? std::vector<int>{base} : values;
+    };
+    Axes axes;
+    axes.cars = orBase(config.numElevators, config.base.numElevators);
+    axes.capacity = orBase(config.carCapacity, config.base.carCapacity);
+    axes.door = orBase(config.doorOpenTicks, config.base.doorOpenTicks);
+    axes.travel = orBase(config.floorTravelTicks, config.base.floorTravelTicks);
+    axes.controllers = config.controllers.empty()
+        ? std::vector<ControllerType>{config.base.controllerType} : config.controllers;
+    std::sort(axes.cars.begin(), axes.cars.end());
+    return axes;
+}
+
+constexpr int kDrainSlice = 50;  // Ticks per check while draining a run
+
+// Points per task: a MinCars task covers the whole car axis
+size_t pointsPerTask(const SweepConfig& config, const Axes& axes) {
+    return config.search == SweepSearch::MinCars ? axes.cars.size() : 1;
+}
+
+// Task `task`'s point at car index `carIndex`
+SweepPoint pointOf(const SweepConfig& config, const Axes& axes, size_t task, size_t carIndex) {
+    size_t index = task * pointsPerTask(config, axes) + carIndex;
+    SweepPoint point;
+    point.numElevators = axes.cars[index % axes.cars.size()];
+    index /= axes.cars.size();
+    point.carCapacity = axes.capacity[index % axes.capacity.size()];
+    index /= axes.capacity.size();
+    point.doorOpenTicks = axes.door[index % axes.door.size()];
+    index /= axes.door.size();
+    point.floorTravelTicks = axes.travel[index % axes.travel.size()];
+    index /= axes.travel.size();
+    point.controller = axes.controllers[index];
+    point.cost = point.numElevators * (1.0 + config.seatCost * point.carCapacity);
+    return point;
+}
+
+}  // namespace
+
+SweepRunner::SweepRunner(const SweepConfig& config) : config_(config) {
+    if (config.runs < 1 || config.ticksPerRun < 1) {
+        throw std::invalid_argument("Sweep runs and ticks per run must be positive");
+    }
+    if (config.slaPercentile <= 0.0 || config.slaPercentile > 1.0) {
+        throw std::invalid_argument("SLA percentile must be in (0, 1]");
+    }
+    if (config.search == SweepSearch::MinCars && config.slaTicks <= 0) {
+        throw std::invalid_argument("A fewest-cars search needs a wait SLA");
+    }
+    auto check = [](const std::vector<int>& values, int lo, int hi, const std::string& what) {
+        for (int v : values) {
+            if (v < lo || v > hi) {
+                throw std::invalid_argument(what + " must be " + std::to_string(lo) + "-" +
+                                            std::to_string(hi));
+            }
+        }
+    };
+    Axes axes = resolveAxes(config);
+    check(axes.cars, 1, kMaxElevators, "Elevator count");
+    check(axes.capacity, 1, 10, "Car capacity");
+    check(axes.door, 0, 1000, "Door open ticks");
+    check(axes.travel, 1, 1000, "Floor travel ticks");
+    if (config.base.numFloors < 1 || config.base.numFloors > kMaxFloors) {
+        throw std::invalid_argument("Floor count must be 1-" + std::to_string(kMaxFloors));
+    }
+    config_.base.headless = true;
+    config_.base.loggingEnabled = false;
+    config_.base.sharedStateName.clear();
+    config_.base.profiling = false;
+}
+
+int SweepRunner::getTaskCount() const {
+    Axes axes = resolveAxes(config_);
+    size_t points = axes.cars.size() * axes.capacity.size() * axes.door.size() *
+                    axes.travel.size() * axes.controllers.size();
+    return static_cast<int>(points / pointsPerTask(config_, axes));
+}
+
+int SweepRunner::getThreadCount() const {
+    int threads = config_.threads;
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    return std::clamp(threads, 1, getTaskCount());
+}
+
+bool SweepRunner::meetsSla(const SweepPoint& point) const {
+    int wait = point.waitAt(config_.slaPercentile);
+    return !point.cutOff && wait >= 0 && (config_.slaTicks <= 0 || wait <= config_.slaTicks);
+}
+
+SweepResult SweepRunner::run() const {
+    const Axes axes = resolveAxes(config_);
+    const int tasks = getTaskCount();
+    const bool screening = config_.slaTicks > 0 && config_.screenRuns < config_.runs;
+    const double cutoffWait = config_.cutoffFactor * config_.slaTicks;
+
+    // One point, run by run; stops after screenRuns if clearly failing
+    auto evaluate = [&](SweepPoint& point, long long& ticks) {
+        Config config = config_.base;
+        config.numElevators = point.numElevators;
+        config.carCapacity = point.carCapacity;
+        config.doorOpenTicks = point.doorOpenTicks;
+        config.floorTravelTicks = point.floorTravelTicks;
+        config.controllerType = point.controller;
+
+        for (int run = 0; run < config_.runs; ++run) {
+            TrafficConfig traffic = config_.traffic;
+            traffic.seed = config_.traffic.seed + static_cast<std::uint32_t>(run);
+            SimulationEngine engine(config);
+            TrafficGenerator generator(traffic, config.numFloors);
+            ticks += generator.drive(engine, config_.ticksPerRun).ticks;
+            
+            // No more arrivals: let the passengers still waiting board, so
+            // only those the fleet cannot reach count as never picked up
+            const PassengerMetrics& metrics = engine.getPassengerMetrics();
+            for (int drained = 0; metrics.waiting.load() > 0 && drained < config_.ticksPerRun;
+                 drained += kDrainSlice) {
+                ticks += engine.runTicks(kDrainSlice).ticks;
+            }
+            point.passengers.merge(metrics);
+            point.floorsTraveled += engine.getBuilding().getMetrics().floorsTraveled;
+            point.runs = run + 1;
+            
+            if (screening && point.runs == config_.screenRuns) {
+                int wait = point.waitAt(config_.slaPercentile);
+                if (wait < 0 || wait > cutoffWait) {
+                    point.cutOff = true;
+                    break;
+                }
+            }
+        }
+    };
+
+    // A task's points, in the order evaluated
+    auto runTask = [&](int task, std::vector<SweepPoint>& out, long long& ticks) {
+        if (config_.search == SweepSearch::Grid) {
+            out.push_back(pointOf(config_, axes, task, 0));
+            evaluate(out.back(), ticks);
+            return;
+        }
+        // Fewest cars meeting the SLA: bisect [lo, hi); hi = none found
+        size_t lo = 0;
+        size_t hi = axes.cars.size();
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            out.push_back(pointOf(config_, axes, task, mid));
+            evaluate(out.back(), ticks);
+            if (meetsSla(out.back())) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+    };
+
+    // A task's points and ticks, written only by the thread running it
+    struct TaskResult {
+        std::vector<SweepPoint> points;
+        long long ticks = 0;
+    };
+    std::vector<TaskResult> perTask(tasks);
+
+    auto begin = std::chrono::steady_clock::now();
+    WorkerPool pool(getThreadCount() - 1);  // The caller runs tasks too
+    pool.run(tasks, [&](int task) { runTask(task, perTask[task].points, perTask[task].ticks); });
+
+    SweepResult result;
+    for (TaskResult& task : perTask) {
+        for (SweepPoint& point : task.points) {
+            result.runs += point.runs;
+            result.cutOff += point.cutOff ? 1 : 0;
+            result.points.push_back(std::move(point));
+        }
+        result.ticks += task.ticks;
+    }
+
+    // Ascending cost, then wait; unbounded waits sort last
+    auto waitKey = [this](const SweepPoint& point) {
+        int wait = point.waitAt(config_.slaPercentile);
+        return wait < 0 ? std::numeric_limits<int>::max() : wait;
+    };
+    std::stable_sort(result.points.begin(), result.points.end(),
+                     [&](const SweepPoint& a, const SweepPoint& b) {
+                         return a.cost != b.cost ? a.cost < b.cost : waitKey(a) < waitKey(b);
+                     });
+
+    // Pareto front over the fully run points: in cost order, keep each
+    // point that waits strictly less than every cheaper one
+    int bestWait = std::numeric_limits<int>::max();
+    for (SweepPoint& point : result.points) {
+        int wait = waitKey(point);
+        if (!point.cutOff && wait < bestWait) {
+            point.pareto = true;
+            bestWait = wait;
+        }
+    }
+
+    result.elapsedSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - begin).count();
+    return result;
+}
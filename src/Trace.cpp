@@ -0,0 +1,156 @@
+#include "Trace.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::size_t kWriteBatch = 4096;  // Records buffered per write
+
+}  // namespace
+
+// ============== TraceRecord Implementation ==============
+
+TraceRecord TraceRecord::fromEvent(int tick, const Event& event) {
+    TraceRecord rec{};
+    rec.tick = static_cast<std::uint32_t>(tick);
+    rec.type = static_cast<std::uint8_t>(event.type);
+    rec.direction = static_cast<std::uint8_t>(event.direction);
+    rec.floor = static_cast<std::int16_t>(event.floor);
+    rec.elevatorId = static_cast<std::int16_t>(event.elevatorId);
+    rec.destination = static_cast<std::int16_t>(event.destination);
+    return rec;
+}
+
+Event TraceRecord::toEvent() const {
+    Event event;
+    event.type = static_cast<EventType>(type);
+    event.direction = static_cast<Direction>(direction);
+    event.floor = floor;
+    event.elevatorId = elevatorId;
+    event.destination = destination;
+    event.tick = static_cast<std::int32_t>(tick);
+    return event;
+}
+
+// ============== TraceWriter Implementation ==============
+
+TraceWriter::TraceWriter(const std::string& path, const Config& config)
+    : out_(path, std::ios::binary | std::ios::trunc) {
+    if (!out_) {
+        throw std::runtime_error("Cannot create trace file: " + path);
+    }
+    
+    std::memcpy(header_.magic, kTraceMagic, sizeof(kTraceMagic));
+    header_.version = kTraceVersion;
+    header_.recordSize = sizeof(TraceRecord);
+    header_.numFloors = static_cast<std::uint16_t>(config.numFloors);
+    header_.numElevators = static_cast<std::uint16_t>(config.numElevators);
+    
+    out_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+    buffer_.reserve(kWriteBatch);
+    open_ = true;
+}
+
+TraceWriter::~TraceWriter() {
+    close();
+}
+
+void TraceWriter::record(int tick, const Event& event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!open_) return;
+    
+    buffer_.push_back(TraceRecord::fromEvent(tick, event));
+    ++header_.recordCount;
+    if (buffer_.size() >= kWriteBatch) {
+        flushLocked();
+    }
+}
+
+void TraceWriter::record(int tick, const Event* events, std::size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!open_) return;
+    
+    for (std::size_t i = 0; i < count; ++i) {
+        buffer_.push_back(TraceRecord::fromEvent(tick, events[i]));
+    }
+    header_.recordCount += count;
+    if (buffer_.size() >= kWriteBatch) {
+        flushLocked();
+    }
+}
+
+void TraceWriter::flushLocked() {
+    if (buffer_.empty()) return;
+    out_.write(reinterpret_cast<const char*>(buffer_.data()),
+               static_cast<std::streamsize>(buffer_.size() * sizeof(TraceRecord)));
+    buffer_.clear();
+}
+
+void TraceWriter::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!open_) return;
+    
+    flushLocked();
+    
+    // Patch the final record count into the header
+    out_.seekp(0);
+    out_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+    out_.close();
+    open_ = false;
+}
+
+std::uint64_t TraceWriter::getRecordCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return header_.recordCount;
+}
+
+// ============== TraceReader Implementation ==============
+
+TraceReader::TraceReader(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open trace file: " + path);
+    }
+    
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(TraceHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Trace file too small: " + path);
+    }
+    
+    mappedSize_ = static_cast<std::size_t>(st.st_size);
+    void* mapping = ::mmap(nullptr, mappedSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Cannot map trace file: " + path);
+    }
+    mapping_ = mapping;
+    
+    header_ = static_cast<const TraceHeader*>(mapping_);
+    std::size_t available = (mappedSize_ - sizeof(TraceHeader)) / sizeof(TraceRecord);
+    
+    if (std::memcmp(header_->magic, kTraceMagic, sizeof(kTraceMagic)) != 0 ||
+        header_->version != kTraceVersion ||
+        header_->recordSize != sizeof(TraceRecord) ||
+        header_->recordCount > available) {
+        ::munmap(const_cast<void*>(mapping_), mappedSize_);
+        throw std::runtime_error("Invalid trace file: " + path);
+    }
+    
+    records_ = reinterpret_cast<const TraceRecord*>(
+        static_cast<const char*>(mapping_) + sizeof(TraceHeader));
+    count_ = static_cast<std::size_t>(header_->recordCount);
+    
+    // Accessed front to back exactly once during replay
+    ::madvise(const_cast<void*>(mapping_), mappedSize_, MADV_SEQUENTIAL);
+}
+
+TraceReader::~TraceReader() {
+    if (mapping_) {
+        ::munmap(const_cast<void*>(mapping_), mappedSize_);
+    }
+}
@@ -0,0 +1,200 @@
+#include "Traffic.hpp"
+#include "Simulation.hpp"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+// ============== Traffic Profiles ==============
+
+TrafficMix trafficMix(TrafficProfile profile) {
+    switch (profile) {
+        case TrafficProfile::UpPeak: return {0.85, 0.10, 0.05};
+        case TrafficProfile::DownPeak: return {0.05, 0.85, 0.10};
+        case TrafficProfile::Lunch: return {0.45, 0.45, 0.10};
+        case TrafficProfile::Uniform:
+        case TrafficProfile::Interfloor: break;
+    }
+    return {0.0, 0.0, 1.0};
+}
+
+std::string trafficProfileToString(TrafficProfile profile) {
+    switch (profile) {
+        case TrafficProfile::Uniform: return "uniform";
+        case TrafficProfile::UpPeak: return "up-peak";
+        case TrafficProfile::DownPeak: return "down-peak";
+        case TrafficProfile::Lunch: return "lunch";
+        case TrafficProfile::Interfloor: return "interfloor";
+    }
+    return "unknown";
+}
+
+TrafficProfile parseTrafficProfile(const std::string& name) {
+    for (TrafficProfile profile : {TrafficProfile::Uniform, TrafficProfile::UpPeak,
+                                   TrafficProfile::DownPeak, TrafficProfile::Lunch,
+                                   TrafficProfile::Interfloor}) {
+        if (name == trafficProfileToString(profile)) {
+            return profile;
+        }
+    }
+    throw std::invalid_argument("Unknown traffic profile: " + name);
+}
+
+// ============== TrafficGenerator Implementation ==============
+
+TrafficGenerator::TrafficGenerator(const TrafficConfig& config, int numFloors)
+    : config_(config), numFloors_(numFloors), gen_(config.seed),
+      mix_(trafficMix(config.profile)) {
+    if (config.callsPerTick < 0.0) {
+        throw std::invalid_argument("Call rate must not be negative");
+    }
+    if (config.lobbyFloor < 1 || config.lobbyFloor > numFloors) {
+        throw std::invalid_argument("Lobby floor " + std::to_string(config.lobbyFloor) +
+                                    " is outside 1.." + std::to_string(numFloors));
+    }
+
+    double peakScale = config.rateCurve.empty() ? 1.0 : 0.0;
+    for (size_t i = 0; i < config.rateCurve.size(); ++i) {
+        const RatePoint& point = config.rateCurve[i];
+        if (point.scale < 0.0) {
+            throw std::invalid_argument("Rate scale must not be negative");
+        }
+        if (i > 0 && point.tick <= config.rateCurve[i - 1].tick) {
+            throw std::invalid_argument("Rate curve ticks must be ascending");
+        }
+        peakScale = std::max(peakScale, point.scale);
+    }
+
+    // A one-floor building has no trips to make
+    peakRate_ = numFloors > 1 ? config.callsPerTick * peakScale : 0.0;
+    if (peakRate_ > 0.0) {
+        gap_ = std::exponential_distribution<double>(peakRate_);
+    }
+    nextTime_ = 0.0;
+    advance();
+}
+
+void TrafficGenerator::advance() {
+    nextTime_ = peakRate_ > 0.0 ? nextTime_ + gap_(gen_)
+                                : std::numeric_limits<double>::infinity();
+}
+
+double TrafficGenerator::rateAt(double tick) const {
+    const std::vector<RatePoint>& curve = config_.rateCurve;
+    if (curve.empty()) {
+        return config_.callsPerTick;
+    }
+    if (tick <= curve.front().tick) {
+        return config_.callsPerTick * curve.front().scale;
+    }
+    if (tick >= curve.back().tick) {
+        return config_.callsPerTick * curve.back().scale;
+    }
+    auto after = std::upper_bound(curve.begin(), curve.end(), tick,
+                                  [](double t, const RatePoint& p) { return t < p.tick; });
+    const RatePoint& hi = *after;
+    const RatePoint& lo = *(after - 1);
+    double f = (tick - lo.tick) / static_cast<double>(hi.tick - lo.tick);
+    return config_.callsPerTick * (lo.scale + f * (hi.scale - lo.scale));
+}
+
+void TrafficGenerator::skipTo(int tick) {
+    if (nextTime_ < tick) {
+        nextTime_ = tick;
+        advance();
+    }
+}
+
+int TrafficGenerator::nextArrivalTick() const {
+    if (!(nextTime_ < static_cast<double>(INT_MAX))) {
+        return INT_MAX;
+    }
+    return static_cast<int>(nextTime_);
+}
+
+int TrafficGenerator::drawFloor() {
+    return std::uniform_int_distribution<int>(1, numFloors_)(gen_);
+}
+
+int TrafficGenerator::drawUpperFloor() {
+    int floor = std::uniform_int_distribution<int>(1, numFloors_ - 1)(gen_);
+    return floor >= config_.lobbyFloor ? floor + 1 : floor;
+}
+
+Request TrafficGenerator::makeRequest(int origin, int destination) const {
+    switch (config_.emit) {
+        case TrafficEmit::HallCalls:
+            return Request::hallCall(origin, destination > origin ? Direction::Up
+                                                                  : Direction::Down);
+        case TrafficEmit::DestinationCalls:
+            return Request::destinationCall(origin, destination);
+        case TrafficEmit::Passengers:
+            break;
+    }
+    return Request::passenger(origin, destination);
+}
+
+size_t TrafficGenerator::generate(int tick, std::vector<Request>& out) {
+    const double limit = static_cast<double>(tick) + 1.0;
+    const bool thinning = !config_.rateCurve.empty();
+    const int lobby = config_.lobbyFloor;
+    size_t appended = 0;
+
+    while (nextTime_ < limit) {
+        double at = nextTime_;
+        advance();
+        if (thinning && unit_(gen_) * peakRate_ >= rateAt(at)) {
+            continue;
+        }
+
+        int origin;
+        int destination;
+        double kind = config_.profile == TrafficProfile::Uniform ? 2.0 : unit_(gen_);
+        if (kind < mix_.incoming) {
+            origin = lobby;
+            destination = drawUpperFloor();
+        } else if (kind < mix_.incoming + mix_.outgoing) {
+            origin = drawUpperFloor();
+            destination = lobby;
+        } else if (kind <= 1.0 && numFloors_ > 2) {
+            // Two distinct floors, neither of them the lobby
+            origin = drawUpperFloor();
+            int low = std::min(origin, lobby);
+            int high = std::max(origin, lobby);
+            destination = std::uniform_int_distribution<int>(1, numFloors_ - 2)(gen_);
+            destination += destination >= low ? 1 : 0;
+            destination += destination >= high ? 1 : 0;
+        } else {
+            origin = drawFloor();
+            destination = std::uniform_int_distribution<int>(1, numFloors_ - 1)(gen_);
+            destination += destination >= origin ? 1 : 0;
+        }
+
+        out.push_back(makeRequest(origin, destination));
+        ++appended;
+    }
+    generated_ += static_cast<long long>(appended);
+    return appended;
+}
+
+RunStats TrafficGenerator::drive(SimulationEngine& engine, int ticks) {
+    RunStats stats;
+    skipTo(engine.getCurrentTick());
+    const int end = engine.getCurrentTick() + std::max(ticks, 0);
+    while (engine.getCurrentTick() < end) {
+        const int now = engine.getCurrentTick();
+        batch_.clear();
+        if (generate(now, batch_) > 0) {
+            engine.requestBatch(batch_);
+        }
+
+        // Nothing arrives before nextArrivalTick(): run up to it at once
+        const long long gap = static_cast<long long>(nextArrivalTick()) - now;
+        RunStats part = engine.runTicks(static_cast<int>(std::clamp<long long>(gap, 1, end - now)));
+        stats.ticks += part.ticks;
+        stats.eventsProcessed += part.eventsProcessed;
+        stats.elapsedSeconds += part.elapsedSeconds;
+    }
+    return stats;
+}
@@ -0,0 +1,73 @@
+#include "WorkerPool.hpp"
+
+// ============== WorkerPool Implementation ==============
+
+WorkerPool::WorkerPool(int workers) {
+    threads_.reserve(workers > 0 ? workers : 0);
+    for (int i = 0; i < workers; ++i) {
+        threads_.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : threads_) {
+        t.join();
+    }
+}
+
+void WorkerPool::drainJob() {
+    for (int i = next_.fetch_add(1); i < count_; i = next_.fetch_add(1)) {
+        (*job_)(i);
+    }
+}
+
+void WorkerPool::workerLoop() {
+    std::uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = generation_;
+        }
+
+        drainJob();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--busy_ == 0) {
+            done_.notify_one();
+        }
+    }
+}
+
+void WorkerPool::run(int count, const std::function<void(int)>& job) {
+    if (threads_.empty() || count <= 1) {
+        for (int i = 0; i < count; ++i) {
+            job(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &job;
+        count_ = count;
+        next_.store(0);
+        busy_ = static_cast<int>(threads_.size());
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    drainJob();
+
+    // Barrier: every worker has left the job before it goes out of scope
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [&] { return busy_ == 0; });
+}
@@ -1,21 +1,100 @@
 #include "Simulation.hpp"
+#include "BatchRunner.hpp"
+#include "Sweep.hpp"
+#include "Campus.hpp"
 #include <iostream>
 #include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
 
 void printUsage(const char* progName) {
     std::cout << "Usage: " << progName << " [options]\n"
               << "\nOptions:\n"
-              << "  -f, --floors <n>      Number of floors (1-12, default: 10)\n"
-              << "  -e, --elevators <n>   Number of elevators (1-3, default: 3)\n"
+              << "  -f, --floors <n>      Number of floors (1-" << kMaxFloors << ", default: 10)\n"
+              << "  -e, --elevators <n>   Number of elevators (1-" << kMaxElevators << ", default: 3)\n"
               << "  -c, --capacity <n>    Car capacity (1-10, default: 6)\n"
-              << "  -m, --mode <type>     Controller mode: master|distributed (default: master)\n"
+              << "  -m, --mode <type>     Controller mode: master|distributed|destination\n"
+              << "                        (default: master)\n"
+              << "  -d, --dispatch <p>    Dispatch policy: nearest|collective (default: nearest)\n"
+              << "  --cost <model>        Hall-call cost: distance|eta (default: distance)\n"
+              << "  --reassign <k>        Master: re-optimise hall-call assignments every k ticks\n"
+              << "  --car-workers <n>     Distributed: run per-car logic on n threads\n"
               << "  -t, --tick <ms>       Tick duration in ms (100-2000, default: 500)\n"
+              << "  --motion <model>      Car motion: fixed|kinematic (jerk-limited runs timed\n"
+              << "                        in tick-duration steps, energy per trip; default: fixed)\n"
+              << "  -H, --headless <n>    Run n ticks in virtual time (no sleep), report and exit\n"
+              << "  --next-event          Headless/replay: jump over ticks in which nothing happens\n"
+              << "  -q, --quiet           Disable event logging\n"
+              << "  --profile             Time each tick phase (see the 'stats' command)\n"
+              << "  --metrics-out <file>  Write profiling counters in Prometheus text format\n"
+              << "                        when the run ends\n"
+              << "  -l, --log-file <file> Write binary log records to file instead of text\n"
+              << "  --shm <name>          Publish fleet and hall-call state every tick to the\n"
+              << "                        POSIX shared-memory object /name (single runs)\n"
+              << "  --decode-log <file>   Print a binary log file as text and exit\n"
+              << "  -r, --record <file>   Record hall/car calls to a binary trace\n"
+              << "  -p, --replay <file>   Replay a trace in virtual time (-H n: extra ticks after)\n"
+              << "  -s, --script <file>   Read CLI commands from file ('-' = stdin) in batches;\n"
+              << "                        with -H they are queued before the run\n"
+              << "  --save-state <file>   Write a snapshot of the final state to file\n"
+              << "  --load-state <file>   Start from a snapshot (its floors, cars, capacity and\n"
+              << "                        controller); with -B every run forks from it\n"
+              << "  -B, --batch <runs>    Monte-Carlo compare the controllers over n seeded runs\n"
+              << "                        (-H n: ticks per run, default 2000)\n"
+              << "  --sweep <runs>        Fleet sizing: n seeded runs per point over the --sweep-*\n"
+              << "                        axes, then a Pareto table of fleet cost against wait\n"
+              << "                        (-H n: ticks per run, default 2000)\n"
+              << "  --sweep-cars <list>   Car counts to try, e.g. 2-8, 2-12:2 or 3,4,6\n"
+              << "  --sweep-capacity <list>, --sweep-door <list>, --sweep-travel <list>\n"
+              << "                        Car capacities, door-open ticks, ticks per floor\n"
+              << "  --sweep-modes <list>  Controllers, e.g. master,destination\n"
+              << "  --sla <ticks>         Sweep: wait SLA; points far over it after a few runs\n"
+              << "                        are cut off early\n"
+              << "  --sla-percentile <p>  Percentile the SLA applies to (default: 0.95)\n"
+              << "  --min-cars            Sweep: bisect for the fewest cars meeting the SLA\n"
+              << "                        instead of running every car count\n"
+              << "  --traffic <profile>   Generated load: uniform|up-peak|down-peak|lunch|\n"
+              << "                        interfloor (batch, or with -H alone; default: uniform)\n"
+              << "  --load <rate>         Passenger arrivals per tick (default: 0.2); like\n"
+              << "                        --traffic and --seed, makes -H generate traffic\n"
+              << "  --seed <n>            Batch/traffic base seed (default: 1)\n"
+              << "  --campus <n>          Run n copies of the building as campus shards in\n"
+              << "                        lockstep (-H n: ticks, default 2000; --load per shard)\n"
+              << "  --transfer <share>    Campus: share of trips that end in another shard,\n"
+              << "                        changing at floor 1 (default: 0.1)\n"
+              << "  --threads <n>         Batch/sweep/campus worker threads (default: all cores)\n"
               << "  -h, --help            Show this help\n"
               << "\nExample:\n"
               << "  " << progName << " -f 12 -e 3 -m distributed\n";
 }
 
-bool parseArgs(int argc, char* argv[], Config& config) {
+// Command-line options beyond the simulation Config
+struct Options {
+    Config config;
+    int headlessTicks = 0;
+    std::string recordPath;   // Trace file to record requests into
+    std::string replayPath;   // Trace file to replay (headless)
+    std::string scriptPath;   // Command file to feed the CLI ("-" = stdin)
+    std::string decodePath;   // Binary log to print as text
+    std::string saveStatePath;  // Snapshot written when the run ends
+    std::string loadStatePath;  // Snapshot to start from
+    std::string metricsPath;    // Prometheus text written when the run ends
+    SimulationSnapshot warmStart;
+    int batchRuns = 0;        // Monte-Carlo batch mode when > 0
+    BatchConfig batch;
+    bool generateTraffic = false;  // Headless run fed by a TrafficGenerator
+    int sweepRuns = 0;        // Parameter sweep when > 0
+    SweepConfig sweep;
+    std::string sweepCars, sweepCapacity, sweepDoor, sweepTravel, sweepModes;  // Axis lists
+    int campusShards = 0;     // Campus mode when > 0
+    double transferShare = 0.1;
+};
+
+bool parseArgs(int argc, char* argv[], Options& options) {
+    Config& config = options.config;
+    int& headlessTicks = options.headlessTicks;
+    
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
         
@@ -25,15 +104,15 @@ bool parseArgs(int argc, char* argv[], Config& config) {
         }
         else if ((arg == "-f" || arg == "--floors") && i + 1 < argc) {
             config.numFloors = std::stoi(argv[++i]);
-            if (config.numFloors < 1 || config.numFloors > 12) {
-                std::cerr << "Error: floors must be 1-12\n";
+            if (config.numFloors < 1 || config.numFloors > kMaxFloors) {
+                std::cerr << "Error: floors must be 1-" << kMaxFloors << "\n";
                 return false;
             }
         }
         else if ((arg == "-e" || arg == "--elevators") && i + 1 < argc) {
             config.numElevators = std::stoi(argv[++i]);
-            if (config.numElevators < 1 || config.numElevators > 3) {
-                std::cerr << "Error: elevators must be 1-3\n";
+            if (config.numElevators < 1 || config.numElevators > kMaxElevators) {
+                std::cerr << "Error: elevators must be 1-" << kMaxElevators << "\n";
                 return false;
             }
         }
@@ -50,8 +129,60 @@ bool parseArgs(int argc, char* argv[], Config& config) {
                 config.controllerType = ControllerType::Master;
             } else if (mode == "distributed") {
                 config.controllerType = ControllerType::Distributed;
+            } else if (mode == "destination") {
+                config.controllerType = ControllerType::Destination;
             } else {
-                std::cerr << "Error: mode must be 'master' or 'distributed'\n";
+                std::cerr << "Error: mode must be 'master', 'distributed' or 'destination'\n";
+                return false;
+            }
+        }
+        else if ((arg == "-d" || arg == "--dispatch") && i + 1 < argc) {
+            std::string policy = argv[++i];
+            if (policy == "nearest") {
+                config.dispatchPolicy = DispatchPolicy::NearestFirst;
+            } else if (policy == "collective") {
+                config.dispatchPolicy = DispatchPolicy::Collective;
+            } else {
+                std::cerr << "Error: dispatch must be 'nearest' or 'collective'\n";
+                return false;
+            }
+        }
+        else if (arg == "--cost" && i + 1 < argc) {
+            std::string model = argv[++i];
+            if (model == "distance") {
+                config.costModel = CostModel::Distance;
+            } else if (model == "eta") {
+                config.costModel = CostModel::Eta;
+            } else {
+                std::cerr << "Error: cost must be 'distance' or 'eta'\n";
+                return false;
+            }
+        }
+        else if (arg == "--motion" && i + 1 < argc) {
+            std::string model = argv[++i];
+            if (model == "fixed") {
+                config.motionModel = MotionModel::Fixed;
+            } else if (model == "kinematic") {
+                config.motionModel = MotionModel::Kinematic;
+            } else {
+                std::cerr << "Error: motion must be 'fixed' or 'kinematic'\n";
+                return false;
+            }
+        }
+        else if (arg == "--reassign" && i + 1 < argc) {
+            config.reassignPeriod = std::stoi(argv[++i]);
+            if (config.reassignPeriod < 1) {
+                std::cerr << "Error: reassign period must be positive\n";
+                return false;
+            }
+        }
+        else if (arg == "--next-event") {
+            config.timeAdvance = TimeAdvance::NextEvent;
+        }
+        else if (arg == "--car-workers" && i + 1 < argc) {
+            config.carWorkers = std::stoi(argv[++i]);
+            if (config.carWorkers < 1) {
+                std::cerr << "Error: car workers must be positive\n";
                 return false;
             }
         }
@@ -62,6 +193,129 @@ bool parseArgs(int argc, char* argv[], Config& config) {
                 return false;
             }
         }
+        else if ((arg == "-H" || arg == "--headless") && i + 1 < argc) {
+            headlessTicks = std::stoi(argv[++i]);
+            if (headlessTicks < 1) {
+                std::cerr << "Error: headless tick count must be positive\n";
+                return false;
+            }
+            config.headless = true;
+        }
+        else if (arg == "-q" || arg == "--quiet") {
+            config.loggingEnabled = false;
+        }
+        else if (arg == "--profile") {
+            config.profiling = true;
+        }
+        else if (arg == "--metrics-out" && i + 1 < argc) {
+            options.metricsPath = argv[++i];
+        }
+        else if ((arg == "-l" || arg == "--log-file") && i + 1 < argc) {
+            config.logFile = argv[++i];
+        }
+        else if (arg == "--shm" && i + 1 < argc) {
+            config.sharedStateName = argv[++i];
+        }
+        else if (arg == "--decode-log" && i + 1 < argc) {
+            options.decodePath = argv[++i];
+        }
+        else if (arg == "--save-state" && i + 1 < argc) {
+            options.saveStatePath = argv[++i];
+        }
+        else if (arg == "--load-state" && i + 1 < argc) {
+            options.loadStatePath = argv[++i];
+        }
+        else if ((arg == "-B" || arg == "--batch") && i + 1 < argc) {
+            options.batchRuns = std::stoi(argv[++i]);
+            if (options.batchRuns < 1) {
+                std::cerr << "Error: batch run count must be positive\n";
+                return false;
+            }
+        }
+        else if (arg == "--traffic" && i + 1 < argc) {
+            try {
+                options.batch.traffic = parseTrafficProfile(argv[++i]);
+            } catch (const std::invalid_argument&) {
+                std::cerr << "Error: traffic must be 'uniform', 'up-peak', 'down-peak', "
+                             "'lunch' or 'interfloor'\n";
+                return false;
+            }
+            options.generateTraffic = true;
+        }
+        else if (arg == "--load" && i + 1 < argc) {
+            options.batch.callsPerTick = std::stod(argv[++i]);
+            if (options.batch.callsPerTick < 0.0) {
+                std::cerr << "Error: load must not be negative\n";
+                return false;
+            }
+            options.generateTraffic = true;  // Also feeds a plain -H run
+        }
+        else if (arg == "--sweep" && i + 1 < argc) {
+            options.sweepRuns = std::stoi(argv[++i]);
+            if (options.sweepRuns < 1) {
+                std::cerr << "Error: sweep run count must be positive\n";
+                return false;
+            }
+        }
+        else if (arg == "--sweep-cars" && i + 1 < argc) {
+            options.sweepCars = argv[++i];
+        }
+        else if (arg == "--sweep-capacity" && i + 1 < argc) {
+            options.sweepCapacity = argv[++i];
+        }
+        else if (arg == "--sweep-door" && i + 1 < argc) {
+            options.sweepDoor = argv[++i];
+        }
+        else if (arg == "--sweep-travel" && i + 1 < argc) {
+            options.sweepTravel = argv[++i];
+        }
+        else if (arg == "--sweep-modes" && i + 1 < argc) {
+            options.sweepModes = argv[++i];
+        }
+        else if (arg == "--sla" && i + 1 < argc) {
+            options.sweep.slaTicks = std::stoi(argv[++i]);
+            if (options.sweep.slaTicks < 1) {
+                std::cerr << "Error: SLA must be a positive number of ticks\n";
+                return false;
+            }
+        }
+        else if (arg == "--sla-percentile" && i + 1 < argc) {
+            options.sweep.slaPercentile = std::stod(argv[++i]);
+        }
+        else if (arg == "--min-cars") {
+            options.sweep.search = SweepSearch::MinCars;
+        }
+        else if (arg == "--campus" && i + 1 < argc) {
+            options.campusShards = std::stoi(argv[++i]);
+            if (options.campusShards < 1) {
+                std::cerr << "Error: campus shard count must be positive\n";
+                return false;
+            }
+        }
+        else if (arg == "--transfer" && i + 1 < argc) {
+            options.transferShare = std::stod(argv[++i]);
+            if (options.transferShare < 0.0 || options.transferShare > 1.0) {
+                std::cerr << "Error: transfer share must be 0-1\n";
+                return false;
+            }
+        }
+        else if (arg == "--seed" && i + 1 < argc) {
+            options.batch.seed = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+            options.generateTraffic = true;
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            options.batch.threads = std::stoi(argv[++i]);
+        }
+        else if ((arg == "-r" || arg == "--record") && i + 1 < argc) {
+            options.recordPath = argv[++i];
+        }
+        else if ((arg == "-s" || arg == "--script") && i + 1 < argc) {
+            options.scriptPath = argv[++i];
+        }
+        else if ((arg == "-p" || arg == "--replay") && i + 1 < argc) {
+            options.replayPath = argv[++i];
+            config.headless = true;
+        }
         else {
             std::cerr << "Unknown option: " << arg << "\n";
             printUsage(argv[0]);
@@ -71,12 +325,248 @@ bool parseArgs(int argc, char* argv[], Config& config) {
     return true;
 }
 
+void printEnergy(const CallMetrics& metrics) {
+    constexpr double kJoulesPerKwh = 3.6e6;
+    double net = metrics.energyDrawn - metrics.energyRegenerated;
+    std::cout << std::fixed << std::setprecision(3)
+              << "Energy: " << metrics.trips << " trips, "
+              << metrics.energyDrawn / kJoulesPerKwh << " kWh drawn, "
+              << metrics.energyRegenerated / kJoulesPerKwh << " kWh regenerated, "
+              << net / kJoulesPerKwh << " kWh net ("
+              << std::setprecision(1)
+              << (metrics.trips ? net / metrics.trips / 3600.0 : 0.0) << " Wh per trip)\n";
+    std::cout.unsetf(std::ios::fixed);
+}
+
+void printBatchResult(const BatchResult& result) {
+    const PassengerMetrics& p = result.passengers;
+    std::cout << std::left << std::setw(12)
+              << controllerToString(result.controller)
+              << std::right << std::fixed << std::setprecision(2)
+              << std::setw(11) << p.delivered.load()
+              << std::setw(9) << p.waitTicks.mean()
+              << std::setw(6) << p.waitTicks.percentile(0.5)
+              << std::setw(6) << p.waitTicks.percentile(0.95)
+              << std::setw(6) << p.waitTicks.percentile(0.99)
+              << std::setw(9) << p.journeyTicks.mean()
+              << std::setw(6) << p.journeyTicks.percentile(0.5)
+              << std::setw(6) << p.journeyTicks.percentile(0.95)
+              << std::setw(6) << p.journeyTicks.percentile(0.99)
+              << std::setw(12) << std::setprecision(1)
+              << (result.runs ? static_cast<double>(result.metrics.floorsTraveled) / result.runs : 0.0)
+              << std::setw(9) << result.runsPerSecond()
+              << "\n";
+    std::cout.unsetf(std::ios::fixed);
+}
+
+int runBatch(const Options& options) {
+    BatchConfig batch = options.batch;
+    batch.base = options.config;
+    batch.runs = options.batchRuns;
+    if (options.headlessTicks > 0) {
+        batch.ticksPerRun = options.headlessTicks;
+    }
+    
+    if (!options.loadStatePath.empty()) {
+        batch.warmStart = &options.warmStart;
+    }
+    
+    BatchRunner runner(batch);
+    std::cout << "Batch: " << batch.runs << " runs x " << batch.ticksPerRun
+              << " ticks, " << trafficProfileToString(batch.traffic) << " load "
+              << batch.callsPerTick << " calls/tick, seeds "
+              << batch.seed << ".." << batch.seed + batch.runs - 1 << ", "
+              << (batch.base.dispatchPolicy == DispatchPolicy::Collective
+                  ? "collective" : "nearest-first") << " dispatch, "
+              << (batch.base.costModel == CostModel::Eta ? "ETA" : "distance") << " cost, "
+              << runner.getThreadCount() << " threads\n\n"
+              << "                          ------- Wait -------  ------ Journey ------\n"
+              << "Controller   Delivered     mean   p50   p95   p99     mean   p50   p95   p99"
+              << "  floors/run   runs/s\n";
+    
+    if (batch.warmStart) {
+        // Scheduler tables in a snapshot belong to its own controller
+        printBatchResult(runner.run(batch.base.controllerType));
+    } else {
+        for (ControllerType type : {ControllerType::Master, ControllerType::Distributed,
+                                    ControllerType::Destination}) {
+            printBatchResult(runner.run(type));
+        }
+    }
+    std::cout << "(times in ticks)\n";
+    return 0;
+}
+
+int runSweep(const Options& options) {
+    SweepConfig sweep = options.sweep;
+    sweep.base = options.config;
+    sweep.runs = options.sweepRuns;
+    if (options.headlessTicks > 0) {
+        sweep.ticksPerRun = options.headlessTicks;
+    }
+    sweep.traffic.profile = options.batch.traffic;
+    sweep.traffic.callsPerTick = options.batch.callsPerTick;
+    sweep.traffic.seed = options.batch.seed;
+    sweep.threads = options.batch.threads;
+    if (!options.sweepCars.empty()) sweep.numElevators = parseIntList(options.sweepCars);
+    if (!options.sweepCapacity.empty()) sweep.carCapacity = parseIntList(options.sweepCapacity);
+    if (!options.sweepDoor.empty()) sweep.doorOpenTicks = parseIntList(options.sweepDoor);
+    if (!options.sweepTravel.empty()) sweep.floorTravelTicks = parseIntList(options.sweepTravel);
+    if (!options.sweepModes.empty()) sweep.controllers = parseControllerList(options.sweepModes);
+    
+    SweepRunner runner(sweep);
+    int pct = static_cast<int>(sweep.slaPercentile * 100.0 + 0.5);
+    std::cout << "Sweep: " << runner.getTaskCount()
+              << (sweep.search == SweepSearch::MinCars ? " fewest-cars searches" : " points")
+              << " x " << sweep.runs << " runs x " << sweep.ticksPerRun << " ticks, "
+              << sweep.base.numFloors << " floors, " << trafficProfileToString(sweep.traffic.profile)
+              << " load " << sweep.traffic.callsPerTick << " calls/tick, ";
+    if (sweep.slaTicks > 0) {
+        std::cout << "SLA p" << pct << " wait <= " << sweep.slaTicks << ", ";
+    }
+    std::cout << runner.getThreadCount() << " threads\n";
+    
+    SweepResult result = runner.run();
+    
+    auto waitCell = [](int wait) { return wait < 0 ? std::string("-") : std::to_string(wait); };
+    std::cout << "\nPareto front (fleet cost = cars x (1 + " << sweep.seatCost
+              << " x capacity); '-' = over a percentile's share never picked up):\n"
+              << "Cars  Cap  Door  Travel  Controller     Cost  Runs"
+              << "  wait p50   p" << pct << "   p99  journey  SLA\n";
+    for (const SweepPoint& point : result.points) {
+        if (!point.pareto) {
+            continue;
+        }
+        std::cout << std::setw(4) << point.numElevators << std::setw(5) << point.carCapacity
+                  << std::setw(6) << point.doorOpenTicks << std::setw(8) << point.floorTravelTicks
+                  << "  " << std::left << std::setw(12) << controllerToString(point.controller)
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(7) << point.cost << std::setw(6) << point.runs
+                  << std::setw(10) << waitCell(point.waitAt(0.5))
+                  << std::setw(6) << waitCell(point.waitAt(sweep.slaPercentile))
+                  << std::setw(6) << waitCell(point.waitAt(0.99))
+                  << std::setw(9) << point.passengers.journeyTicks.mean()
+                  << "  " << (sweep.slaTicks <= 0 ? "" : runner.meetsSla(point) ? "ok" : "miss")
+                  << "\n";
+        std::cout.unsetf(std::ios::fixed);
+    }
+    
+    std::cout << "\n" << result.points.size() << " points run, " << result.cutOff
+              << " cut off early; " << result.runs << " runs, " << result.ticks << " ticks in "
+              << std::fixed << std::setprecision(1) << result.elapsedSeconds << " s\n";
+    std::cout.unsetf(std::ios::fixed);
+    if (sweep.slaTicks > 0) {
+        const SweepPoint* best = result.cheapestMeetingSla(sweep);
+        if (best) {
+            std::cout << "Cheapest meeting the SLA: " << best->numElevators << " cars x "
+                      << best->carCapacity << " seats, door " << best->doorOpenTicks
+                      << ", travel " << best->floorTravelTicks << ", "
+                      << controllerToString(best->controller) << "\n";
+        } else {
+            std::cout << "No point meets the SLA\n";
+        }
+    }
+    std::cout << "(times in ticks)\n";
+    return 0;
+}
+
+int runCampus(const Options& options) {
+    CampusConfig campus;
+    campus.transferShare = options.transferShare;
+    campus.seed = options.batch.seed;
+    campus.threads = options.batch.threads;
+    for (int i = 0; i < options.campusShards; ++i) {
+        ShardConfig shard;
+        shard.name = "Tower " + std::to_string(i + 1);
+        shard.config = options.config;
+        shard.callsPerTick = options.batch.callsPerTick;
+        campus.shards.push_back(shard);
+    }
+    int ticks = options.headlessTicks > 0 ? options.headlessTicks : 2000;
+    
+    CampusSimulator simulator(campus);
+    std::cout << "Campus: " << campus.shards.size() << " shards x " << ticks
+              << " ticks, load " << options.batch.callsPerTick << " calls/tick each, "
+              << campus.transferShare * 100.0 << "% transfers, "
+              << simulator.getThreadCount() << " threads\n\n"
+              << "Shard       Delivered  wait p50   p95  Transfers out\n";
+    
+    CampusResult result = simulator.runTicks(ticks);
+    for (const ShardResult& shard : result.shards) {
+        const PassengerMetrics& p = shard.passengers;
+        std::cout << std::left << std::setw(12) << shard.name << std::right
+                  << std::setw(9) << p.delivered.load()
+                  << std::setw(10) << p.waitTicks.percentile(0.5)
+                  << std::setw(6) << p.waitTicks.percentile(0.95)
+                  << std::setw(15) << shard.transfersOut << "\n";
+    }
+    const LatencyHistogram& journeys = result.transferJourneyTicks;
+    std::cout << "\nTransfers: " << result.transfersCompleted << " of " << result.transfersSent
+              << " completed, journey p50 " << journeys.percentile(0.5)
+              << " p95 " << journeys.percentile(0.95) << " ticks\n"
+              << "Campus run: " << result.ticks << " ticks, " << result.eventsProcessed
+              << " events in " << result.elapsedSeconds << " s ("
+              << static_cast<long long>(result.ticksPerSecond()) << " ticks/s)\n";
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
-    Config config;
+    Options options;
     
-    if (!parseArgs(argc, argv, config)) {
+    if (!parseArgs(argc, argv, options)) {
         return 1;
     }
+    if (!options.loadStatePath.empty()) {
+        try {
+            options.warmStart = SimulationSnapshot::readFile(options.loadStatePath);
+            Config saved = options.warmStart.getConfig();
+            options.config.numFloors = saved.numFloors;
+            options.config.numElevators = saved.numElevators;
+            options.config.carCapacity = saved.carCapacity;
+            options.config.controllerType = saved.controllerType;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+    }
+    const Config& config = options.config;
+    
+    if (!options.decodePath.empty()) {
+        try {
+            AsyncLogSink::decode(options.decodePath, std::cout);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+    
+    if (options.campusShards > 0) {
+        try {
+            return runCampus(options);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+    }
+    
+    if (options.sweepRuns > 0) {
+        try {
+            return runSweep(options);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+    }
+    
+    if (options.batchRuns > 0) {
+        try {
+            return runBatch(options);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+    }
     
     std::cout << "========================================\n"
               << "       Elevator Simulation System       \n"
@@ -85,18 +575,109 @@ int main(int argc, char* argv[]) {
               << "  Floors:     " << config.numFloors << "\n"
               << "  Elevators:  " << config.numElevators << "\n"
               << "  Capacity:   " << config.carCapacity << "\n"
-              << "  Controller: " << (config.controllerType == ControllerType::Master 
-                                      ? "Master" : "Distributed") << "\n"
-              << "  Tick:       " << config.tickDurationMs << " ms\n"
-              << "========================================\n";
+              << "  Controller: " << controllerToString(config.controllerType) << "\n"
+              << "  Dispatch:   " << (config.dispatchPolicy == DispatchPolicy::Collective
+                                      ? "Collective" : "Nearest-first") << "\n"
+              << "  Cost:       " << (config.costModel == CostModel::Eta ? "ETA" : "Distance") << "\n"
+              << "  Motion:     " << (config.motionModel == MotionModel::Kinematic
+                                      ? "Kinematic" : "Fixed") << "\n"
+              << "  Tick:       " << (config.headless ? std::string("virtual")
+                                      : std::to_string(config.tickDurationMs) + " ms") << "\n";
+    if (!config.sharedStateName.empty()) {
+        std::cout << "  Export:     shared memory " << config.sharedStateName << "\n";
+    }
+    std::cout << "========================================\n";
     
     try {
-        SimulationEngine engine(config);
-        CLI cli(engine);
+        std::unique_ptr<SimulationEngine> owned =
+            options.loadStatePath.empty()
+                ? std::make_unique<SimulationEngine>(config)
+                : std::make_unique<SimulationEngine>(options.warmStart, config);
+        SimulationEngine& engine = *owned;
+        if (!options.loadStatePath.empty()) {
+            std::cout << "Starting from " << options.loadStatePath << " at tick "
+                      << engine.getCurrentTick() << "\n";
+        }
         
-        engine.start();
-        cli.run();
-        engine.stop();
+        std::unique_ptr<TraceWriter> recorder;
+        if (!options.recordPath.empty()) {
+            recorder = std::make_unique<TraceWriter>(options.recordPath, config);
+            engine.setTraceRecorder(recorder.get());
+        }
+        
+        if (config.headless) {
+            RunStats stats;
+            if (!options.replayPath.empty()) {
+                TraceReader trace(options.replayPath);
+                std::cout << "Replaying " << trace.size() << " records from "
+                          << options.replayPath << "\n";
+                stats = engine.replay(trace, options.headlessTicks);
+            } else {
+                if (!options.scriptPath.empty()) {
+                    CLI cli(engine);
+                    size_t lines = cli.runScript(options.scriptPath);
+                    std::cout << "Read " << lines << " script lines from "
+                              << options.scriptPath << "\n";
+                }
+                if (options.generateTraffic) {
+                    TrafficConfig traffic;
+                    traffic.profile = options.batch.traffic;
+                    traffic.callsPerTick = options.batch.callsPerTick;
+                    traffic.seed = options.batch.seed;
+                    TrafficGenerator generator(traffic, config.numFloors);
+                    stats = generator.drive(engine, options.headlessTicks);
+                    std::cout << "Generated " << generator.getGeneratedCount() << " "
+                              << trafficProfileToString(traffic.profile) << " passengers\n";
+                } else {
+                    stats = engine.runTicks(options.headlessTicks);
+                }
+            }
+            engine.flushLog();
+            engine.printStatus();
+            if (config.profiling) {
+                engine.printStats();
+            }
+            std::cout << "Headless run: " << stats.ticks << " ticks, "
+                      << stats.eventsProcessed << " events in "
+                      << stats.elapsedSeconds << " s ("
+                      << static_cast<long long>(stats.ticksPerSecond())
+                      << " ticks/s)\n";
+            if (config.motionModel == MotionModel::Kinematic) {
+                printEnergy(engine.getBuilding().getMetrics());
+            }
+        } else {
+            CLI cli(engine);
+            
+            engine.start();
+            if (!options.scriptPath.empty()) {
+                cli.runScript(options.scriptPath);
+            } else {
+                cli.run();
+            }
+            engine.stop();
+        }
+        
+        if (!options.metricsPath.empty()) {
+            std::ofstream metrics(options.metricsPath);
+            if (!metrics) {
+                throw std::runtime_error("Cannot write metrics file: " + options.metricsPath);
+            }
+            engine.writeMetrics(metrics);
+            std::cout << "Wrote metrics to " << options.metricsPath << "\n";
+        }
+        
+        if (!options.saveStatePath.empty()) {
+            engine.saveSnapshot().writeFile(options.saveStatePath);
+            std::cout << "Saved snapshot at tick " << engine.getCurrentTick() << " to "
+                      << options.saveStatePath << "\n";
+        }
+        
+        if (recorder) {
+            engine.setTraceRecorder(nullptr);
+            std::cout << "Recorded " << recorder->getRecordCount() << " calls to "
+                      << options.recordPath << "\n";
+            recorder->close();
+        }
         
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << "\n";
@@ -1,9 +1,17 @@
 #include <gtest/gtest.h>
 #include "Simulation.hpp"
+#include "LockFreeQueue.hpp"
+#include "BatchRunner.hpp"
+#include "Campus.hpp"
+#include "SharedState.hpp"
 #include <thread>
 #include <random>
 #include <vector>
+#include <algorithm>
 #include <atomic>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
 
 // ============== High Traffic Test ==============
 
@@ -195,6 +203,173 @@ TEST(StressTest, EventQueueConcurrency) {
     EXPECT_EQ(consumed.load(), numProducers * itemsPerProducer);
 }
 
+TEST(StressTest, LockFreeQueueMultiProducer) {
+    // Small ring so producers regularly hit the full path
+    LockFreeEventQueue<int, 64> queue;
+    
+    const int numProducers = 4;
+    const int itemsPerProducer = 50000;
+    
+    std::vector<std::thread> producers;
+    for (int p = 0; p < numProducers; ++p) {
+        producers.emplace_back([&queue, p, itemsPerProducer]() {
+            for (int i = 0; i < itemsPerProducer; ++i) {
+                queue.push(p * itemsPerProducer + i);
+            }
+        });
+    }
+    
+    // Single consumer: per-producer order must be preserved
+    std::vector<int> lastSeen(numProducers, -1);
+    std::vector<int> batch;
+    int consumed = 0;
+    bool ordered = true;
+    
+    while (consumed < numProducers * itemsPerProducer) {
+        batch.clear();
+        if (queue.drain(batch) == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (int item : batch) {
+            int producer = item / itemsPerProducer;
+            int seq = item % itemsPerProducer;
+            if (seq <= lastSeen[producer]) ordered = false;
+            lastSeen[producer] = seq;
+        }
+        consumed += static_cast<int>(batch.size());
+    }
+    
+    for (auto& t : producers) {
+        t.join();
+    }
+    
+    EXPECT_EQ(consumed, numProducers * itemsPerProducer);
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(StressTest, LockFreeQueueBatchProducers) {
+    // Batches close to the ring size, mixed with single pushes
+    LockFreeEventQueue<int, 64> queue;
+    
+    const int numProducers = 4;
+    const int itemsPerProducer = 40000;
+    
+    std::vector<std::thread> producers;
+    for (int p = 0; p < numProducers; ++p) {
+        producers.emplace_back([&queue, p, itemsPerProducer]() {
+            std::vector<int> batch;
+            int next = 0;
+            while (next < itemsPerProducer) {
+                int size = std::min(1 + (next * 7 + p) % 50, itemsPerProducer - next);
+                batch.clear();
+                for (int i = 0; i < size; ++i) {
+                    batch.push_back(p * itemsPerProducer + next + i);
+                }
+                if (size == 1) {
+                    queue.push(batch.front());
+                } else {
+                    queue.pushBatch(batch.begin(), batch.end());
+                }
+                next += size;
+            }
+        });
+    }
+    
+    std::vector<int> lastSeen(numProducers, -1);
+    std::vector<int> batch;
+    int consumed = 0;
+    bool ordered = true;
+    
+    while (consumed < numProducers * itemsPerProducer) {
+        batch.clear();
+        if (queue.drain(batch) == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (int item : batch) {
+            int producer = item / itemsPerProducer;
+            int seq = item % itemsPerProducer;
+            if (seq != lastSeen[producer] + 1) ordered = false;
+            lastSeen[producer] = seq;
+        }
+        consumed += static_cast<int>(batch.size());
+    }
+    
+    for (auto& t : producers) {
+        t.join();
+    }
+    
+    EXPECT_EQ(consumed, numProducers * itemsPerProducer);
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(StressTest, ClaimBoardConcurrentCars) {
+    Config config;
+    config.numFloors = 40;
+    config.numElevators = 4;
+    
+    Building building(config);
+    EventQueue<Event> queue;
+    DistributedController controller(building, queue);
+    for (int i = 0; i < config.numElevators; ++i) {
+        building.getElevator(i).arriveAtFloor(1 + i * 10);
+        building.getElevator(i).setIdle();
+    }
+    
+    // Every car posts, claims and serves calls on its own thread. Each
+    // posted call must be served exactly once: a lost open bit or a call
+    // claimed by two cars breaks the count.
+    std::atomic<long> posted{0};
+    std::atomic<long> served{0};
+    auto serveClaims = [&](int car) {
+        for (int floor : controller.getClaimedFloors(car)) {
+            for (Direction dir : {Direction::Up, Direction::Down}) {
+                if (controller.hasClaim(car, floor, dir)) {
+                    controller.releaseClaim(floor, dir);
+                    ++served;
+                }
+            }
+        }
+    };
+    
+    std::vector<std::thread> cars;
+    for (int car = 0; car < config.numElevators; ++car) {
+        cars.emplace_back([&, car]() {
+            std::mt19937 gen(car + 1);
+            std::uniform_int_distribution<> floorDist(2, config.numFloors - 1);
+            for (int i = 0; i < 20000; ++i) {
+                int floor = floorDist(gen);
+                if (controller.postCall(floor, (floor & 1) ? Direction::Up : Direction::Down)) {
+                    ++posted;
+                }
+                controller.tryClaimCalls(car);
+                if (i % 4 == 0) {
+                    serveClaims(car);   // Hold claims for a while to vary contention
+                }
+            }
+        });
+    }
+    for (auto& t : cars) {
+        t.join();
+    }
+    
+    // Drain whatever is left, claimed or still open
+    for (int car = 0; car < config.numElevators; ++car) {
+        serveClaims(car);
+    }
+    for (;;) {
+        controller.tryClaimCalls(0);
+        if (controller.getClaimedFloors(0).empty()) break;
+        serveClaims(0);
+    }
+    
+    EXPECT_GT(posted.load(), 0);
+    EXPECT_EQ(served.load(), posted.load());
+}
+
 // ============== Long Running Test ==============
 
 TEST(StressTest, Endurance) {
@@ -236,6 +411,326 @@ TEST(StressTest, Endurance) {
     SUCCEED();
 }
 
+// ============== Headless (Virtual Time) ==============
+
+static void runHeadlessTraffic(ControllerType type) {
+    Config config;
+    config.numFloors = 12;
+    config.numElevators = 3;
+    config.controllerType = type;
+    config.headless = true;
+    config.loggingEnabled = false;
+    
+    SimulationEngine engine(config);
+    
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> floorDist(1, 12);
+    std::uniform_int_distribution<> dirDist(0, 1);
+    
+    // 20k ticks would take ~3 hours at the default 500 ms tick
+    const int trafficTicks = 20000;
+    for (int t = 0; t < trafficTicks; ++t) {
+        if (t % 5 == 0) {
+            int floor = floorDist(gen);
+            Direction dir = (dirDist(gen) == 0) ? Direction::Up : Direction::Down;
+            if (floor == 1) dir = Direction::Up;
+            if (floor == 12) dir = Direction::Down;
+            engine.requestHallCall(floor, dir);
+        }
+        engine.runTicks(1);
+    }
+    
+    // Drain: every hall call must eventually be served
+    engine.runTicks(2000);
+    
+    EXPECT_EQ(engine.getCurrentTick(), trafficTicks + 2000);
+    EXPECT_TRUE(engine.getBuilding().getAllHallCalls().empty());
+}
+
+TEST(StressTest, HeadlessEnduranceMaster) {
+    runHeadlessTraffic(ControllerType::Master);
+}
+
+TEST(StressTest, HeadlessEnduranceDistributed) {
+    runHeadlessTraffic(ControllerType::Distributed);
+}
+
+static void runPassengerRush(ControllerType type, int reassignPeriod = 0, int carWorkers = 0) {
+    Config config;
+    config.numFloors = 20;
+    config.numElevators = 4;
+    config.carCapacity = 4;
+    config.controllerType = type;
+    config.reassignPeriod = reassignPeriod;
+    config.carWorkers = carWorkers;
+    config.headless = true;
+    config.loggingEnabled = false;
+    
+    SimulationEngine engine(config);
+    
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<> floorDist(1, 20);
+    
+    // Heavy load with small cars: capacity turns people away constantly
+    long long requested = 0;
+    for (int t = 0; t < 10000; ++t) {
+        for (int n = 0; n < 2 && t % 3 == 0; ++n) {
+            int origin = floorDist(gen);
+            int dest = floorDist(gen);
+            if (origin == dest) continue;
+            engine.requestPassenger(origin, dest);
+            ++requested;
+        }
+        engine.runTicks(1);
+        for (int load : engine.getBuilding().getFleet().passengers) {
+            ASSERT_LE(load, config.carCapacity);
+        }
+    }
+    
+    // Drain: nobody is stranded at a floor or in a car
+    engine.runTicks(20000);
+    
+    const PassengerMetrics& metrics = engine.getPassengerMetrics();
+    EXPECT_EQ(metrics.spawned.load(), requested);
+    EXPECT_EQ(metrics.delivered.load(), requested);
+    EXPECT_EQ(metrics.waiting.load(), 0);
+    EXPECT_EQ(metrics.riding.load(), 0);
+    EXPECT_EQ(metrics.journeyTicks.count(), static_cast<std::uint64_t>(requested));
+}
+
+TEST(StressTest, PassengerRushMaster) {
+    runPassengerRush(ControllerType::Master);
+}
+
+TEST(StressTest, PassengerRushMasterReassigning) {
+    runPassengerRush(ControllerType::Master, 5);  // Calls keep moving between cars
+}
+
+TEST(StressTest, PassengerRushDistributed) {
+    runPassengerRush(ControllerType::Distributed);
+}
+
+TEST(StressTest, PassengerRushDestination) {
+    runPassengerRush(ControllerType::Destination);
+}
+
+TEST(StressTest, PassengerRushDistributedCarWorkers) {
+    runPassengerRush(ControllerType::Distributed, 0, 4);
+}
+
+TEST(StressTest, CarWorkersDeterministic) {
+    // Same seeded load: the per-car worker count must not change anything
+    const std::pair<DispatchPolicy, CostModel> variants[] = {
+        {DispatchPolicy::NearestFirst, CostModel::Distance},
+        {DispatchPolicy::Collective, CostModel::Distance},
+        {DispatchPolicy::Collective, CostModel::Eta},
+    };
+    std::vector<long long> floorsByVariant;
+    for (const auto& [policy, cost] : variants) {
+        Config config;
+        config.numFloors = 30;
+        config.numElevators = 8;
+        config.controllerType = ControllerType::Distributed;
+        config.dispatchPolicy = policy;
+        config.costModel = cost;
+        config.headless = true;
+        config.loggingEnabled = false;
+        
+        std::vector<BatchResult> results(3);
+        std::vector<RunStats> stats(3);
+        int workers[] = {1, 4, 8};
+        for (int i = 0; i < 3; ++i) {
+            config.carWorkers = workers[i];
+            stats[i] = BatchRunner::runOne(config, 3000, 0.4, 11, results[i]);
+        }
+        
+        EXPECT_GT(results[0].passengers.delivered.load(), 0);
+        for (int i = 1; i < 3; ++i) {
+            EXPECT_EQ(stats[i].eventsProcessed, stats[0].eventsProcessed);
+            EXPECT_EQ(results[i].metrics.floorsTraveled, results[0].metrics.floorsTraveled);
+            EXPECT_TRUE(results[i].metrics.waitTicks == results[0].metrics.waitTicks);
+            EXPECT_TRUE(results[i].passengers.journeyTicks == results[0].passengers.journeyTicks);
+            EXPECT_EQ(results[i].passengers.delivered.load(), results[0].passengers.delivered.load());
+        }
+        floorsByVariant.push_back(results[0].metrics.floorsTraveled);
+    }
+    // The ETA bids are not the distance bids under another name
+    EXPECT_NE(floorsByVariant[2], floorsByVariant[1]);
+}
+
+TEST(StressTest, CampusShardsInLockstep) {
+    // Eight busy towers on four threads, most trips changing tower
+    CampusConfig campus;
+    for (int i = 0; i < 8; ++i) {
+        ShardConfig shard;
+        shard.config.numFloors = 40;
+        shard.config.numElevators = 6;
+        shard.config.controllerType = static_cast<ControllerType>(i % 3);
+        shard.transferFloor = 1 + (i % 2) * 20;
+        shard.callsPerTick = 0.5;
+        campus.shards.push_back(shard);
+    }
+    campus.transferShare = 0.6;
+    campus.threads = 4;
+    CampusSimulator simulator(campus);
+    
+    CampusResult result = simulator.runTicks(2500);
+    for (int i = 0; i < simulator.getShardCount(); ++i) {
+        EXPECT_EQ(simulator.getShard(i).getCurrentTick(), 2500);
+        EXPECT_GT(result.shards[i].passengers.delivered.load(), 0);
+    }
+    EXPECT_GT(result.transfersCompleted, 0);
+    EXPECT_LE(result.transfersCompleted, result.transfersSent);
+}
+
+TEST(StressTest, StatusReadersDuringHeadlessRun) {
+    Config config;
+    config.numFloors = 12;
+    config.numElevators = 3;
+    config.headless = true;
+    config.loggingEnabled = false;
+    
+    SimulationEngine engine(config);
+    engine.start();
+    
+    // Monitoring threads only ever see published snapshots
+    std::atomic<bool> done{false};
+    std::atomic<int> reads{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; ++r) {
+        readers.emplace_back([&engine, &done, &reads]() {
+            while (!done.load()) {
+                FleetSnapshot snap = engine.getBuilding().getSnapshot();
+                if (snap.fleet.size() == 3) reads++;
+            }
+        });
+    }
+    
+    for (int i = 0; i < 200; ++i) {
+        engine.requestHallCall(1 + i % 11, Direction::Up);
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    
+    done.store(true);
+    for (auto& t : readers) {
+        t.join();
+    }
+    engine.stop();
+    
+    EXPECT_GT(reads.load(), 0);
+}
+
+TEST(StressTest, SnapshotReadsNeverTear) {
+    // Every field of publish k is derived from k, so a torn read - words
+    // from two different publishes - shows up as a mismatch
+    const int numCars = 8;
+    FleetSnapshotBuffer buffer(numCars);
+    FleetState fleet(numCars, 10, 1);
+    FloorMask none;
+    auto publish = [&](int k) {
+        FloorMask up;
+        up.set(k % 200 + 1);
+        for (int car = 0; car < numCars; ++car) {
+            fleet.floor[car] = (k + car) % 200 + 1;
+            fleet.ticksRemaining[car] = k;
+            fleet.passengers[car] = k % 11;
+            fleet.carCalls[car].clear();
+            fleet.carCalls[car].set(fleet.floor[car]);
+        }
+        buffer.publish(k, fleet, up, none);
+    };
+    publish(0);
+    
+    std::atomic<bool> done{false};
+    std::atomic<int> reads{0};
+    std::atomic<int> torn{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            FleetSnapshot snap;
+            while (!done.load()) {
+                buffer.read(snap);
+                int k = snap.tick;
+                bool ok = snap.upCalls.test(k % 200 + 1);
+                for (int car = 0; car < numCars; ++car) {
+                    ok = ok && snap.fleet.floor[car] == (k + car) % 200 + 1 &&
+                         snap.fleet.ticksRemaining[car] == k &&
+                         snap.fleet.passengers[car] == k % 11 &&
+                         snap.fleet.carCalls[car].test((k + car) % 200 + 1) &&
+                         snap.fleet.carCalls[car].size() == 1;
+                }
+                if (!ok) torn++;
+                reads++;
+            }
+        });
+    }
+    
+    for (int k = 1; k <= 200000; ++k) {
+        publish(k);
+    }
+    done.store(true);
+    for (auto& t : readers) {
+        t.join();
+    }
+    
+    EXPECT_GT(reads.load(), 0);
+    EXPECT_EQ(torn.load(), 0);
+}
+
+TEST(StressTest, SharedStateReadsNeverTearAcrossProcesses) {
+    // As SnapshotReadsNeverTear, with the reader in a forked process on its
+    // own read-only mapping; it exits non-zero on any torn copy
+    const int numCars = 8;
+    const int publishes = 200000;
+    std::string name = "/elevator_stress_" + std::to_string(getpid());
+    SharedStateWriter writer(name, 200, numCars);
+    FleetState fleet(numCars, 10, 1);
+    FloorMask none;
+    auto publish = [&](int k) {
+        FloorMask up;
+        up.set(k % 200 + 1);
+        for (int car = 0; car < numCars; ++car) {
+            fleet.floor[car] = (k + car) % 200 + 1;
+            fleet.ticksRemaining[car] = k;
+            fleet.passengers[car] = k % 11;
+            fleet.carCalls[car].clear();
+            fleet.carCalls[car].set(fleet.floor[car]);
+        }
+        writer.publish(k, fleet, up, none);
+    };
+    publish(0);
+    
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        int torn = 0;
+        SharedStateReader reader(name);
+        FleetSnapshot snap;
+        do {
+            reader.read(snap);
+            int k = snap.tick;
+            bool ok = snap.upCalls.test(k % 200 + 1);
+            for (int car = 0; car < numCars; ++car) {
+                ok = ok && snap.fleet.floor[car] == (k + car) % 200 + 1 &&
+                     snap.fleet.ticksRemaining[car] == k &&
+                     snap.fleet.passengers[car] == k % 11 &&
+                     snap.fleet.carCalls[car].test((k + car) % 200 + 1) &&
+                     snap.fleet.carCalls[car].size() == 1;
+            }
+            if (!ok) torn++;
+        } while (snap.tick != publishes);
+        _exit(torn == 0 ? 0 : 1);
+    }
+    
+    for (int k = 1; k <= publishes; ++k) {
+        publish(k);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
 // ============== Rapid Start/Stop ==============
 
 TEST(StressTest, RapidStartStop) {